@@ -34,6 +34,10 @@ static gboolean pama_create(PanelApplet *applet, const gchar *iid, gpointer data
 	// One-time applet configuration
 	if (NULL == api)
 	{
+		// Icons are decoded in a worker thread
+		if (!g_thread_supported())
+			g_thread_init(NULL);
+
 		g_set_application_name(_("PulseAudio Mixer Applet"));
 		gtk_window_set_default_icon_name("multimedia-volume-control");
 
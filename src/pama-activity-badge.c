@@ -0,0 +1,78 @@
+/*
+ * pama-activity-badge.c: Marks device icons whose device is in use
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+
+#include "pama-activity-badge.h"
+
+/* A dot in the corner of a device's icon while the server reports the device
+ * as running, that is while some stream plays to or records from it. The
+ * state comes with every device update, so unlike a meter this needs no
+ * stream and no work beyond a repaint when it changes. The dot is drawn over
+ * the image after it has painted itself, so it works with any icon. */
+
+static gboolean pama_activity_badge_expose(GtkWidget *image, GdkEventExpose *event, gpointer data);
+
+static gboolean pama_activity_badge_expose(GtkWidget *image, GdkEventExpose *event, gpointer data)
+{
+	cairo_t *cr;
+	gdouble  radius, x, y;
+
+	if (!g_object_get_data(G_OBJECT(image), "pama-activity-badge"))
+		return FALSE;
+
+	/* The bottom right corner of the icon, which is centred in the allocation */
+	radius = MAX(image->requisition.height / 6.0, 2.0);
+	x = image->allocation.x + (image->allocation.width  + image->requisition.width)  / 2.0 - radius - 1.0;
+	y = image->allocation.y + (image->allocation.height + image->requisition.height) / 2.0 - radius - 1.0;
+
+	cr = gdk_cairo_create(event->window);
+	gdk_cairo_region(cr, event->region);
+	cairo_clip(cr);
+
+	cairo_arc(cr, x, y, radius, 0, 2 * G_PI);
+	gdk_cairo_set_source_color(cr, &image->style->bg[GTK_STATE_SELECTED]);
+	cairo_fill_preserve(cr);
+	gdk_cairo_set_source_color(cr, &image->style->base[GTK_STATE_NORMAL]);
+	cairo_set_line_width(cr, 1.0);
+	cairo_stroke(cr);
+
+	cairo_destroy(cr);
+	return FALSE;
+}
+
+
+// Lets image show a badge. It starts out without one.
+void pama_activity_badge_attach(GtkWidget *image)
+{
+	g_signal_connect_after(image, "expose-event", G_CALLBACK(pama_activity_badge_expose), NULL);
+}
+
+void pama_activity_badge_set(GtkWidget *image, gboolean active)
+{
+	if (active == GPOINTER_TO_INT(g_object_get_data(G_OBJECT(image), "pama-activity-badge")))
+		return;
+
+	g_object_set_data(G_OBJECT(image), "pama-activity-badge", GINT_TO_POINTER(active));
+	gtk_widget_queue_draw(image);
+}
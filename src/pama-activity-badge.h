@@ -0,0 +1,34 @@
+/*
+ * pama-activity-badge.h: Marks device icons whose device is in use
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_ACTIVITY_BADGE_H
+#define PAMA_ACTIVITY_BADGE_H
+
+#include <glib.h>
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+void pama_activity_badge_attach(GtkWidget *image);
+void pama_activity_badge_set   (GtkWidget *image, gboolean active);
+
+G_END_DECLS
+
+#endif /* PAMA_ACTIVITY_BADGE_H */
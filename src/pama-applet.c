@@ -24,7 +24,14 @@
 #include <glib/gi18n.h>
  
 #include <string.h>
+#include <panel-applet-gconf.h>
+#include "pama-activity-badge.h"
 #include "pama-applet.h"
+#include "pama-clip-history.h"
+#include "pama-feedback-sound.h"
+#include "pama-latency-poll.h"
+#include "pama-pulse-meter.h"
+#include "pama-volume-map.h"
 #include "widget-settings.h"
 
 /* 5% / 5dB volume steps */
@@ -42,6 +49,13 @@ static void     pama_applet_io_devs_changed           (gpointer, guint, gpointer
 static void     pama_applet_io_devs_notify            (gpointer, GParamSpec *, gpointer data);
 static gboolean pama_applet_create_context            (gpointer data);
 static void     pama_applet_update_icons              (PamaApplet *applet);
+static gboolean pama_applet_update_icons_idle         (gpointer data);
+static void     pama_applet_set_icon                  (GtkWidget *image, const gchar **current, const gchar *icon_name);
+static void     pama_applet_set_menu_prop             (PamaApplet *applet, const gchar *path, const gchar *name, gint *current, gboolean value);
+static gchar   *pama_applet_build_tooltip             (GObject *device);
+
+static gboolean pama_applet_icon_query_tooltip(GtkWidget *event_box, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data);
+static gboolean pama_applet_icon_crossing     (GtkWidget *event_box, GdkEventCrossing *event, gpointer data);
 
 static gboolean pama_applet_icon_scroll  (GtkWidget *event_box, GdkEventScroll *event, gpointer data);
 static gboolean pama_applet_icon_click   (GtkWidget *event_box, GdkEventButton *event, gpointer data);
@@ -51,6 +65,8 @@ static void pama_applet_show_about_dialog (BonoboUIComponent *uic, gpointer data
 static void pama_applet_launch_pavucontrol(BonoboUIComponent *uic, gpointer data, const char *cname);
 static void pama_applet_toggle_sink_mute  (BonoboUIComponent *uic, const char *path, Bonobo_UIComponent_EventType type, const char *state, gpointer data);
 static void pama_applet_toggle_source_mute(BonoboUIComponent *uic, const char *path, Bonobo_UIComponent_EventType type, const char *state, gpointer data);
+static void pama_applet_toggle_group_streams(BonoboUIComponent *uic, const char *path, Bonobo_UIComponent_EventType type, const char *state, gpointer data);
+static void pama_applet_toggle_active_only(BonoboUIComponent *uic, const char *path, Bonobo_UIComponent_EventType type, const char *state, gpointer data);
 
 struct _PamaAppletPrivate
 {
@@ -68,7 +84,21 @@ struct _PamaAppletPrivate
 	GtkWidget *sink_event_box, *source_event_box;
 	GtkWidget *sink_icon,      *source_icon;
 
+	/* last state pushed to the icons and the panel's menu, -1 if unknown */
+	const gchar *sink_icon_name, *source_icon_name;
+	gint sink_sensitive,   sink_mute;
+	gint source_sensitive, source_mute;
+	guint update_idle;
+
 	gboolean updating;
+	gboolean connected, informed;
+	gboolean hovered;
+
+	/* preferences */
+	gboolean group_streams;
+	gboolean active_only;
+	guint    new_stream_delay;
+	gchar  **hidden_roles;
 
 	/* popups */
 	PamaSinkPopup   *sink_popup;
@@ -111,8 +141,8 @@ static void pama_applet_init(PamaApplet *applet)
 	priv->source_event_box = gtk_event_box_new();
 	gtk_event_box_set_visible_window(GTK_EVENT_BOX(priv->sink_event_box),   FALSE);
 	gtk_event_box_set_visible_window(GTK_EVENT_BOX(priv->source_event_box), FALSE);
-	gtk_widget_set_tooltip_text(GTK_WIDGET(priv->sink_event_box),   _("Not connected to PulseAudio server"));
-	gtk_widget_set_tooltip_text(GTK_WIDGET(priv->source_event_box), _("Not connected to PulseAudio server"));
+	gtk_widget_set_has_tooltip(GTK_WIDGET(priv->sink_event_box),   TRUE);
+	gtk_widget_set_has_tooltip(GTK_WIDGET(priv->source_event_box), TRUE);
 	gtk_widget_set_sensitive(GTK_WIDGET(priv->sink_event_box),   FALSE);
 	gtk_widget_set_sensitive(GTK_WIDGET(priv->source_event_box), FALSE);
 	gtk_box_pack_start(priv->box, priv->sink_event_box,   FALSE, TRUE, 0);
@@ -120,6 +150,12 @@ static void pama_applet_init(PamaApplet *applet)
 
 	priv->sink_icon   = gtk_image_new_from_icon_name("audio-volume-muted",           GTK_ICON_SIZE_MENU);
 	priv->source_icon = gtk_image_new_from_icon_name("audio-input-microphone-muted", GTK_ICON_SIZE_MENU);
+	priv->sink_icon_name   = "audio-volume-muted";
+	priv->source_icon_name = "audio-input-microphone-muted";
+	priv->sink_sensitive   = priv->sink_mute   = -1;
+	priv->source_sensitive = priv->source_mute = -1;
+	pama_activity_badge_attach(priv->sink_icon);
+	pama_activity_badge_attach(priv->source_icon);
 	gtk_container_add(GTK_CONTAINER(priv->sink_event_box),   priv->sink_icon);
 	gtk_container_add(GTK_CONTAINER(priv->source_event_box), priv->source_icon);
 
@@ -127,10 +163,16 @@ static void pama_applet_init(PamaApplet *applet)
 	g_object_connect(priv->sink_event_box,
 	                 "signal::scroll-event",       pama_applet_icon_scroll,    applet,
 	                 "signal::button-press-event", pama_applet_icon_click,     applet,
+	                 "signal::query-tooltip",      pama_applet_icon_query_tooltip, applet,
+	                 "signal::enter-notify-event", pama_applet_icon_crossing,  applet,
+	                 "signal::leave-notify-event", pama_applet_icon_crossing,  applet,
 	                 NULL);
 	g_object_connect(priv->source_event_box,
 	                 "signal::scroll-event",       pama_applet_icon_scroll,    applet,
 	                 "signal::button-press-event", pama_applet_icon_click,     applet,
+	                 "signal::query-tooltip",      pama_applet_icon_query_tooltip, applet,
+	                 "signal::enter-notify-event", pama_applet_icon_crossing,  applet,
+	                 "signal::leave-notify-event", pama_applet_icon_crossing,  applet,
 	                 NULL);
 
 	panel_applet_set_flags(PANEL_APPLET(applet), PANEL_APPLET_EXPAND_MINOR);
@@ -141,7 +183,9 @@ static void pama_applet_init(PamaApplet *applet)
 static gboolean pama_applet_delayed_init(gpointer data)
 {
 	PanelApplet *applet = PANEL_APPLET(data);
+	PamaAppletPrivate *priv = PAMA_APPLET_GET_PRIVATE(applet);
 	BonoboUIComponent *popup;
+	GConfValue *value;
 
 	panel_applet_setup_menu_from_file(applet,
 	                                  DATADIR,
@@ -151,11 +195,55 @@ static gboolean pama_applet_delayed_init(gpointer data)
 	                                  data);
 
 	popup = panel_applet_get_popup_component(applet);
-	bonobo_ui_component_set_prop(popup, "/commands/MuteSink",   "sensitive", "0", NULL);
-	bonobo_ui_component_set_prop(popup, "/commands/MuteSource", "sensitive", "0", NULL);
+	pama_applet_set_menu_prop(PAMA_APPLET(applet), "/commands/MuteSink",   "sensitive", &priv->sink_sensitive,   FALSE);
+	pama_applet_set_menu_prop(PAMA_APPLET(applet), "/commands/MuteSource", "sensitive", &priv->source_sensitive, FALSE);
 	bonobo_ui_component_add_listener(popup, "MuteSink",   (BonoboUIListenerFn) pama_applet_toggle_sink_mute,   data);
 	bonobo_ui_component_add_listener(popup, "MuteSource", (BonoboUIListenerFn) pama_applet_toggle_source_mute, data);
 
+	priv->group_streams = panel_applet_gconf_get_bool(applet, "group_streams", NULL);
+	bonobo_ui_component_set_prop(popup, "/commands/GroupStreams", "state", priv->group_streams ? "1" : "0", NULL);
+	bonobo_ui_component_add_listener(popup, "GroupStreams", (BonoboUIListenerFn) pama_applet_toggle_group_streams, data);
+
+	priv->active_only = panel_applet_gconf_get_bool(applet, "active_only", NULL);
+	bonobo_ui_component_set_prop(popup, "/commands/ActiveOnly", "state", priv->active_only ? "1" : "0", NULL);
+	bonobo_ui_component_add_listener(popup, "ActiveOnly", (BonoboUIListenerFn) pama_applet_toggle_active_only, data);
+
+	/* None of these has a menu item; they are only set through gconf */
+	value = panel_applet_gconf_get_value(applet, "new_stream_delay", NULL);
+	if (value && GCONF_VALUE_INT == value->type)
+		priv->new_stream_delay = MAX(0, gconf_value_get_int(value));
+	else
+		priv->new_stream_delay = WIDGET_NEW_STREAM_DELAY;
+	if (value)
+		gconf_value_free(value);
+
+	value = panel_applet_gconf_get_value(applet, "hidden_roles", NULL);
+	if (value && GCONF_VALUE_STRING == value->type)
+		priv->hidden_roles = g_strsplit(gconf_value_get_string(value), ",", -1);
+	else
+		priv->hidden_roles = g_strsplit(WIDGET_HIDDEN_ROLES, ",", -1);
+	if (value)
+		gconf_value_free(value);
+
+	/* "cubic" gives sliders that move evenly in volume, as pavucontrol's do, rather than in decibels */
+	value = panel_applet_gconf_get_value(applet, "volume_curve", NULL);
+	if (value && GCONF_VALUE_STRING == value->type && 0 == strcmp(gconf_value_get_string(value), "cubic"))
+		pama_volume_map_set_curve(PAMA_VOLUME_CURVE_CUBIC);
+	else
+		pama_volume_map_set_curve(PAMA_VOLUME_CURVE_DECIBEL);
+	if (value)
+		gconf_value_free(value);
+
+	/* Loudness needs real audio from every metered device and application */
+	pama_pulse_meter_set_measure_loudness(panel_applet_gconf_get_bool(applet, "measure_loudness", NULL));
+
+	/* Latency is asked for every this many milliseconds while the popup is
+	 * open; left unset it is not asked for, nor shown, at all */
+	pama_latency_poll_set_interval(panel_applet_gconf_get_int(applet, "latency_interval", NULL));
+
+	/* Clicks after volume changes are asked for */
+	pama_feedback_sound_set_enabled(panel_applet_gconf_get_bool(applet, "volume_feedback", NULL));
+
 	return FALSE;
 }
 
@@ -194,8 +282,9 @@ static void pama_applet_pulse_context_connected(PamaPulseContext *context, gpoin
 
 	gtk_widget_set_sensitive(GTK_WIDGET(priv->sink_event_box),   TRUE);
 	gtk_widget_set_sensitive(GTK_WIDGET(priv->source_event_box), TRUE);
-	gtk_widget_set_tooltip_text(GTK_WIDGET(priv->sink_event_box),   _("No information received yet"));
-	gtk_widget_set_tooltip_text(GTK_WIDGET(priv->source_event_box), _("No information received yet"));
+	priv->connected = TRUE;
+	priv->informed  = FALSE;
+	gtk_widget_trigger_tooltip_query(GTK_WIDGET(applet));
 }
 
 static void pama_applet_pulse_context_disconnected(PamaPulseContext *context, gpointer data)
@@ -214,12 +303,14 @@ static void pama_applet_pulse_context_disconnected(PamaPulseContext *context, gp
 	if (priv->source_popup)
 		gtk_widget_destroy(GTK_WIDGET(priv->source_popup));
 
-	gtk_image_set_from_icon_name(GTK_IMAGE(priv->sink_icon),   "audio-volume-muted",           GTK_ICON_SIZE_MENU);
-	gtk_image_set_from_icon_name(GTK_IMAGE(priv->source_icon), "audio-input-microphone-muted", GTK_ICON_SIZE_MENU);
-	gtk_widget_set_tooltip_text(GTK_WIDGET(priv->sink_event_box),   _("Not connected to PulseAudio server"));
-	gtk_widget_set_tooltip_text(GTK_WIDGET(priv->source_event_box), _("Not connected to PulseAudio server"));
+	pama_applet_set_icon(priv->sink_icon,   &priv->sink_icon_name,   "audio-volume-muted");
+	pama_applet_set_icon(priv->source_icon, &priv->source_icon_name, "audio-input-microphone-muted");
+	pama_activity_badge_set(priv->sink_icon,   FALSE);
+	pama_activity_badge_set(priv->source_icon, FALSE);
 	gtk_widget_set_sensitive(GTK_WIDGET(priv->sink_event_box),   FALSE);
 	gtk_widget_set_sensitive(GTK_WIDGET(priv->source_event_box), FALSE);
+	priv->connected = FALSE;
+	gtk_widget_trigger_tooltip_query(GTK_WIDGET(applet));
 
 	g_timeout_add_seconds(10, pama_applet_create_context, applet);
 }
@@ -275,6 +366,7 @@ static void pama_applet_update_default_devices(PamaApplet *applet)
 			g_signal_connect(priv->default_source, "notify::volume", G_CALLBACK(pama_applet_io_devs_notify), applet);
 	}
 
+	priv->informed = TRUE;
 	pama_applet_update_icons(applet);
 }
 
@@ -312,152 +404,241 @@ static void pama_applet_dispose(GObject *gobject)
 		priv->context = NULL;
 	}
 
+	if (priv->update_idle)
+	{
+		g_source_remove(priv->update_idle);
+		priv->update_idle = 0;
+	}
+
+	if (priv->hidden_roles)
+	{
+		g_strfreev(priv->hidden_roles);
+		priv->hidden_roles = NULL;
+	}
+
 	G_OBJECT_CLASS(pama_applet_parent_class)->dispose(gobject);
 }
 
 
 
+// Volume sweeps notify many times per frame; the icons and the panel's menu
+// are only brought up to date once, right before the next redraw.
 static void pama_applet_update_icons(PamaApplet *applet)
 {
 	PamaAppletPrivate *priv = PAMA_APPLET_GET_PRIVATE(applet);
+
+	if (!priv->update_idle)
+		priv->update_idle = g_idle_add_full(G_PRIORITY_HIGH_IDLE, pama_applet_update_icons_idle, applet, NULL);
+}
+
+static gboolean pama_applet_update_icons_idle(gpointer data)
+{
+	PamaApplet *applet = data;
+	PamaAppletPrivate *priv = PAMA_APPLET_GET_PRIVATE(applet);
 	guint32 volume;
 	double  volume_dB;
-	gboolean mute, decibel_volume, network;
-	gchar *description;
-	gchar *hostname;
-	gchar *tooltip;
-	gchar *description_markup;
-	BonoboUIComponent *popup;
+	gboolean mute, decibel_volume;
 
+	priv->update_idle = 0;
 	priv->updating = TRUE;
-	popup = panel_applet_get_popup_component(PANEL_APPLET(applet));
 
 	if (priv->default_sink)
 	{
-		bonobo_ui_component_set_prop(popup, "/commands/MuteSink", "sensitive", "1", NULL);
+		pama_applet_set_menu_prop(applet, "/commands/MuteSink", "sensitive", &priv->sink_sensitive, TRUE);
+		pama_activity_badge_set(priv->sink_icon, pama_pulse_sink_is_running(priv->default_sink));
 		
 		g_object_get(priv->default_sink,
 		             "mute", &mute,
 		             "volume", &volume,
 		             "decibel-volume", &decibel_volume,
-		             "description", &description,
-		             "hostname", &hostname,
-		             "network", &network,
 		             NULL);
 
-		if (network)
-			description_markup = g_markup_printf_escaped("<b>%s</b> (on %s)", description, hostname);
-		else
-			description_markup = g_markup_printf_escaped("<b>%s</b>", description);
-
 		if (mute)
 		{
-			bonobo_ui_component_set_prop(popup, "/commands/MuteSink", "state", "1", NULL);
-			gtk_image_set_from_icon_name(GTK_IMAGE(priv->sink_icon), "audio-volume-muted", GTK_ICON_SIZE_MENU);
-			tooltip = g_strdup_printf("%s: %s", description_markup, _("muted"));
+			pama_applet_set_menu_prop(applet, "/commands/MuteSink", "state", &priv->sink_mute, TRUE);
+			pama_applet_set_icon(priv->sink_icon, &priv->sink_icon_name, "audio-volume-muted");
 		}
 		else
 		{
-			bonobo_ui_component_set_prop(popup, "/commands/MuteSink", "state", "0", NULL);
+			pama_applet_set_menu_prop(applet, "/commands/MuteSink", "state", &priv->sink_mute, FALSE);
 			if (decibel_volume)
 			{
-				volume_dB = pa_sw_volume_to_dB(volume);
+				volume_dB = pama_volume_map_to_dB(volume);
 
 				if (volume_dB < -(WIDGET_VOLUME_SLIDER_DB_RANGE * 2.0 / 3.0))
-					gtk_image_set_from_icon_name(GTK_IMAGE(priv->sink_icon), "audio-volume-low", GTK_ICON_SIZE_MENU);
+					pama_applet_set_icon(priv->sink_icon, &priv->sink_icon_name, "audio-volume-low");
 				else if (volume_dB < -(WIDGET_VOLUME_SLIDER_DB_RANGE / 3.0))
-					gtk_image_set_from_icon_name(GTK_IMAGE(priv->sink_icon), "audio-volume-medium", GTK_ICON_SIZE_MENU);
-				else
-					gtk_image_set_from_icon_name(GTK_IMAGE(priv->sink_icon), "audio-volume-high", GTK_ICON_SIZE_MENU);
-
-				if (isinf(volume_dB))
-					tooltip = g_strdup_printf("%s: -∞dB", description_markup);
+					pama_applet_set_icon(priv->sink_icon, &priv->sink_icon_name, "audio-volume-medium");
 				else
-					tooltip = g_strdup_printf("%s: %+.1fdB", description_markup, volume_dB);
+					pama_applet_set_icon(priv->sink_icon, &priv->sink_icon_name, "audio-volume-high");
 			}
 			else
 			{
 				if (volume < (PA_VOLUME_NORM/3))
-					gtk_image_set_from_icon_name(GTK_IMAGE(priv->sink_icon), "audio-volume-low", GTK_ICON_SIZE_MENU);
+					pama_applet_set_icon(priv->sink_icon, &priv->sink_icon_name, "audio-volume-low");
 				else if (volume < (2 * PA_VOLUME_NORM / 3))
-					gtk_image_set_from_icon_name(GTK_IMAGE(priv->sink_icon), "audio-volume-medium", GTK_ICON_SIZE_MENU);
+					pama_applet_set_icon(priv->sink_icon, &priv->sink_icon_name, "audio-volume-medium");
 				else
-					gtk_image_set_from_icon_name(GTK_IMAGE(priv->sink_icon), "audio-volume-high", GTK_ICON_SIZE_MENU);
-
-				tooltip = g_strdup_printf("%s: %.0f%%", description_markup, 100.0 * volume / PA_VOLUME_NORM);
+					pama_applet_set_icon(priv->sink_icon, &priv->sink_icon_name, "audio-volume-high");
 			}
 		}
-		gtk_widget_set_tooltip_markup(GTK_WIDGET(priv->sink_event_box), tooltip);
-		g_free(tooltip);
-		g_free(description);
-		g_free(hostname);
-		g_free(description_markup);
 	}
 	else
 	{
-		bonobo_ui_component_set_prop(popup, "/commands/MuteSink", "sensitive", "0", NULL);
-		gtk_image_set_from_icon_name(GTK_IMAGE(priv->sink_icon), "audio-volume-muted", GTK_ICON_SIZE_MENU);
-		gtk_widget_set_tooltip_text(GTK_WIDGET(priv->sink_event_box), _("No information for the default output device is available"));
+		pama_applet_set_menu_prop(applet, "/commands/MuteSink", "sensitive", &priv->sink_sensitive, FALSE);
+		pama_activity_badge_set(priv->sink_icon, FALSE);
+		pama_applet_set_icon(priv->sink_icon, &priv->sink_icon_name, "audio-volume-muted");
 	}
 
 	if (priv->default_source)
 	{
-		bonobo_ui_component_set_prop(popup, "/commands/MuteSource", "sensitive", "1", NULL);
+		pama_applet_set_menu_prop(applet, "/commands/MuteSource", "sensitive", &priv->source_sensitive, TRUE);
+		pama_activity_badge_set(priv->source_icon, pama_pulse_source_is_running(priv->default_source));
 		g_object_get(priv->default_source,
 		             "mute", &mute,
-		             "volume", &volume,
-		             "decibel-volume", &decibel_volume,
-		             "description", &description,
-		             "hostname", &hostname,
-		             "network", &network,
 		             NULL);
 
-		if (network)
-			description_markup = g_markup_printf_escaped("<b>%s</b> (on %s)", description, hostname);
-		else
-			description_markup = g_markup_printf_escaped("<b>%s</b>", description);
-
 		if (mute)
 		{
-			bonobo_ui_component_set_prop(popup, "/commands/MuteSource", "state", "1", NULL);
-			gtk_image_set_from_icon_name(GTK_IMAGE(priv->source_icon), "audio-input-microphone-muted", GTK_ICON_SIZE_MENU);
-			tooltip = g_strdup_printf("%s: %s", description_markup, _("muted"));
+			pama_applet_set_menu_prop(applet, "/commands/MuteSource", "state", &priv->source_mute, TRUE);
+			pama_applet_set_icon(priv->source_icon, &priv->source_icon_name, "audio-input-microphone-muted");
 		}
 		else
 		{
-			bonobo_ui_component_set_prop(popup, "/commands/MuteSource", "state", "0", NULL);
-			gtk_image_set_from_icon_name(GTK_IMAGE(priv->source_icon), "audio-input-microphone", GTK_ICON_SIZE_MENU);
-
-			if (decibel_volume)
-			{
-				volume_dB = pa_sw_volume_to_dB(volume);
-
-				if (isinf(volume_dB))
-					tooltip = g_strdup_printf("%s: -∞dB", description_markup);
-				else
-					tooltip = g_strdup_printf("%s: %+.1fdB", description_markup, volume_dB);
-			}
-			else
-			{
-				tooltip = g_strdup_printf("%s: %.0f%%", description_markup, 100.0 * volume / PA_VOLUME_NORM);
-			}
+			pama_applet_set_menu_prop(applet, "/commands/MuteSource", "state", &priv->source_mute, FALSE);
+			pama_applet_set_icon(priv->source_icon, &priv->source_icon_name, "audio-input-microphone");
 		}
-		gtk_widget_set_tooltip_markup(GTK_WIDGET(priv->source_event_box), tooltip);
-		g_free(tooltip);
-		g_free(description);
-		g_free(hostname);
-		g_free(description_markup);
 	}
 	else
 	{
-		bonobo_ui_component_set_prop(popup, "/commands/MuteSource", "sensitive", "0", NULL);
-		gtk_image_set_from_icon_name(GTK_IMAGE(priv->sink_icon), "audio-input-microphone-muted", GTK_ICON_SIZE_MENU);
-		gtk_widget_set_tooltip_text(GTK_WIDGET(priv->sink_event_box), _("No information for the default input device is available"));
+		pama_applet_set_menu_prop(applet, "/commands/MuteSource", "sensitive", &priv->source_sensitive, FALSE);
+		pama_activity_badge_set(priv->source_icon, FALSE);
+		pama_applet_set_icon(priv->source_icon, &priv->source_icon_name, "audio-input-microphone-muted");
 	}
 
-	gtk_widget_trigger_tooltip_query(GTK_WIDGET(applet));
+	// Tooltips are built in pama_applet_icon_query_tooltip(); only ask for a
+	// new one when the pointer is over the icons and one may be showing
+	if (priv->hovered)
+		gtk_widget_trigger_tooltip_query(GTK_WIDGET(applet));
 
 	priv->updating = FALSE;
+	return FALSE;
+}
+
+static void pama_applet_set_icon(GtkWidget *image, const gchar **current, const gchar *icon_name)
+{
+	if (*current == icon_name || !strcmp(*current, icon_name))
+		return;
+
+	*current = icon_name;
+	gtk_image_set_from_icon_name(GTK_IMAGE(image), icon_name, GTK_ICON_SIZE_MENU);
+}
+
+// Every property set is a round-trip to the panel, so only changes are sent
+static void pama_applet_set_menu_prop(PamaApplet *applet, const gchar *path, const gchar *name, gint *current, gboolean value)
+{
+	if (*current == (value ? 1 : 0))
+		return;
+
+	*current = value ? 1 : 0;
+	bonobo_ui_component_set_prop(panel_applet_get_popup_component(PANEL_APPLET(applet)), path, name, value ? "1" : "0", NULL);
+}
+
+static gchar *pama_applet_build_tooltip(GObject *device)
+{
+	guint32 volume;
+	double  volume_dB;
+	gboolean mute, decibel_volume, network;
+	gchar *description;
+	gchar *hostname;
+	gchar *tooltip;
+	gchar *description_markup;
+	gchar *clipping, *temp;
+	GObject *history_owner = device;
+
+	g_object_get(device,
+	             "mute", &mute,
+	             "volume", &volume,
+	             "decibel-volume", &decibel_volume,
+	             "description", &description,
+	             "hostname", &hostname,
+	             "network", &network,
+	             NULL);
+
+	if (network)
+		description_markup = g_markup_printf_escaped("<b>%s</b> (on %s)", description, hostname);
+	else
+		description_markup = g_markup_printf_escaped("<b>%s</b>", description);
+
+	if (mute)
+		tooltip = g_strdup_printf("%s: %s", description_markup, _("muted"));
+	else if (decibel_volume)
+	{
+		volume_dB = pama_volume_map_to_dB(volume);
+
+		if (isinf(volume_dB))
+			tooltip = g_strdup_printf("%s: -∞dB", description_markup);
+		else
+			tooltip = g_strdup_printf("%s: %+.1fdB", description_markup, volume_dB);
+	}
+	else
+		tooltip = g_strdup_printf("%s: %.0f%%", description_markup, 100.0 * volume / PA_VOLUME_NORM);
+
+	/* Clipping on a sink is recorded on its monitor, while the popup meters it */
+	if (PAMA_IS_PULSE_SINK(device))
+		g_object_get(device, "monitor", &history_owner, NULL);
+	clipping = pama_clip_history_describe(history_owner);
+	if (history_owner && history_owner != device)
+		g_object_unref(history_owner);
+
+	if (clipping)
+	{
+		temp = g_markup_escape_text(clipping, -1);
+		g_free(clipping);
+		clipping = tooltip;
+		tooltip = g_strdup_printf("%s\n<span foreground=\"%s\">%s</span>", clipping, WIDGET_CLIP_COLOR, temp);
+		g_free(clipping);
+		g_free(temp);
+	}
+
+	g_free(description);
+	g_free(hostname);
+	g_free(description_markup);
+	return tooltip;
+}
+
+static gboolean pama_applet_icon_query_tooltip(GtkWidget *event_box, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data)
+{
+	PamaApplet *applet = data;
+	PamaAppletPrivate *priv = PAMA_APPLET_GET_PRIVATE(applet);
+	gboolean is_sink = (event_box == priv->sink_event_box);
+	GObject *device = is_sink ? (GObject *) priv->default_sink : (GObject *) priv->default_source;
+	gchar *markup;
+
+	if (!priv->context || !priv->connected)
+		gtk_tooltip_set_text(tooltip, _("Not connected to PulseAudio server"));
+	else if (!priv->informed)
+		gtk_tooltip_set_text(tooltip, _("No information received yet"));
+	else if (!device)
+		gtk_tooltip_set_text(tooltip, is_sink ? _("No information for the default output device is available")
+		                                      : _("No information for the default input device is available"));
+	else
+	{
+		markup = pama_applet_build_tooltip(device);
+		gtk_tooltip_set_markup(tooltip, markup);
+		g_free(markup);
+	}
+
+	return TRUE;
+}
+
+static gboolean pama_applet_icon_crossing(GtkWidget *event_box, GdkEventCrossing *event, gpointer data)
+{
+	PamaApplet *applet = data;
+	PamaAppletPrivate *priv = PAMA_APPLET_GET_PRIVATE(applet);
+
+	priv->hovered = (event->type == GDK_ENTER_NOTIFY);
+	return FALSE;
 }
 
 static gboolean pama_applet_icon_scroll(GtkWidget *event_box, GdkEventScroll *event, gpointer data)
@@ -484,9 +665,9 @@ static gboolean pama_applet_icon_scroll(GtkWidget *event_box, GdkEventScroll *ev
 
 				if (decibel_volume)
 				{
-					volume_dB = pa_sw_volume_to_dB(volume);
+					volume_dB = pama_volume_map_to_dB(volume);
 					volume_dB += VOLUME_SCROLL_STEP_DB;
-					volume = pa_sw_volume_from_dB(volume_dB);
+					volume = pama_volume_map_from_dB(volume_dB);
 				}
 				else
 				{
@@ -496,6 +677,7 @@ static gboolean pama_applet_icon_scroll(GtkWidget *event_box, GdkEventScroll *ev
 					volume = PA_VOLUME_NORM;
 
 				pama_pulse_sink_set_volume(priv->default_sink, volume);
+				pama_feedback_sound_play(priv->context, priv->default_sink, PA_VOLUME_NORM);
 			}
 			else if (event_box == priv->source_event_box && priv->default_source)
 			{
@@ -506,9 +688,9 @@ static gboolean pama_applet_icon_scroll(GtkWidget *event_box, GdkEventScroll *ev
 
 				if (decibel_volume)
 				{
-					volume_dB = pa_sw_volume_to_dB(volume);
+					volume_dB = pama_volume_map_to_dB(volume);
 					volume_dB += VOLUME_SCROLL_STEP_DB;
-					volume = pa_sw_volume_from_dB(volume_dB);
+					volume = pama_volume_map_from_dB(volume_dB);
 				}
 				else
 				{
@@ -533,9 +715,9 @@ static gboolean pama_applet_icon_scroll(GtkWidget *event_box, GdkEventScroll *ev
 
 				if (decibel_volume)
 				{
-					volume_dB = pa_sw_volume_to_dB(volume);
+					volume_dB = pama_volume_map_to_dB(volume);
 					volume_dB -= VOLUME_SCROLL_STEP_DB;
-					volume = pa_sw_volume_from_dB(volume_dB);
+					volume = pama_volume_map_from_dB(volume_dB);
 				}
 				else
 				{
@@ -546,6 +728,7 @@ static gboolean pama_applet_icon_scroll(GtkWidget *event_box, GdkEventScroll *ev
 				}
 
 				pama_pulse_sink_set_volume(priv->default_sink, volume);
+				pama_feedback_sound_play(priv->context, priv->default_sink, PA_VOLUME_NORM);
 			}
 			else if (event_box == priv->source_event_box && priv->default_source)
 			{
@@ -556,9 +739,9 @@ static gboolean pama_applet_icon_scroll(GtkWidget *event_box, GdkEventScroll *ev
 
 				if (decibel_volume)
 				{
-					volume_dB = pa_sw_volume_to_dB(volume);
+					volume_dB = pama_volume_map_to_dB(volume);
 					volume_dB -= VOLUME_SCROLL_STEP_DB;
-					volume = pa_sw_volume_from_dB(volume_dB);
+					volume = pama_volume_map_from_dB(volume_dB);
 				}
 				else
 				{
@@ -599,7 +782,7 @@ static gboolean pama_applet_icon_click (GtkWidget *event_box, GdkEventButton *ev
 					if (priv->source_popup)
 						gtk_widget_destroy(GTK_WIDGET(priv->source_popup));
 
-					priv->sink_popup = pama_sink_popup_new(priv->context);
+					priv->sink_popup = pama_sink_popup_new(priv->context, priv->group_streams, priv->active_only, priv->new_stream_delay, priv->hidden_roles);
 					g_signal_connect(priv->sink_popup, "destroy", G_CALLBACK(gtk_widget_destroyed),   &priv->sink_popup);
 					pama_popup_set_popup_alignment(PAMA_POPUP(priv->sink_popup), priv->sink_event_box, priv->orientation);
 					pama_popup_show(PAMA_POPUP(priv->sink_popup));
@@ -675,6 +858,7 @@ static void pama_applet_toggle_sink_mute  (BonoboUIComponent *uic, const char *p
 		return;
 
 	mute = strcmp(state, "0") != 0;
+	priv->sink_mute = mute;
 	
 	if (priv->default_sink)
 		pama_pulse_sink_set_mute(priv->default_sink, mute);
@@ -689,7 +873,32 @@ static void pama_applet_toggle_source_mute(BonoboUIComponent *uic, const char *p
 		return;
 
 	mute = strcmp(state, "0") != 0;
+	priv->source_mute = mute;
 	
 	if (priv->default_source)
 		pama_pulse_source_set_mute(priv->default_source, mute);
 }
+static void pama_applet_toggle_group_streams(BonoboUIComponent *uic, const char *path, Bonobo_UIComponent_EventType type, const char *state, gpointer data)
+{
+	PamaApplet *applet = data;
+	PamaAppletPrivate *priv = PAMA_APPLET_GET_PRIVATE(applet);
+
+	priv->group_streams = strcmp(state, "0") != 0;
+	panel_applet_gconf_set_bool(PANEL_APPLET(applet), "group_streams", priv->group_streams, NULL);
+
+	/* Takes effect the next time the popup is opened */
+	if (priv->sink_popup)
+		gtk_widget_destroy(GTK_WIDGET(priv->sink_popup));
+}
+static void pama_applet_toggle_active_only(BonoboUIComponent *uic, const char *path, Bonobo_UIComponent_EventType type, const char *state, gpointer data)
+{
+	PamaApplet *applet = data;
+	PamaAppletPrivate *priv = PAMA_APPLET_GET_PRIVATE(applet);
+
+	priv->active_only = strcmp(state, "0") != 0;
+	panel_applet_gconf_set_bool(PANEL_APPLET(applet), "active_only", priv->active_only, NULL);
+
+	/* Takes effect the next time the popup is opened */
+	if (priv->sink_popup)
+		gtk_widget_destroy(GTK_WIDGET(priv->sink_popup));
+}
@@ -0,0 +1,139 @@
+/*
+ * pama-clip-history.c: A short history of clipping on a device or stream
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include "pama-clip-history.h"
+#include "widget-settings.h"
+
+/* Meters count the frames that reached full scale and the times a device or
+ * stream stayed near it, and add them here, on the PamaPulseSource or
+ * PamaPulseSinkInput they measured. Each owner gets a ring of one-second
+ * slots covering the last WIDGET_CLIP_HISTORY_SECONDS; a slot is cleared when
+ * its second comes round again, so the history never grows and old counts
+ * fall out of it on their own. The history outlives the meters, so the panel
+ * tooltip can still report clipping after the popup is closed. */
+
+#define CLIP_HISTORY_KEY "pama-clip-history"
+
+/* The tooltips say "in the last minute" */
+G_STATIC_ASSERT(60 == WIDGET_CLIP_HISTORY_SECONDS);
+
+typedef struct
+{
+	glong seconds[WIDGET_CLIP_HISTORY_SECONDS]; /* the second each slot counts */
+	guint clipped[WIDGET_CLIP_HISTORY_SECONDS];
+	guint overs  [WIDGET_CLIP_HISTORY_SECONDS];
+} PamaClipHistory;
+
+static glong pama_clip_history_now(void);
+
+static glong pama_clip_history_now(void)
+{
+	GTimeVal now;
+
+	g_get_current_time(&now);
+	return now.tv_sec;
+}
+
+void pama_clip_history_add(GObject *owner, guint clipped, guint overs)
+{
+	PamaClipHistory *history;
+	glong now;
+	guint slot;
+
+	if (0 == clipped && 0 == overs)
+		return;
+
+	history = g_object_get_data(owner, CLIP_HISTORY_KEY);
+	if (NULL == history)
+	{
+		history = g_new0(PamaClipHistory, 1);
+		g_object_set_data_full(owner, CLIP_HISTORY_KEY, history, g_free);
+	}
+
+	now  = pama_clip_history_now();
+	slot = now % WIDGET_CLIP_HISTORY_SECONDS;
+	if (history->seconds[slot] != now)
+	{
+		history->seconds[slot] = now;
+		history->clipped[slot] = 0;
+		history->overs  [slot] = 0;
+	}
+
+	history->clipped[slot] += clipped;
+	history->overs  [slot] += overs;
+}
+
+// Totals the counts of the last WIDGET_CLIP_HISTORY_SECONDS, and returns
+// whether there were any.
+gboolean pama_clip_history_get(GObject *owner, guint *clipped, guint *overs)
+{
+	PamaClipHistory *history = owner ? g_object_get_data(owner, CLIP_HISTORY_KEY) : NULL;
+	glong now;
+	guint slot;
+
+	*clipped = 0;
+	*overs   = 0;
+
+	if (NULL == history)
+		return FALSE;
+
+	now = pama_clip_history_now();
+	for (slot = 0; slot < WIDGET_CLIP_HISTORY_SECONDS; slot++)
+	{
+		if (now - history->seconds[slot] >= WIDGET_CLIP_HISTORY_SECONDS)
+			continue;
+
+		*clipped += history->clipped[slot];
+		*overs   += history->overs[slot];
+	}
+
+	return *clipped || *overs;
+}
+
+// Returns a line for tooltips per kind of event, or NULL if there was no
+// clipping lately.
+gchar *pama_clip_history_describe(GObject *owner)
+{
+	guint  clipped, overs, n_lines = 0;
+	gchar *lines[3], *text;
+
+	if (!pama_clip_history_get(owner, &clipped, &overs))
+		return NULL;
+
+	/* Clipped meter frames are peaks or samples depending on the meter, so neither is named */
+	if (clipped)
+		lines[n_lines++] = g_strdup_printf(ngettext("Clipped %u time in the last minute",
+		                                            "Clipped %u times in the last minute", clipped), clipped);
+	if (overs)
+		lines[n_lines++] = g_strdup_printf(ngettext("Near full scale %u time in the last minute",
+		                                            "Near full scale %u times in the last minute", overs), overs);
+	lines[n_lines] = NULL;
+
+	text = g_strjoinv("\n", lines);
+	while (n_lines)
+		g_free(lines[--n_lines]);
+	return text;
+}
@@ -0,0 +1,35 @@
+/*
+ * pama-clip-history.h: A short history of clipping on a device or stream
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_CLIP_HISTORY_H
+#define PAMA_CLIP_HISTORY_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+void      pama_clip_history_add     (GObject *owner, guint clipped, guint overs);
+gboolean  pama_clip_history_get     (GObject *owner, guint *clipped, guint *overs);
+gchar    *pama_clip_history_describe(GObject *owner);
+
+G_END_DECLS
+
+#endif /* PAMA_CLIP_HISTORY_H */
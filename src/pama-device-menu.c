@@ -0,0 +1,550 @@
+/*
+ * pama-device-menu.c: A menu of all sinks or sources, shared by the streams of a popup
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+#include <string.h>
+
+#include "pama-device-menu.h"
+
+static void     pama_device_menu_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec);
+static GObject* pama_device_menu_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties);
+static void     pama_device_menu_dispose(GObject *gobject);
+static void     pama_device_menu_finalize(GObject *gobject);
+static void     pama_device_menu_weak_ref_notify(gpointer data, GObject *where_the_object_was);
+
+static void     pama_device_menu_device_added(PamaPulseContext *context, guint index, gpointer data);
+static void     pama_device_menu_device_removed(PamaPulseContext *context, guint index, gpointer data);
+static void     pama_device_menu_device_notify(GObject *gobject, GParamSpec *pspec, gpointer data);
+static void     pama_device_menu_sink_added(PamaPulseContext *context, guint index, gpointer data);
+static void     pama_device_menu_monitored_sink_notify(GObject *gobject, GParamSpec *pspec, gpointer data);
+static void     pama_device_menu_item_toggled(GtkCheckMenuItem *item, gpointer data);
+
+static void     pama_device_menu_add_device(PamaDeviceMenu *menu, GObject *device);
+static void     pama_device_menu_update_item(PamaDeviceMenu *menu, GtkWidget *item);
+static void     pama_device_menu_watch_monitored_sink(PamaDeviceMenu *menu, GObject *device, gboolean watch);
+static gint     pama_device_menu_compare(PamaDeviceMenu *menu, GObject *a, GObject *b);
+
+struct _PamaDeviceMenuPrivate
+{
+	PamaPulseContext *context;
+	GType             device_type;
+
+	/* device index -> GtkRadioMenuItem, whose "user-data" is the device */
+	GHashTable *items;
+
+	/* Hidden first item of the radio group, active when the stream's device is not listed */
+	GtkWidget *none;
+
+	/* The stream whose device is being chosen; cleared if it goes away while the menu is open */
+	GObject *stream;
+	gboolean updating;
+
+	gulong added_handler_id;
+	gulong removed_handler_id;
+	gulong sink_added_handler_id; /* monitors are labelled after sinks that may come later */
+};
+
+G_DEFINE_TYPE(PamaDeviceMenu, pama_device_menu, GTK_TYPE_MENU);
+#define PAMA_DEVICE_MENU_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE((obj), PAMA_TYPE_DEVICE_MENU, PamaDeviceMenuPrivate))
+
+enum
+{
+	PROP_0,
+
+	PROP_CONTEXT,
+	PROP_DEVICE_TYPE
+};
+
+static void pama_device_menu_class_init(PamaDeviceMenuClass *klass)
+{
+	GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+	GParamSpec *pspec;
+
+	gobject_class->set_property = pama_device_menu_set_property;
+	gobject_class->constructor  = pama_device_menu_constructor;
+	gobject_class->dispose      = pama_device_menu_dispose;
+	gobject_class->finalize     = pama_device_menu_finalize;
+
+	pspec = g_param_spec_object("context",
+	                            "Pulse context object",
+	                            "The PamaPulseContext whose devices are listed.",
+	                            PAMA_TYPE_PULSE_CONTEXT,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_CONTEXT, pspec);
+
+	pspec = g_param_spec_gtype("device-type",
+	                           "Device type",
+	                           "Either PAMA_TYPE_PULSE_SINK or PAMA_TYPE_PULSE_SOURCE.",
+	                           G_TYPE_OBJECT,
+	                           G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_DEVICE_TYPE, pspec);
+
+	g_type_class_add_private(klass, sizeof(PamaDeviceMenuPrivate));
+}
+
+static void pama_device_menu_init(PamaDeviceMenu *menu)
+{
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(menu);
+
+	priv->items = g_hash_table_new(g_direct_hash, g_direct_equal);
+}
+
+static void pama_device_menu_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec)
+{
+	PamaDeviceMenu *menu = PAMA_DEVICE_MENU(gobject);
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(menu);
+
+	switch(property_id)
+	{
+		case PROP_CONTEXT:
+			priv->context = g_value_get_object(value);
+			g_object_weak_ref(G_OBJECT(priv->context), pama_device_menu_weak_ref_notify, menu);
+			break;
+
+		case PROP_DEVICE_TYPE:
+			priv->device_type = g_value_get_gtype(value);
+			break;
+
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
+			break;
+	}
+}
+
+static GObject* pama_device_menu_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties)
+{
+	GObject *gobject = G_OBJECT_CLASS(pama_device_menu_parent_class)->constructor(gtype, n_properties, properties);
+	PamaDeviceMenu *menu = PAMA_DEVICE_MENU(gobject);
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(menu);
+	GSList *devices, *iter;
+	const gchar *added_signal, *removed_signal;
+
+	if (NULL == priv->context)
+		g_error("An attempt was made to construct a PamaDeviceMenu without providing a valid PamaPulseContext.");
+
+	if (PAMA_TYPE_PULSE_SINK == priv->device_type)
+	{
+		devices        = pama_pulse_context_get_sinks(priv->context);
+		added_signal   = "sink-added";
+		removed_signal = "sink-removed";
+	}
+	else if (PAMA_TYPE_PULSE_SOURCE == priv->device_type)
+	{
+		devices        = pama_pulse_context_get_sources(priv->context);
+		added_signal   = "source-added";
+		removed_signal = "source-removed";
+	}
+	else
+	{
+		g_error("An attempt was made to construct a PamaDeviceMenu for an unsupported device type.");
+		return gobject;
+	}
+
+	/* Never shown, so that activating it takes the mark off every device */
+	priv->none = gtk_radio_menu_item_new(NULL);
+	gtk_menu_shell_append(GTK_MENU_SHELL(menu), priv->none);
+
+	for (iter = devices; iter; iter = iter->next)
+		pama_device_menu_add_device(menu, G_OBJECT(iter->data));
+
+	priv->added_handler_id   = g_signal_connect(priv->context, added_signal,   G_CALLBACK(pama_device_menu_device_added),   menu);
+	priv->removed_handler_id = g_signal_connect(priv->context, removed_signal, G_CALLBACK(pama_device_menu_device_removed), menu);
+	if (PAMA_TYPE_PULSE_SOURCE == priv->device_type)
+		priv->sink_added_handler_id = g_signal_connect(priv->context, "sink-added", G_CALLBACK(pama_device_menu_sink_added), menu);
+
+	return gobject;
+}
+static void pama_device_menu_dispose(GObject *gobject)
+{
+	PamaDeviceMenu *menu = PAMA_DEVICE_MENU(gobject);
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(menu);
+	GHashTableIter iter;
+	gpointer item;
+
+	if (priv->context)
+	{
+		if (priv->added_handler_id)
+		{
+			g_signal_handler_disconnect(priv->context, priv->added_handler_id);
+			priv->added_handler_id = 0;
+		}
+
+		if (priv->removed_handler_id)
+		{
+			g_signal_handler_disconnect(priv->context, priv->removed_handler_id);
+			priv->removed_handler_id = 0;
+		}
+
+		if (priv->sink_added_handler_id)
+		{
+			g_signal_handler_disconnect(priv->context, priv->sink_added_handler_id);
+			priv->sink_added_handler_id = 0;
+		}
+	}
+
+	g_hash_table_iter_init(&iter, priv->items);
+	while (g_hash_table_iter_next(&iter, NULL, &item))
+	{
+		GObject *device;
+
+		g_object_get(item, "user-data", &device, NULL);
+		g_signal_handlers_disconnect_by_func(device, pama_device_menu_device_notify, menu);
+		pama_device_menu_watch_monitored_sink(menu, device, FALSE);
+	}
+
+	/* Monitored sinks are looked up through the context */
+	if (priv->context)
+	{
+		g_object_weak_unref(G_OBJECT(priv->context), pama_device_menu_weak_ref_notify, menu);
+		priv->context = NULL;
+	}
+
+	g_hash_table_remove_all(priv->items);
+
+	if (priv->stream)
+	{
+		g_object_remove_weak_pointer(priv->stream, (gpointer *)&priv->stream);
+		priv->stream = NULL;
+	}
+
+	G_OBJECT_CLASS(pama_device_menu_parent_class)->dispose(gobject);
+}
+static void pama_device_menu_finalize(GObject *gobject)
+{
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(gobject);
+
+	g_hash_table_destroy(priv->items);
+
+	G_OBJECT_CLASS(pama_device_menu_parent_class)->finalize(gobject);
+}
+static void pama_device_menu_weak_ref_notify(gpointer data, GObject *where_the_object_was)
+{
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(data);
+
+	if ((GObject *)priv->context == where_the_object_was)
+	{
+		priv->context = NULL;
+		priv->added_handler_id = 0;
+		priv->removed_handler_id = 0;
+		priv->sink_added_handler_id = 0;
+	}
+}
+
+
+static void pama_device_menu_add_device(PamaDeviceMenu *menu, GObject *device)
+{
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(menu);
+	GtkWidget *item, *label;
+	guint index;
+
+	g_object_get(device, "index", &index, NULL);
+
+	if (g_hash_table_lookup(priv->items, GUINT_TO_POINTER(index)))
+		return;
+
+	item = gtk_radio_menu_item_new_from_widget(GTK_RADIO_MENU_ITEM(priv->none));
+	g_list_free(children);
+
+	label = g_object_new(GTK_TYPE_LABEL,
+	                     "use-markup", TRUE,
+	                     "xalign", 0.0,
+	                     NULL);
+	gtk_container_add(GTK_CONTAINER(item), label);
+	g_object_set(item, "user-data", device, NULL);
+
+	g_signal_connect(item, "toggled", G_CALLBACK(pama_device_menu_item_toggled), menu);
+	gtk_menu_shell_append(GTK_MENU_SHELL(menu), item);
+	gtk_widget_show_all(item);
+
+	g_hash_table_insert(priv->items, GUINT_TO_POINTER(index), item);
+	pama_device_menu_update_item(menu, item);
+
+	/* These are the only properties shown in, or affecting the order of, the menu */
+	g_signal_connect(device, "notify::description", G_CALLBACK(pama_device_menu_device_notify), menu);
+	g_signal_connect(device, "notify::hostname",    G_CALLBACK(pama_device_menu_device_notify), menu);
+	pama_device_menu_watch_monitored_sink(menu, device, TRUE);
+}
+
+// Starts or stops updating the label of a monitor when the description of
+// the sink it monitors changes. Does nothing for other devices, or while the
+// sink is not known yet.
+static void pama_device_menu_watch_monitored_sink(PamaDeviceMenu *menu, GObject *device, gboolean watch)
+{
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(menu);
+	PamaPulseSink *monitored_sink;
+
+	if (PAMA_TYPE_PULSE_SOURCE != priv->device_type || NULL == priv->context)
+		return;
+
+	monitored_sink = pama_pulse_source_get_monitored_sink(PAMA_PULSE_SOURCE(device));
+	if (!monitored_sink)
+		return;
+
+	/* Disconnected first, so a monitor seen again is not watched twice */
+	g_signal_handlers_disconnect_by_func(monitored_sink, pama_device_menu_monitored_sink_notify, menu);
+	if (watch)
+		g_signal_connect(monitored_sink, "notify::description", G_CALLBACK(pama_device_menu_monitored_sink_notify), menu);
+}
+
+// Sets the label of an item from its device, and moves it to its sorted
+// position if the label has changed.
+static void pama_device_menu_update_item(PamaDeviceMenu *menu, GtkWidget *item)
+{
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(menu);
+	GtkWidget *label = GTK_BIN(item)->child;
+	GObject *device, *labelled = NULL;
+	PamaPulseSink *monitored_sink;
+	gchar *description, *hostname, *name, *text;
+	gboolean network;
+	GList *children, *iter;
+	gint position;
+
+	g_object_get(item, "user-data", &device, NULL);
+
+	if (PAMA_TYPE_PULSE_SOURCE == priv->device_type && (monitored_sink = pama_pulse_source_get_monitored_sink(PAMA_PULSE_SOURCE(device))))
+		labelled = G_OBJECT(monitored_sink);
+
+	g_object_get(labelled ? labelled : device,
+	             "description", &description,
+	             "network",     &network,
+	             "hostname",    &hostname,
+	             NULL);
+
+	if (labelled)
+		name = g_strdup_printf(_("Monitor of %s"), description);
+	else
+		name = g_strdup(description);
+
+	if (network)
+		text = g_markup_printf_escaped("<b>%s</b> (on %s)", name, hostname);
+	else
+		text = g_markup_printf_escaped("<b>%s</b>", name);
+
+	g_free(description);
+	g_free(hostname);
+	g_free(name);
+
+	if (!g_strcmp0(text, g_object_get_data(G_OBJECT(item), "markup")))
+	{
+		g_free(text);
+		return;
+	}
+
+	gtk_label_set_markup(GTK_LABEL(label), text);
+	g_object_set_data_full(G_OBJECT(item), "markup", text, g_free);
+
+	children = gtk_container_get_children(GTK_CONTAINER(menu));
+	position = 1; /* after the hidden item */
+	for (iter = children; iter; iter = iter->next)
+	{
+		GObject *other;
+
+		if (iter->data == item || iter->data == priv->none)
+			continue;
+
+		g_object_get(iter->data, "user-data", &other, NULL);
+		if (pama_device_menu_compare(menu, other, device) <= 0)
+			position++;
+	}
+	g_list_free(children);
+
+	gtk_menu_reorder_child(GTK_MENU(menu), item, position);
+}
+
+static gint pama_device_menu_compare(PamaDeviceMenu *menu, GObject *a, GObject *b)
+{
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(menu);
+	gint result;
+
+	if (PAMA_TYPE_PULSE_SINK == priv->device_type)
+	{
+		result = pama_pulse_sink_compare_by_hostname(a, b);
+		if (result)
+			return result;
+
+		return pama_pulse_sink_compare_by_description(a, b);
+	}
+
+	result = pama_pulse_source_compare_by_is_monitor(a, b);
+	if (result)
+		return result;
+
+	result = pama_pulse_source_compare_by_hostname(a, b);
+	if (result)
+		return result;
+
+	return pama_pulse_source_compare_by_description(a, b);
+}
+
+static void pama_device_menu_device_added(PamaPulseContext *context, guint index, gpointer data)
+{
+	PamaDeviceMenu *menu = PAMA_DEVICE_MENU(data);
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(menu);
+	GObject *device;
+
+	if (PAMA_TYPE_PULSE_SINK == priv->device_type)
+		device = G_OBJECT(pama_pulse_context_get_sink_by_index(context, index));
+	else
+		device = G_OBJECT(pama_pulse_context_get_source_by_index(context, index));
+
+	if (device)
+		pama_device_menu_add_device(menu, device);
+}
+static void pama_device_menu_device_removed(PamaPulseContext *context, guint index, gpointer data)
+{
+	PamaDeviceMenu *menu = PAMA_DEVICE_MENU(data);
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(menu);
+	GtkWidget *item = g_hash_table_lookup(priv->items, GUINT_TO_POINTER(index));
+	GObject *device;
+
+	if (!item)
+		return;
+
+	/* The context only drops its reference after this signal, so the device is still alive */
+	g_object_get(item, "user-data", &device, NULL);
+	g_signal_handlers_disconnect_by_func(device, pama_device_menu_device_notify, menu);
+	pama_device_menu_watch_monitored_sink(menu, device, FALSE);
+
+	g_hash_table_remove(priv->items, GUINT_TO_POINTER(index));
+	gtk_widget_destroy(item);
+}
+static void pama_device_menu_device_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
+{
+	PamaDeviceMenu *menu = PAMA_DEVICE_MENU(data);
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(menu);
+	GtkWidget *item;
+	guint index;
+
+	g_object_get(gobject, "index", &index, NULL);
+	item = g_hash_table_lookup(priv->items, GUINT_TO_POINTER(index));
+
+	if (item)
+		pama_device_menu_update_item(menu, item);
+}
+static void pama_device_menu_sink_added(PamaPulseContext *context, guint index, gpointer data)
+{
+	PamaDeviceMenu *menu = PAMA_DEVICE_MENU(data);
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(menu);
+	PamaPulseSink *sink = pama_pulse_context_get_sink_by_index(context, index);
+	GHashTableIter iter;
+	gpointer item;
+
+	if (!sink)
+		return;
+
+	/* Its monitor may have been listed under its own description until now */
+	g_hash_table_iter_init(&iter, priv->items);
+	while (g_hash_table_iter_next(&iter, NULL, &item))
+	{
+		GObject *device;
+
+		g_object_get(item, "user-data", &device, NULL);
+		if (pama_pulse_source_get_monitored_sink(PAMA_PULSE_SOURCE(device)) != sink)
+			continue;
+
+		pama_device_menu_watch_monitored_sink(menu, device, TRUE);
+		pama_device_menu_update_item(menu, item);
+	}
+}
+static void pama_device_menu_monitored_sink_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
+{
+	PamaDeviceMenu *menu = PAMA_DEVICE_MENU(data);
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(menu);
+	GHashTableIter iter;
+	gpointer item;
+
+	g_hash_table_iter_init(&iter, priv->items);
+	while (g_hash_table_iter_next(&iter, NULL, &item))
+	{
+		GObject *device;
+
+		g_object_get(item, "user-data", &device, NULL);
+		if ((GObject *)pama_pulse_source_get_monitored_sink(PAMA_PULSE_SOURCE(device)) == gobject)
+			pama_device_menu_update_item(menu, item);
+	}
+}
+
+static void pama_device_menu_item_toggled(GtkCheckMenuItem *item, gpointer data)
+{
+	PamaDeviceMenu *menu = PAMA_DEVICE_MENU(data);
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(menu);
+	GObject *device;
+
+	if (priv->updating || !priv->stream || !gtk_check_menu_item_get_active(item))
+		return;
+
+	g_object_get(item, "user-data", &device, NULL);
+
+	if (PAMA_TYPE_PULSE_SINK == priv->device_type)
+		pama_pulse_sink_input_set_sink(PAMA_PULSE_SINK_INPUT(priv->stream), PAMA_PULSE_SINK(device));
+	else
+		pama_pulse_source_output_set_source(PAMA_PULSE_SOURCE_OUTPUT(priv->stream), PAMA_PULSE_SOURCE(device));
+}
+
+// Marks the item of the device with the given index as the active one,
+// without moving any stream to it.
+void pama_device_menu_set_active(PamaDeviceMenu *menu, guint index)
+{
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(menu);
+	GtkWidget *item = g_hash_table_lookup(priv->items, GUINT_TO_POINTER(index));
+
+	/* A device that is not listed yet must not leave another one marked */
+	if (!item)
+		item = priv->none;
+
+	priv->updating = TRUE;
+	gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(item), TRUE);
+	priv->updating = FALSE;
+}
+
+// Pops the menu up to choose the device of a sink input or source output.
+void pama_device_menu_popup(PamaDeviceMenu *menu, GObject *stream)
+{
+	PamaDeviceMenuPrivate *priv = PAMA_DEVICE_MENU_GET_PRIVATE(menu);
+	GObject *device;
+	guint index = PA_INVALID_INDEX;
+
+	if (priv->stream)
+		g_object_remove_weak_pointer(priv->stream, (gpointer *)&priv->stream);
+	priv->stream = stream;
+	g_object_add_weak_pointer(priv->stream, (gpointer *)&priv->stream);
+
+	g_object_get(stream, PAMA_TYPE_PULSE_SINK == priv->device_type ? "sink" : "source", &device, NULL);
+	if (device)
+	{
+		g_object_get(device, "index", &index, NULL);
+		g_object_unref(device);
+	}
+	pama_device_menu_set_active(menu, index);
+
+	gtk_menu_popup(GTK_MENU(menu), NULL, NULL, NULL, NULL, 0, gtk_get_current_event_time());
+}
+
+GtkWidget *pama_device_menu_new(PamaPulseContext *context, GType device_type)
+{
+	return g_object_new(PAMA_TYPE_DEVICE_MENU,
+	                    "context", context,
+	                    "device-type", device_type,
+	                    NULL);
+}
@@ -0,0 +1,62 @@
+/*
+ * pama-device-menu.h: A menu of all sinks or sources, shared by the streams of a popup
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_DEVICE_MENU_H
+#define PAMA_DEVICE_MENU_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+#include "pama-pulse-context.h"
+
+G_BEGIN_DECLS
+
+#define PAMA_TYPE_DEVICE_MENU                  (pama_device_menu_get_type ())
+#define PAMA_DEVICE_MENU(obj)                  (G_TYPE_CHECK_INSTANCE_CAST ((obj), PAMA_TYPE_DEVICE_MENU, PamaDeviceMenu))
+#define PAMA_IS_DEVICE_MENU(obj)               (G_TYPE_CHECK_INSTANCE_TYPE ((obj), PAMA_TYPE_DEVICE_MENU))
+#define PAMA_DEVICE_MENU_CLASS(klass)          (G_TYPE_CHECK_CLASS_CAST ((klass), PAMA_TYPE_DEVICE_MENU, PamaDeviceMenuClass))
+#define PAMA_IS_DEVICE_MENU_CLASS(klass)       (G_TYPE_CHECK_CLASS_TYPE ((klass), PAMA_TYPE_DEVICE_MENU))
+#define PAMA_DEVICE_MENU_GET_CLASS(obj)        (G_TYPE_INSTANCE_GET_CLASS ((obj), PAMA_TYPE_DEVICE_MENU, PamaDeviceMenuClass))
+
+typedef struct _PamaDeviceMenu        PamaDeviceMenu;
+typedef struct _PamaDeviceMenuClass   PamaDeviceMenuClass;
+typedef struct _PamaDeviceMenuPrivate PamaDeviceMenuPrivate;
+
+struct _PamaDeviceMenu
+{
+	GtkMenu parent_instance;
+};
+
+struct _PamaDeviceMenuClass
+{
+	GtkMenuClass parent_class;
+};
+
+GType pama_device_menu_get_type();
+
+/* methods */
+GtkWidget *pama_device_menu_new(PamaPulseContext *context, GType device_type);
+void       pama_device_menu_set_active(PamaDeviceMenu *menu, guint index);
+void       pama_device_menu_popup(PamaDeviceMenu *menu, GObject *stream);
+
+G_END_DECLS
+
+#endif /* PAMA_DEVICE_MENU_H */
+
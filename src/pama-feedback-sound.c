@@ -0,0 +1,245 @@
+/*
+ * pama-feedback-sound.c: Plays a click after volume changes
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+#include <math.h>
+
+#include "pama-feedback-sound.h"
+#include "pama-pulse-context.h"
+#include "widget-settings.h"
+
+/* Volume changes are confirmed with a short click played on the device whose
+ * volume changed, so that it is heard at the new volume. Starting a player
+ * for every change would be far too slow, so the click is uploaded into the
+ * server's sample cache once per connection, and from then on playing it is
+ * a single request.
+ *
+ * Scrolling and dragging change the volume many times a second. Changes are
+ * coalesced, and the click for the last of them played at most once every
+ * WIDGET_FEEDBACK_MIN_INTERVAL milliseconds. */
+
+#define FEEDBACK_SAMPLE_NAME "pama-volume-feedback"
+#define FEEDBACK_RATE        44100
+#define FEEDBACK_DURATION    0.03  /* seconds */
+#define FEEDBACK_FREQUENCY   1500.0
+#define FEEDBACK_DECAY       0.006 /* seconds */
+#define FEEDBACK_AMPLITUDE   0.5
+
+static void     pama_feedback_sound_upload(void);
+static void     pama_feedback_sound_upload_state(pa_stream *s, void *data);
+static void     pama_feedback_sound_upload_write(pa_stream *s, size_t nbytes, void *data);
+static void     pama_feedback_sound_forget_upload(void);
+static gboolean pama_feedback_sound_flush(gpointer data);
+
+static gboolean          enabled   = FALSE;
+static PamaPulseContext *context   = NULL; /* weak, the connection the click belongs to */
+static pa_stream        *upload    = NULL;
+static gint16           *click     = NULL;
+static gsize             click_length  = 0; /* bytes */
+static gsize             click_written = 0; /* bytes */
+static gboolean          uploaded  = FALSE;
+static gboolean          failed    = FALSE;
+static gboolean          pending   = FALSE;
+static gchar            *pending_sink = NULL; /* NULL for the default sink */
+static guint32           pending_volume = PA_VOLUME_NORM;
+static GTimer           *last_click   = NULL;
+static guint             flush_source_id = 0;
+
+// A decaying sine, short enough not to get in the way of fast scrolling.
+static void pama_feedback_sound_upload(void)
+{
+	pa_sample_spec spec;
+	pa_context *c;
+	gsize i, n_samples;
+
+	g_object_get(context, "context", &c, NULL);
+	if (NULL == c || PA_CONTEXT_READY != pa_context_get_state(c))
+		return;
+
+	n_samples = FEEDBACK_RATE * FEEDBACK_DURATION;
+	if (NULL == click)
+	{
+		click = g_new(gint16, n_samples);
+		for (i = 0; i < n_samples; i++)
+		{
+			double t = (double) i / FEEDBACK_RATE;
+			click[i] = 32767 * FEEDBACK_AMPLITUDE * exp(-t / FEEDBACK_DECAY) * sin(2 * G_PI * FEEDBACK_FREQUENCY * t);
+		}
+	}
+	click_length  = n_samples * sizeof(gint16);
+	click_written = 0;
+
+	spec.format   = PA_SAMPLE_S16NE;
+	spec.rate     = FEEDBACK_RATE;
+	spec.channels = 1;
+
+	upload = pa_stream_new(c, FEEDBACK_SAMPLE_NAME, &spec, NULL);
+	if (NULL == upload)
+	{
+		failed = TRUE;
+		return;
+	}
+
+	pa_stream_set_state_callback(upload, pama_feedback_sound_upload_state, NULL);
+	pa_stream_set_write_callback(upload, pama_feedback_sound_upload_write, NULL);
+	if (pa_stream_connect_upload(upload, click_length) < 0)
+	{
+		g_warning("Uploading the volume feedback sound failed: %s", pa_strerror(pa_context_errno(c)));
+		pama_feedback_sound_forget_upload();
+		failed = TRUE;
+	}
+}
+static void pama_feedback_sound_upload_write(pa_stream *s, size_t nbytes, void *data)
+{
+	gsize length = MIN(nbytes, click_length - click_written);
+
+	pa_stream_write(s, (guint8 *) click + click_written, length, NULL, 0, PA_SEEK_RELATIVE);
+	click_written += length;
+
+	if (click_written < click_length)
+		return;
+
+	pa_stream_set_write_callback(s, NULL, NULL);
+	pa_stream_finish_upload(s);
+}
+// The upload stream terminates once the sample is in the cache.
+static void pama_feedback_sound_upload_state(pa_stream *s, void *data)
+{
+	switch (pa_stream_get_state(s))
+	{
+		case PA_STREAM_TERMINATED:
+			uploaded = TRUE;
+			pama_feedback_sound_forget_upload();
+
+			if (pending && 0 == flush_source_id)
+				flush_source_id = g_timeout_add(0, pama_feedback_sound_flush, NULL);
+			break;
+
+		case PA_STREAM_FAILED:
+			g_warning("Uploading the volume feedback sound failed: %s", pa_strerror(pa_context_errno(pa_stream_get_context(s))));
+			failed = TRUE;
+			pama_feedback_sound_forget_upload();
+			break;
+
+		default:
+			break;
+	}
+}
+static void pama_feedback_sound_forget_upload(void)
+{
+	if (NULL == upload)
+		return;
+
+	pa_stream_set_state_callback(upload, NULL, NULL);
+	pa_stream_set_write_callback(upload, NULL, NULL);
+	pa_stream_unref(upload);
+	upload = NULL;
+}
+static gboolean pama_feedback_sound_flush(gpointer data)
+{
+	pa_operation *o;
+	pa_context *c;
+
+	flush_source_id = 0;
+
+	/* Played once the upload has finished */
+	if (NULL == context || !uploaded)
+		return FALSE;
+
+	g_object_get(context, "context", &c, NULL);
+	if (c && PA_CONTEXT_READY == pa_context_get_state(c))
+	{
+		o = pa_context_play_sample(c, FEEDBACK_SAMPLE_NAME, pending_sink, pending_volume, NULL, NULL);
+		if (o)
+			pa_operation_unref(o);
+	}
+
+	g_timer_start(last_click);
+	g_free(pending_sink);
+	pending_sink = NULL;
+	pending = FALSE;
+
+	return FALSE;
+}
+
+
+void pama_feedback_sound_set_enabled(gboolean new_enabled)
+{
+	enabled = new_enabled;
+}
+gboolean pama_feedback_sound_get_enabled(void)
+{
+	return enabled;
+}
+
+// Asks for a click on the sink, or on the default sink if NULL, after a
+// volume was changed. The click is played at the given volume on top of the
+// sink's: PA_VOLUME_NORM for the sink itself, or a stream's new volume, so
+// that it sounds as loud as that stream. Clicks for changes in quick
+// succession are merged, and the last one's sink and volume win.
+void pama_feedback_sound_play(PamaPulseContext *new_context, PamaPulseSink *sink, const guint32 volume)
+{
+	gdouble elapsed;
+
+	if (!enabled || NULL == new_context)
+		return;
+
+	/* Every connection has a sample cache of its own */
+	if (new_context != context)
+	{
+		if (context)
+			g_object_remove_weak_pointer(G_OBJECT(context), (gpointer *)&context);
+		context = new_context;
+		g_object_add_weak_pointer(G_OBJECT(context), (gpointer *)&context);
+
+		pama_feedback_sound_forget_upload();
+		uploaded = FALSE;
+		failed   = FALSE;
+	}
+
+	if (!uploaded && !failed && NULL == upload)
+		pama_feedback_sound_upload();
+	if (failed)
+		return;
+
+	g_free(pending_sink);
+	pending_sink = NULL;
+	if (sink)
+		g_object_get(sink, "name", &pending_sink, NULL);
+	pending_volume = volume;
+	pending = TRUE;
+
+	if (flush_source_id)
+		return;
+
+	if (NULL == last_click)
+	{
+		last_click = g_timer_new();
+		elapsed = WIDGET_FEEDBACK_MIN_INTERVAL;
+	}
+	else
+		elapsed = g_timer_elapsed(last_click, NULL) * 1000.0;
+
+	flush_source_id = g_timeout_add(MAX(0, WIDGET_FEEDBACK_MIN_INTERVAL - elapsed), pama_feedback_sound_flush, NULL);
+}
@@ -0,0 +1,38 @@
+/*
+ * pama-feedback-sound.h: Plays a click after volume changes
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+ 
+#ifndef PAMA_FEEDBACK_SOUND_H
+#define PAMA_FEEDBACK_SOUND_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include "pama-pulse-context.h"
+
+G_BEGIN_DECLS
+
+void     pama_feedback_sound_set_enabled(gboolean enabled);
+gboolean pama_feedback_sound_get_enabled(void);
+
+void     pama_feedback_sound_play(PamaPulseContext *context, PamaPulseSink *sink, const guint32 volume);
+
+G_END_DECLS
+
+#endif /* PAMA_FEEDBACK_SOUND_H */
@@ -0,0 +1,209 @@
+/*
+ * pama-fft.c: Windowed real FFT for the spectrum view
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+#include <math.h>
+
+#include "pama-fft.h"
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+/* A real FFT of size N packs the even samples into the real parts and the odd
+ * samples into the imaginary parts of N/2 complex points, transforms those,
+ * and separates the two halves again in a last pass. The complex transform is
+ * an iterative radix-2 one on split real and imaginary arrays. Every stage has
+ * its twiddle factors laid out one after the other, so from the third stage on
+ * the butterflies of a group read consecutive data and consecutive twiddles,
+ * and SSE2 does four of them at once. Everything that only depends on N, the
+ * window included, is worked out when the FFT is created. */
+
+struct _PamaFft
+{
+	guint   size, half;
+	guint  *bitrev;        /* half entries */
+	gfloat *window;        /* size entries, Hann */
+	gfloat *twiddle_re;    /* half - 1 entries: stage with span m starts at m - 1 */
+	gfloat *twiddle_im;
+	gfloat *split_re;      /* half entries: e^(-2πik/size), for the last pass */
+	gfloat *split_im;
+	gfloat *re, *im;       /* half entries each, the work area */
+	gfloat  scale;         /* turns power into dB relative to a full scale sine */
+};
+
+static void pama_fft_transform(PamaFft *fft);
+
+static void pama_fft_transform(PamaFft *fft)
+{
+	gfloat *re = fft->re, *im = fft->im;
+	guint   m, k, j;
+
+	for (m = 1; m < fft->half; m <<= 1)
+	{
+		const gfloat *wr = fft->twiddle_re + m - 1;
+		const gfloat *wi = fft->twiddle_im + m - 1;
+
+		for (k = 0; k < fft->half; k += 2 * m)
+		{
+			gfloat *ar = re + k, *ai = im + k;
+			gfloat *br = re + k + m, *bi = im + k + m;
+
+			j = 0;
+#ifdef __SSE2__
+			for (; j + 4 <= m; j += 4)
+			{
+				__m128 xr = _mm_loadu_ps(br + j), xi = _mm_loadu_ps(bi + j);
+				__m128 cr = _mm_loadu_ps(wr + j), ci = _mm_loadu_ps(wi + j);
+				__m128 tr = _mm_sub_ps(_mm_mul_ps(xr, cr), _mm_mul_ps(xi, ci));
+				__m128 ti = _mm_add_ps(_mm_mul_ps(xr, ci), _mm_mul_ps(xi, cr));
+				__m128 yr = _mm_loadu_ps(ar + j), yi = _mm_loadu_ps(ai + j);
+
+				_mm_storeu_ps(br + j, _mm_sub_ps(yr, tr));
+				_mm_storeu_ps(bi + j, _mm_sub_ps(yi, ti));
+				_mm_storeu_ps(ar + j, _mm_add_ps(yr, tr));
+				_mm_storeu_ps(ai + j, _mm_add_ps(yi, ti));
+			}
+#endif
+			for (; j < m; j++)
+			{
+				gfloat tr = br[j] * wr[j] - bi[j] * wi[j];
+				gfloat ti = br[j] * wi[j] + bi[j] * wr[j];
+
+				br[j] = ar[j] - tr;
+				bi[j] = ai[j] - ti;
+				ar[j] += tr;
+				ai[j] += ti;
+			}
+		}
+	}
+}
+
+
+// Creates an FFT of size samples, which must be a power of two of at least 4.
+PamaFft *pama_fft_new(guint size)
+{
+	PamaFft *fft;
+	guint    bits, i, j, m;
+
+	g_return_val_if_fail(size >= 4 && 0 == (size & (size - 1)), NULL);
+
+	fft = g_new0(PamaFft, 1);
+	fft->size = size;
+	fft->half = size / 2;
+
+	fft->bitrev     = g_new(guint,  fft->half);
+	fft->window     = g_new(gfloat, size);
+	fft->twiddle_re = g_new(gfloat, fft->half);
+	fft->twiddle_im = g_new(gfloat, fft->half);
+	fft->split_re   = g_new(gfloat, fft->half);
+	fft->split_im   = g_new(gfloat, fft->half);
+	fft->re         = g_new(gfloat, fft->half);
+	fft->im         = g_new(gfloat, fft->half);
+
+	for (bits = 0; (1u << bits) < fft->half; bits++)
+		;
+	for (i = 0; i < fft->half; i++)
+	{
+		for (j = 0, m = 0; m < bits; m++)
+			j |= ((i >> m) & 1) << (bits - 1 - m);
+		fft->bitrev[i] = j;
+	}
+
+	for (i = 0; i < size; i++)
+		fft->window[i] = 0.5 - 0.5 * cos(2.0 * G_PI * i / size);
+
+	for (m = 1; m < fft->half; m <<= 1)
+	{
+		for (j = 0; j < m; j++)
+		{
+			fft->twiddle_re[m - 1 + j] =  cos(G_PI * j / m);
+			fft->twiddle_im[m - 1 + j] = -sin(G_PI * j / m);
+		}
+	}
+
+	for (i = 0; i < fft->half; i++)
+	{
+		fft->split_re[i] =  cos(2.0 * G_PI * i / size);
+		fft->split_im[i] = -sin(2.0 * G_PI * i / size);
+	}
+
+	/* A full scale sine through a Hann window peaks at size / 4 */
+	fft->scale = 16.0 / ((gdouble) size * size);
+
+	return fft;
+}
+
+void pama_fft_free(PamaFft *fft)
+{
+	if (NULL == fft)
+		return;
+
+	g_free(fft->bitrev);
+	g_free(fft->window);
+	g_free(fft->twiddle_re);
+	g_free(fft->twiddle_im);
+	g_free(fft->split_re);
+	g_free(fft->split_im);
+	g_free(fft->re);
+	g_free(fft->im);
+	g_free(fft);
+}
+
+guint pama_fft_get_size(const PamaFft *fft)
+{
+	return fft->size;
+}
+
+// Windows size samples and writes the level of each of the size / 2 + 1
+// frequencies from 0 to the Nyquist frequency to levels, in dB relative to a
+// full scale sine.
+void pama_fft_spectrum(PamaFft *fft, const gfloat *samples, gfloat *levels)
+{
+	guint i, k;
+
+	for (i = 0; i < fft->half; i++)
+	{
+		guint r = fft->bitrev[i];
+
+		fft->re[r] = samples[2 * i]     * fft->window[2 * i];
+		fft->im[r] = samples[2 * i + 1] * fft->window[2 * i + 1];
+	}
+
+	pama_fft_transform(fft);
+
+	for (k = 0; k <= fft->half; k++)
+	{
+		guint  a = k % fft->half, b = (fft->half - k) % fft->half;
+		gfloat zr = fft->re[a], zi = fft->im[a];
+		gfloat cr = fft->re[b], ci = -fft->im[b];
+		gfloat even_r = 0.5f * (zr + cr), even_i = 0.5f * (zi + ci); /* transform of the even samples */
+		gfloat odd_r  = 0.5f * (zi - ci), odd_i  = 0.5f * (cr - zr); /* and of the odd ones */
+		gfloat wr = k < fft->half ? fft->split_re[k] : -1.0f;
+		gfloat wi = k < fft->half ? fft->split_im[k] :  0.0f;
+		gfloat xr = even_r + odd_r * wr - odd_i * wi;
+		gfloat xi = even_i + odd_r * wi + odd_i * wr;
+
+		levels[k] = 10.0f * log10f((xr * xr + xi * xi) * fft->scale + 1e-20f);
+	}
+}
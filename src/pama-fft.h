@@ -0,0 +1,37 @@
+/*
+ * pama-fft.h: Windowed real FFT for the spectrum view
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_FFT_H
+#define PAMA_FFT_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _PamaFft PamaFft;
+
+PamaFft *pama_fft_new (guint size);
+void     pama_fft_free(PamaFft *fft);
+guint    pama_fft_get_size(const PamaFft *fft);
+void     pama_fft_spectrum(PamaFft *fft, const gfloat *samples, gfloat *levels);
+
+G_END_DECLS
+
+#endif /* PAMA_FFT_H */
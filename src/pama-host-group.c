@@ -0,0 +1,355 @@
+/*
+ * pama-host-group.c: A collapsible group of the devices or streams of one remote host
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+#include <string.h>
+
+#include "pama-host-group.h"
+
+static void     pama_host_group_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec);
+static GObject* pama_host_group_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties);
+static void     pama_host_group_dispose(GObject *gobject);
+static void     pama_host_group_finalize(GObject *gobject);
+static void     pama_host_group_member_weak_ref_notify(gpointer data, GObject *where_the_object_was);
+
+static void     pama_host_group_expanded(GObject *gobject, GParamSpec *pspec, gpointer data);
+static void     pama_host_group_build_member(PamaHostGroup *group, GObject *object);
+static void     pama_host_group_update_label(PamaHostGroup *group);
+
+struct _PamaHostGroupPrivate
+{
+	gchar *hostname;
+	GtkWidget *label, *box;
+
+	PamaHostGroupBuildFunc build_func;
+	GCompareFunc compare_func;
+	gpointer data;
+
+	/* Every member has a weak reference; widgets exist only once the group has been expanded */
+	GSList *members;
+	gboolean built;
+};
+
+G_DEFINE_TYPE(PamaHostGroup, pama_host_group, GTK_TYPE_EXPANDER);
+#define PAMA_HOST_GROUP_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE((obj), PAMA_TYPE_HOST_GROUP, PamaHostGroupPrivate))
+
+enum
+{
+	PROP_0,
+
+	PROP_HOSTNAME,
+	PROP_BUILD_FUNC,
+	PROP_COMPARE_FUNC,
+	PROP_DATA
+};
+
+static void pama_host_group_class_init(PamaHostGroupClass *klass)
+{
+	GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+	GParamSpec *pspec;
+
+	gobject_class->set_property = pama_host_group_set_property;
+	gobject_class->constructor  = pama_host_group_constructor;
+	gobject_class->dispose      = pama_host_group_dispose;
+	gobject_class->finalize     = pama_host_group_finalize;
+
+	pspec = g_param_spec_string("hostname",
+	                            "Host name",
+	                            "The remote host whose devices or streams are grouped.",
+	                            "",
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_HOSTNAME, pspec);
+
+	pspec = g_param_spec_pointer("build-func",
+	                             "Build function",
+	                             "The PamaHostGroupBuildFunc creating the widget of a member.",
+	                             G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_BUILD_FUNC, pspec);
+
+	pspec = g_param_spec_pointer("compare-func",
+	                             "Compare function",
+	                             "The GCompareFunc ordering the widgets of the members.",
+	                             G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_COMPARE_FUNC, pspec);
+
+	pspec = g_param_spec_pointer("data",
+	                             "Build function data",
+	                             "User data passed to the build function.",
+	                             G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_DATA, pspec);
+
+	g_type_class_add_private(klass, sizeof(PamaHostGroupPrivate));
+}
+
+static void pama_host_group_init(PamaHostGroup *group)
+{
+}
+
+static void pama_host_group_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec)
+{
+	PamaHostGroup *group = PAMA_HOST_GROUP(gobject);
+	PamaHostGroupPrivate *priv = PAMA_HOST_GROUP_GET_PRIVATE(group);
+
+	switch(property_id)
+	{
+		case PROP_HOSTNAME:
+			g_free(priv->hostname);
+			priv->hostname = g_value_dup_string(value);
+			break;
+
+		case PROP_BUILD_FUNC:
+			priv->build_func = g_value_get_pointer(value);
+			break;
+
+		case PROP_COMPARE_FUNC:
+			priv->compare_func = g_value_get_pointer(value);
+			break;
+
+		case PROP_DATA:
+			priv->data = g_value_get_pointer(value);
+			break;
+
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
+			break;
+	}
+}
+
+static GObject* pama_host_group_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties)
+{
+	GObject *gobject = G_OBJECT_CLASS(pama_host_group_parent_class)->constructor(gtype, n_properties, properties);
+	PamaHostGroup *group = PAMA_HOST_GROUP(gobject);
+	PamaHostGroupPrivate *priv = PAMA_HOST_GROUP_GET_PRIVATE(group);
+	GtkWidget *label, *alignment, *box;
+
+	if (NULL == priv->build_func)
+		g_error("An attempt was made to construct a PamaHostGroup without providing a build function.");
+
+	label = g_object_new(GTK_TYPE_LABEL,
+	                     "ellipsize", PANGO_ELLIPSIZE_MIDDLE,
+	                     "xalign", 0.0,
+	                     "use-markup", TRUE,
+	                     NULL);
+	gtk_expander_set_label_widget(GTK_EXPANDER(group), label);
+	priv->label = label;
+
+	alignment = gtk_alignment_new(0, 0, 1, 0);
+	gtk_alignment_set_padding(GTK_ALIGNMENT(alignment), 6, 0, 12, 0);
+	gtk_container_add(GTK_CONTAINER(group), alignment);
+
+	box = gtk_vbox_new(FALSE, 6);
+	gtk_container_add(GTK_CONTAINER(alignment), box);
+	priv->box = box;
+
+	pama_host_group_update_label(group);
+	g_signal_connect(group, "notify::expanded", G_CALLBACK(pama_host_group_expanded), NULL);
+
+	return gobject;
+}
+static void pama_host_group_dispose(GObject *gobject)
+{
+	PamaHostGroup *group = PAMA_HOST_GROUP(gobject);
+	PamaHostGroupPrivate *priv = PAMA_HOST_GROUP_GET_PRIVATE(group);
+	GSList *iter;
+
+	for (iter = priv->members; iter; iter = iter->next)
+		g_object_weak_unref(G_OBJECT(iter->data), pama_host_group_member_weak_ref_notify, group);
+	g_slist_free(priv->members);
+	priv->members = NULL;
+
+	G_OBJECT_CLASS(pama_host_group_parent_class)->dispose(gobject);
+}
+static void pama_host_group_finalize(GObject *gobject)
+{
+	PamaHostGroupPrivate *priv = PAMA_HOST_GROUP_GET_PRIVATE(gobject);
+
+	g_free(priv->hostname);
+
+	G_OBJECT_CLASS(pama_host_group_parent_class)->finalize(gobject);
+}
+static void pama_host_group_member_weak_ref_notify(gpointer data, GObject *where_the_object_was)
+{
+	PamaHostGroup *group = PAMA_HOST_GROUP(data);
+	PamaHostGroupPrivate *priv = PAMA_HOST_GROUP_GET_PRIVATE(group);
+
+	/* A built member's widget holds its own weak reference, and goes away by itself */
+	priv->members = g_slist_remove(priv->members, where_the_object_was);
+
+	if (priv->members)
+		pama_host_group_update_label(group);
+	else
+		gtk_object_destroy(GTK_OBJECT(group));
+}
+
+static void pama_host_group_update_label(PamaHostGroup *group)
+{
+	PamaHostGroupPrivate *priv = PAMA_HOST_GROUP_GET_PRIVATE(group);
+	gchar *markup;
+
+	markup = g_markup_printf_escaped("<i>%s</i> (%u)", priv->hostname, g_slist_length(priv->members));
+	gtk_label_set_markup(GTK_LABEL(priv->label), markup);
+	g_free(markup);
+}
+
+static void pama_host_group_expanded(GObject *gobject, GParamSpec *pspec, gpointer data)
+{
+	PamaHostGroup *group = PAMA_HOST_GROUP(gobject);
+	PamaHostGroupPrivate *priv = PAMA_HOST_GROUP_GET_PRIVATE(group);
+	GSList *iter;
+
+	if (priv->built || !gtk_expander_get_expanded(GTK_EXPANDER(group)))
+		return;
+
+	/* Collapsing again keeps the widgets, which stop updating while unmapped */
+	priv->built = TRUE;
+	for (iter = priv->members; iter; iter = iter->next)
+		pama_host_group_build_member(group, G_OBJECT(iter->data));
+
+	pama_host_group_reorder(group);
+}
+
+static void pama_host_group_build_member(PamaHostGroup *group, GObject *object)
+{
+	PamaHostGroupPrivate *priv = PAMA_HOST_GROUP_GET_PRIVATE(group);
+	GtkWidget *widget = priv->build_func(object, priv->data);
+
+	/* Remembered so the member can be taken out again without its object going away */
+	g_object_set_data(G_OBJECT(widget), "pama-host-group-member", object);
+
+	/* The widget is shown by the build function, which may keep it hidden */
+	gtk_box_pack_start(GTK_BOX(priv->box), widget, FALSE, FALSE, 0);
+	gtk_widget_show(priv->box);
+
+	if (g_signal_lookup("reorder-request", G_OBJECT_TYPE(widget)))
+		g_signal_connect_swapped(widget, "reorder-request", G_CALLBACK(pama_host_group_reorder), group);
+}
+
+void pama_host_group_add(PamaHostGroup *group, GObject *object)
+{
+	PamaHostGroupPrivate *priv = PAMA_HOST_GROUP_GET_PRIVATE(group);
+
+	if (g_slist_find(priv->members, object))
+		return;
+
+	priv->members = g_slist_append(priv->members, object);
+	g_object_weak_ref(object, pama_host_group_member_weak_ref_notify, group);
+	pama_host_group_update_label(group);
+
+	if (priv->built)
+	{
+		pama_host_group_build_member(group, object);
+		pama_host_group_reorder(group);
+	}
+}
+
+// Takes a member out of the group, destroying its widget if it was built, and
+// the group itself if it was the last. Returns FALSE if it was no member.
+gboolean pama_host_group_remove(PamaHostGroup *group, GObject *object)
+{
+	PamaHostGroupPrivate *priv = PAMA_HOST_GROUP_GET_PRIVATE(group);
+	GList *children, *iter;
+
+	if (!g_slist_find(priv->members, object))
+		return FALSE;
+
+	children = gtk_container_get_children(GTK_CONTAINER(priv->box));
+	for (iter = children; iter; iter = iter->next)
+	{
+		if (g_object_get_data(G_OBJECT(iter->data), "pama-host-group-member") == object)
+			gtk_widget_destroy(GTK_WIDGET(iter->data));
+	}
+	g_list_free(children);
+
+	g_object_weak_unref(object, pama_host_group_member_weak_ref_notify, group);
+	pama_host_group_member_weak_ref_notify(group, object);
+	return TRUE;
+}
+
+static gint pama_host_group_reorder__compare(gconstpointer a, gconstpointer b, gpointer data)
+{
+	const GtkBoxChild *A = a, *B = b;
+	GCompareFunc compare_func = data;
+
+	return compare_func(A->widget, B->widget);
+}
+void pama_host_group_reorder(PamaHostGroup *group)
+{
+	PamaHostGroupPrivate *priv = PAMA_HOST_GROUP_GET_PRIVATE(group);
+	GList *children, *iter;
+	guint position;
+
+	if (!priv->compare_func)
+		return;
+
+	children = g_list_copy(GTK_BOX(priv->box)->children);
+	children = g_list_sort_with_data(children, pama_host_group_reorder__compare, priv->compare_func);
+
+	for (iter = children, position = 0; iter; iter = iter->next, position++)
+	{
+		GtkBoxChild *child = iter->data;
+		gtk_box_reorder_child(GTK_BOX(priv->box), child->widget, position);
+	}
+
+	g_list_free(children);
+}
+
+const gchar *pama_host_group_get_hostname(PamaHostGroup *group)
+{
+	PamaHostGroupPrivate *priv = PAMA_HOST_GROUP_GET_PRIVATE(group);
+
+	return priv->hostname;
+}
+// Returns the objects in the group. The list belongs to the group.
+GSList *pama_host_group_get_members(PamaHostGroup *group)
+{
+	PamaHostGroupPrivate *priv = PAMA_HOST_GROUP_GET_PRIVATE(group);
+
+	return priv->members;
+}
+// Returns the box holding the members' widgets, which is empty until the
+// group has been expanded once.
+GtkBox *pama_host_group_get_box(PamaHostGroup *group)
+{
+	PamaHostGroupPrivate *priv = PAMA_HOST_GROUP_GET_PRIVATE(group);
+
+	return GTK_BOX(priv->box);
+}
+
+gint pama_host_group_compare(gconstpointer a, gconstpointer b)
+{
+	PamaHostGroupPrivate *A = PAMA_HOST_GROUP_GET_PRIVATE(a);
+	PamaHostGroupPrivate *B = PAMA_HOST_GROUP_GET_PRIVATE(b);
+
+	return strcmp(A->hostname, B->hostname);
+}
+
+GtkWidget *pama_host_group_new(const gchar *hostname, PamaHostGroupBuildFunc build_func, GCompareFunc compare_func, gpointer data)
+{
+	return g_object_new(PAMA_TYPE_HOST_GROUP,
+	                    "hostname", hostname,
+	                    "build-func", build_func,
+	                    "compare-func", compare_func,
+	                    "data", data,
+	                    NULL);
+}
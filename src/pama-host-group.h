@@ -0,0 +1,69 @@
+/*
+ * pama-host-group.h: A collapsible group of the devices or streams of one remote host
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_HOST_GROUP_H
+#define PAMA_HOST_GROUP_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+#define PAMA_TYPE_HOST_GROUP                  (pama_host_group_get_type ())
+#define PAMA_HOST_GROUP(obj)                  (G_TYPE_CHECK_INSTANCE_CAST ((obj), PAMA_TYPE_HOST_GROUP, PamaHostGroup))
+#define PAMA_IS_HOST_GROUP(obj)               (G_TYPE_CHECK_INSTANCE_TYPE ((obj), PAMA_TYPE_HOST_GROUP))
+#define PAMA_HOST_GROUP_CLASS(klass)          (G_TYPE_CHECK_CLASS_CAST ((klass), PAMA_TYPE_HOST_GROUP, PamaHostGroupClass))
+#define PAMA_IS_HOST_GROUP_CLASS(klass)       (G_TYPE_CHECK_CLASS_TYPE ((klass), PAMA_TYPE_HOST_GROUP))
+#define PAMA_HOST_GROUP_GET_CLASS(obj)        (G_TYPE_INSTANCE_GET_CLASS ((obj), PAMA_TYPE_HOST_GROUP, PamaHostGroupClass))
+
+typedef struct _PamaHostGroup        PamaHostGroup;
+typedef struct _PamaHostGroupClass   PamaHostGroupClass;
+typedef struct _PamaHostGroupPrivate PamaHostGroupPrivate;
+
+struct _PamaHostGroup
+{
+	GtkExpander parent_instance;
+};
+
+struct _PamaHostGroupClass
+{
+	GtkExpanderClass parent_class;
+};
+
+/* Creates the widget of a member; called the first time the group is expanded */
+typedef GtkWidget *(*PamaHostGroupBuildFunc)(GObject *object, gpointer data);
+
+GType pama_host_group_get_type();
+
+/* methods */
+GtkWidget   *pama_host_group_new(const gchar *hostname, PamaHostGroupBuildFunc build_func, GCompareFunc compare_func, gpointer data);
+void         pama_host_group_add(PamaHostGroup *group, GObject *object);
+gboolean     pama_host_group_remove(PamaHostGroup *group, GObject *object);
+const gchar *pama_host_group_get_hostname(PamaHostGroup *group);
+GSList      *pama_host_group_get_members(PamaHostGroup *group);
+GtkBox      *pama_host_group_get_box(PamaHostGroup *group);
+void         pama_host_group_reorder(PamaHostGroup *group);
+gint         pama_host_group_compare(gconstpointer a, gconstpointer b);
+
+G_END_DECLS
+
+#endif /* PAMA_HOST_GROUP_H */
+
@@ -0,0 +1,399 @@
+/*
+ * pama-icon-cache.c: Shared GIcons and pixbufs for device and stream icons
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+#include <string.h>
+
+#include "pama-icon-cache.h"
+#include "widget-settings.h"
+
+/* Every widget asks for the same handful of icons over and over, on every
+ * property change of its device or stream. GIcons are shared by name and
+ * network emblem, so an icon that did not change is the very same object;
+ * pixbufs are shared by icon and size, and only loaded from the theme once
+ * until the theme changes. Images set through pama_icon_cache_set_image()
+ * are reloaded when it does.
+ *
+ * Decoding an icon file is by far the slowest part of building a popup full
+ * of applications, so plain themed icons are only looked up in the theme on
+ * the main thread and their files are decoded by a worker thread. Images show
+ * the fallback icon until the decoded pixbuf arrives back on the main loop,
+ * and keep it if the icon cannot be loaded at all.
+ * Emblemed icons need the theme to composite them and are still loaded in
+ * place. */
+
+typedef struct
+{
+	GIcon *icon;
+	gint   size;
+} PamaIconCacheKey;
+
+typedef struct
+{
+	PamaIconCacheKey *key;
+	gchar            *filename;
+	GdkPixbuf        *pixbuf;
+	guint             generation;
+} PamaIconCacheJob;
+
+static void     pama_icon_cache_init(void);
+static guint    pama_icon_cache_key_hash(gconstpointer key);
+static gboolean pama_icon_cache_key_equal(gconstpointer a, gconstpointer b);
+static void     pama_icon_cache_key_free(gpointer key);
+static void     pama_icon_cache_pixbuf_free(gpointer pixbuf);
+static void     pama_icon_cache_theme_changed(GtkIconTheme *icon_theme, gpointer data);
+static void     pama_icon_cache_image_weak_ref_notify(gpointer data, GObject *where_the_object_was);
+static gboolean pama_icon_cache_load_async(GIcon *icon, gint size);
+static void     pama_icon_cache_decode(gpointer data, gpointer user_data);
+static gboolean pama_icon_cache_decoded(gpointer data);
+static gboolean pama_icon_cache_prefetch_idle(gpointer data);
+static void     pama_icon_cache_show(GtkImage *image, GIcon *icon, gint size);
+
+static GHashTable *gicons  = NULL; /* "network:icon-name" -> GIcon */
+static GHashTable *pixbufs = NULL; /* PamaIconCacheKey -> GdkPixbuf, or NULL when the theme has no such icon */
+static GSList     *images  = NULL; /* GtkImages showing a cached pixbuf */
+static GHashTable *pending = NULL; /* PamaIconCacheKey -> TRUE while a worker is decoding it */
+static GSList     *prefetch = NULL; /* icon names waiting for the prefetch idle */
+static GThreadPool *decoder = NULL;
+static guint       generation = 0; /* bumped on theme changes, so stale decodes are dropped */
+
+static void pama_icon_cache_init(void)
+{
+	if (gicons)
+		return;
+
+	gicons  = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_object_unref);
+	pixbufs = g_hash_table_new_full(pama_icon_cache_key_hash, pama_icon_cache_key_equal, pama_icon_cache_key_free, pama_icon_cache_pixbuf_free);
+	pending = g_hash_table_new_full(pama_icon_cache_key_hash, pama_icon_cache_key_equal, pama_icon_cache_key_free, NULL);
+
+	if (g_thread_supported())
+		decoder = g_thread_pool_new(pama_icon_cache_decode, NULL, 1, FALSE, NULL);
+
+	g_signal_connect(gtk_icon_theme_get_default(), "changed", G_CALLBACK(pama_icon_cache_theme_changed), NULL);
+}
+
+static guint pama_icon_cache_key_hash(gconstpointer key)
+{
+	const PamaIconCacheKey *k = key;
+
+	return g_icon_hash((gpointer) k->icon) ^ (guint) k->size;
+}
+static gboolean pama_icon_cache_key_equal(gconstpointer a, gconstpointer b)
+{
+	const PamaIconCacheKey *A = a, *B = b;
+
+	return A->size == B->size && g_icon_equal(A->icon, B->icon);
+}
+static void pama_icon_cache_key_free(gpointer key)
+{
+	PamaIconCacheKey *k = key;
+
+	g_object_unref(k->icon);
+	g_slice_free(PamaIconCacheKey, k);
+}
+static void pama_icon_cache_pixbuf_free(gpointer pixbuf)
+{
+	if (pixbuf)
+		g_object_unref(pixbuf);
+}
+
+static void pama_icon_cache_theme_changed(GtkIconTheme *icon_theme, gpointer data)
+{
+	GSList *iter;
+
+	generation++;
+	g_hash_table_remove_all(pixbufs);
+	g_hash_table_remove_all(pending);
+
+	for (iter = images; iter; iter = iter->next)
+	{
+		GtkImage *image = GTK_IMAGE(iter->data);
+
+		pama_icon_cache_show(image,
+		                     g_object_get_data(G_OBJECT(image), "pama-icon"),
+		                     GPOINTER_TO_INT(g_object_get_data(G_OBJECT(image), "pama-icon-size")));
+	}
+}
+static void pama_icon_cache_image_weak_ref_notify(gpointer data, GObject *where_the_object_was)
+{
+	images = g_slist_remove(images, where_the_object_was);
+}
+
+// Queues the icon to be decoded by the worker, if it is a plain themed icon
+// backed by a file. Returns TRUE if the pixbuf will arrive later.
+static gboolean pama_icon_cache_load_async(GIcon *icon, gint size)
+{
+	PamaIconCacheKey lookup = { icon, size };
+	PamaIconCacheJob *job;
+	GtkIconInfo *info;
+	const gchar *filename;
+
+	if (g_hash_table_lookup(pending, &lookup))
+		return TRUE;
+
+	if (!decoder || !G_IS_THEMED_ICON(icon))
+		return FALSE;
+
+	info = gtk_icon_theme_lookup_by_gicon(gtk_icon_theme_get_default(), icon, size, GTK_ICON_LOOKUP_USE_BUILTIN | GTK_ICON_LOOKUP_FORCE_SIZE);
+	if (!info)
+		return FALSE;
+
+	filename = gtk_icon_info_get_filename(info);
+	if (!filename)
+	{
+		// Builtin icons are already in memory
+		gtk_icon_info_free(info);
+		return FALSE;
+	}
+
+	job = g_slice_new0(PamaIconCacheJob);
+	job->key = g_slice_new(PamaIconCacheKey);
+	job->key->icon = g_object_ref(icon);
+	job->key->size = size;
+	job->filename = g_strdup(filename);
+	job->generation = generation;
+	gtk_icon_info_free(info);
+
+	lookup.icon = g_object_ref(icon);
+	g_hash_table_insert(pending, g_slice_dup(PamaIconCacheKey, &lookup), GINT_TO_POINTER(TRUE));
+
+	g_thread_pool_push(decoder, job, NULL);
+	return TRUE;
+}
+
+// Runs in the worker thread. Only touches the job itself.
+static void pama_icon_cache_decode(gpointer data, gpointer user_data)
+{
+	PamaIconCacheJob *job = data;
+
+	job->pixbuf = gdk_pixbuf_new_from_file_at_size(job->filename, job->key->size, job->key->size, NULL);
+	g_idle_add(pama_icon_cache_decoded, job);
+}
+
+// Runs on the main loop once the worker is done with a job.
+static gboolean pama_icon_cache_decoded(gpointer data)
+{
+	PamaIconCacheJob *job = data;
+	GdkPixbuf *pixbuf;
+	GSList *iter;
+
+	if (job->generation == generation)
+	{
+		g_hash_table_remove(pending, job->key);
+
+		if (job->pixbuf)
+		{
+			g_hash_table_insert(pixbufs, job->key, job->pixbuf);
+			pixbuf = g_object_ref(job->pixbuf);
+		}
+		else
+		{
+			/* The file could not be decoded on its own; the theme may
+			 * still load it, and caches whatever it finds */
+			pixbuf = pama_icon_cache_get_pixbuf(job->key->icon, job->key->size);
+		}
+
+		/* Images keep the fallback if the icon cannot be loaded at all */
+		for (iter = images; pixbuf && iter; iter = iter->next)
+		{
+			GObject *image = iter->data;
+
+			if (GPOINTER_TO_INT(g_object_get_data(image, "pama-icon-size")) == job->key->size
+			 && g_icon_equal(g_object_get_data(image, "pama-icon"), job->key->icon))
+				gtk_image_set_from_pixbuf(GTK_IMAGE(image), pixbuf);
+		}
+
+		if (pixbuf)
+			g_object_unref(pixbuf);
+		if (!job->pixbuf)
+			pama_icon_cache_key_free(job->key);
+	}
+	else
+	{
+		pama_icon_cache_key_free(job->key);
+		pama_icon_cache_pixbuf_free(job->pixbuf);
+	}
+
+	g_free(job->filename);
+	g_slice_free(PamaIconCacheJob, job);
+	return FALSE;
+}
+
+static gboolean pama_icon_cache_prefetch_idle(gpointer data)
+{
+	PamaIconCacheKey lookup;
+	GIcon *icon;
+	gchar *icon_name;
+
+	if (!prefetch)
+		return FALSE;
+
+	icon_name = prefetch->data;
+	prefetch = g_slist_delete_link(prefetch, prefetch);
+
+	icon = pama_icon_cache_get_gicon(icon_name, FALSE);
+	lookup.icon = icon;
+	lookup.size = WIDGET_ICON_SIZE;
+
+	if (!g_hash_table_lookup_extended(pixbufs, &lookup, NULL, NULL))
+		pama_icon_cache_load_async(icon, WIDGET_ICON_SIZE);
+
+	g_object_unref(icon);
+	g_free(icon_name);
+
+	// Look up one name per idle, so the theme lookups never pile up
+	return prefetch != NULL;
+}
+
+static void pama_icon_cache_show(GtkImage *image, GIcon *icon, gint size)
+{
+	PamaIconCacheKey lookup = { icon, size };
+	GdkPixbuf *pixbuf;
+	GIcon *fallback;
+
+	if (!g_hash_table_lookup_extended(pixbufs, &lookup, NULL, NULL) && pama_icon_cache_load_async(icon, size))
+		pixbuf = NULL;
+	else
+		pixbuf = pama_icon_cache_get_pixbuf(icon, size);
+
+	/* Until the decoded pixbuf arrives, or for good if the icon cannot be loaded */
+	if (!pixbuf)
+	{
+		fallback = pama_icon_cache_get_gicon("application-x-executable", FALSE);
+		pixbuf = g_icon_equal(fallback, icon) ? NULL : pama_icon_cache_get_pixbuf(fallback, size);
+		g_object_unref(fallback);
+	}
+
+	gtk_image_set_from_pixbuf(image, pixbuf);
+	if (pixbuf)
+		g_object_unref(pixbuf);
+}
+
+
+// Returns a themed icon, with a shared emblem if network is set. The icon is
+// shared by everyone asking for the same one, and is referenced for the caller.
+GIcon *pama_icon_cache_get_gicon(const gchar *icon_name, gboolean network)
+{
+	gchar *key;
+	GIcon *icon, *temp;
+	GEmblem *shared;
+
+	pama_icon_cache_init();
+
+	key = g_strdup_printf("%d:%s", network ? 1 : 0, icon_name);
+	icon = g_hash_table_lookup(gicons, key);
+
+	if (!icon)
+	{
+		icon = g_themed_icon_new_with_default_fallbacks(icon_name);
+
+		if (network)
+		{
+			temp = g_themed_icon_new("emblem-shared");
+			shared = g_emblem_new_with_origin(temp, G_EMBLEM_ORIGIN_DEVICE);
+			g_object_unref(temp);
+
+			temp = icon;
+			icon = g_emblemed_icon_new(temp, shared);
+			g_object_unref(temp);
+			g_object_unref(shared);
+		}
+
+		g_hash_table_insert(gicons, key, icon);
+	}
+	else
+		g_free(key);
+
+	return g_object_ref(icon);
+}
+
+// Returns the pixbuf of an icon at the given size in the current theme, or
+// NULL if the theme has no such icon. The pixbuf is referenced for the caller.
+GdkPixbuf *pama_icon_cache_get_pixbuf(GIcon *icon, gint size)
+{
+	PamaIconCacheKey lookup = { icon, size };
+	PamaIconCacheKey *key;
+	GtkIconInfo *info;
+	GdkPixbuf *pixbuf = NULL;
+	gpointer cached;
+
+	pama_icon_cache_init();
+
+	if (g_hash_table_lookup_extended(pixbufs, &lookup, NULL, &cached))
+		return cached ? g_object_ref(cached) : NULL;
+
+	info = gtk_icon_theme_lookup_by_gicon(gtk_icon_theme_get_default(), icon, size, GTK_ICON_LOOKUP_USE_BUILTIN | GTK_ICON_LOOKUP_FORCE_SIZE);
+	if (info)
+	{
+		pixbuf = gtk_icon_info_load_icon(info, NULL);
+		gtk_icon_info_free(info);
+	}
+
+	key = g_slice_new(PamaIconCacheKey);
+	key->icon = g_object_ref(icon);
+	key->size = size;
+	g_hash_table_insert(pixbufs, key, pixbuf);
+
+	return pixbuf ? g_object_ref(pixbuf) : NULL;
+}
+
+// Shows an icon in an image, unless it is already showing it. The image is
+// updated by the cache itself when the icon theme changes.
+void pama_icon_cache_set_image(GtkImage *image, GIcon *icon, gint size)
+{
+	GIcon *current = g_object_get_data(G_OBJECT(image), "pama-icon");
+
+	if (current)
+	{
+		if (GPOINTER_TO_INT(g_object_get_data(G_OBJECT(image), "pama-icon-size")) == size && g_icon_equal(current, icon))
+			return;
+	}
+	else
+	{
+		images = g_slist_prepend(images, image);
+		g_object_weak_ref(G_OBJECT(image), pama_icon_cache_image_weak_ref_notify, NULL);
+	}
+
+	g_object_set_data_full(G_OBJECT(image), "pama-icon", g_object_ref(icon), g_object_unref);
+	g_object_set_data(G_OBJECT(image), "pama-icon-size", GINT_TO_POINTER(size));
+
+	pama_icon_cache_show(image, icon, size);
+}
+
+// Starts decoding an application icon before any widget asks for it, once
+// the main loop is idle.
+void pama_icon_cache_prefetch(const gchar *icon_name)
+{
+	if (!icon_name || !*icon_name)
+		return;
+
+	pama_icon_cache_init();
+
+	if (g_slist_find_custom(prefetch, icon_name, (GCompareFunc) strcmp))
+		return;
+
+	if (!prefetch)
+		g_idle_add_full(G_PRIORITY_LOW, pama_icon_cache_prefetch_idle, NULL, NULL);
+	prefetch = g_slist_append(prefetch, g_strdup(icon_name));
+}
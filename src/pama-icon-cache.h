@@ -0,0 +1,38 @@
+/*
+ * pama-icon-cache.h: Shared GIcons and pixbufs for device and stream icons
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_ICON_CACHE_H
+#define PAMA_ICON_CACHE_H
+
+#include <glib.h>
+#include <gio/gio.h>
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+GIcon     *pama_icon_cache_get_gicon(const gchar *icon_name, gboolean network);
+GdkPixbuf *pama_icon_cache_get_pixbuf(GIcon *icon, gint size);
+void       pama_icon_cache_set_image(GtkImage *image, GIcon *icon, gint size);
+void       pama_icon_cache_prefetch(const gchar *icon_name);
+
+G_END_DECLS
+
+#endif /* PAMA_ICON_CACHE_H */
+
@@ -0,0 +1,219 @@
+/*
+ * pama-latency-poll.c: Polls the latency of visible devices and streams
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+
+#include "pama-latency-poll.h"
+#include "pama-pulse-context.h"
+#include "widget-settings.h"
+
+/* The server sends no events when latency changes, so the latency columns
+ * have to ask for it. Rows add their sink, source or sink input while they
+ * are mapped and remove it when they are unmapped, and the poll timer only
+ * runs while anything is added: once the popup is hidden, nothing is asked.
+ *
+ * Each round asks for all of them at once, by index, so that only the shown
+ * rows are looked up however busy the server is. The requests are sent back
+ * to back and answered in one round trip. A round is skipped while the last
+ * one has not been answered, so a slow server is not flooded. */
+
+static gboolean pama_latency_poll_tick(gpointer data);
+static void     pama_latency_poll_weak_ref_notify(gpointer data, GObject *where_the_object_was);
+static void     pama_latency_poll_track(pa_operation *o);
+static void     pama_latency_poll_sink_cb      (pa_context *c, const pa_sink_info       *i, int eol, void *data);
+static void     pama_latency_poll_source_cb    (pa_context *c, const pa_source_info     *i, int eol, void *data);
+static void     pama_latency_poll_sink_input_cb(pa_context *c, const pa_sink_input_info *i, int eol, void *data);
+
+static GHashTable       *objects    = NULL; /* object -> number of rows showing it */
+static GSList           *operations = NULL; /* the requests of the last round */
+static PamaPulseContext *context    = NULL; /* weak */
+static guint             interval   = 0;
+static guint             poll_source_id = 0;
+
+static void pama_latency_poll_weak_ref_notify(gpointer data, GObject *where_the_object_was)
+{
+	g_hash_table_remove(objects, where_the_object_was);
+
+	if (g_hash_table_size(objects) || 0 == poll_source_id)
+		return;
+
+	g_source_remove(poll_source_id);
+	poll_source_id = 0;
+
+	/* Answers still on their way find nothing to do */
+	g_slist_foreach(operations, (GFunc) pa_operation_unref, NULL);
+	g_slist_free(operations);
+	operations = NULL;
+}
+static void pama_latency_poll_track(pa_operation *o)
+{
+	if (o)
+		operations = g_slist_prepend(operations, o);
+}
+static gboolean pama_latency_poll_tick(gpointer data)
+{
+	GHashTableIter iter;
+	gpointer       object;
+	GSList        *l;
+	pa_context    *c;
+	guint          index;
+
+	/* Requests that were answered or cancelled are done with */
+	for (l = operations; l; l = l->next)
+	{
+		if (PA_OPERATION_RUNNING == pa_operation_get_state(l->data))
+			return TRUE;
+	}
+	g_slist_foreach(operations, (GFunc) pa_operation_unref, NULL);
+	g_slist_free(operations);
+	operations = NULL;
+
+	if (NULL == context)
+		return TRUE;
+
+	g_object_get(context, "context", &c, NULL);
+	if (NULL == c || PA_CONTEXT_READY != pa_context_get_state(c))
+		return TRUE;
+
+	g_hash_table_iter_init(&iter, objects);
+	while (g_hash_table_iter_next(&iter, &object, NULL))
+	{
+		g_object_get(object, "index", &index, NULL);
+
+		if (PAMA_IS_PULSE_SINK(object))
+			pama_latency_poll_track(pa_context_get_sink_info_by_index(c, index, pama_latency_poll_sink_cb, NULL));
+		else if (PAMA_IS_PULSE_SOURCE(object))
+			pama_latency_poll_track(pa_context_get_source_info_by_index(c, index, pama_latency_poll_source_cb, NULL));
+		else if (PAMA_IS_PULSE_SINK_INPUT(object))
+			pama_latency_poll_track(pa_context_get_sink_input_info(c, index, pama_latency_poll_sink_input_cb, NULL));
+	}
+
+	return TRUE;
+}
+
+
+// Only the latency is set, so that rows redraw their latency column and not
+// everything else.
+static void pama_latency_poll_sink_cb(pa_context *c, const pa_sink_info *i, int eol, void *data)
+{
+	PamaPulseSink *sink;
+
+	if (eol || NULL == context)
+		return;
+
+	sink = pama_pulse_context_get_sink_by_index(context, i->index);
+	if (sink)
+		g_object_set(sink,
+		             "latency",            (guint64) i->latency,
+		             "configured-latency", (guint64) i->configured_latency,
+		             NULL);
+}
+static void pama_latency_poll_source_cb(pa_context *c, const pa_source_info *i, int eol, void *data)
+{
+	PamaPulseSource *source;
+
+	if (eol || NULL == context)
+		return;
+
+	source = pama_pulse_context_get_source_by_index(context, i->index);
+	if (source)
+		g_object_set(source,
+		             "latency",            (guint64) i->latency,
+		             "configured-latency", (guint64) i->configured_latency,
+		             NULL);
+}
+static void pama_latency_poll_sink_input_cb(pa_context *c, const pa_sink_input_info *i, int eol, void *data)
+{
+	PamaPulseSinkInput *sink_input;
+
+	if (eol || NULL == context)
+		return;
+
+	sink_input = pama_pulse_context_get_sink_input_by_index(context, i->index);
+	if (sink_input)
+		g_object_set(sink_input,
+		             "buffer-latency", (guint64) i->buffer_usec,
+		             "sink-latency",   (guint64) i->sink_usec,
+		             NULL);
+}
+
+
+// Sets how often to poll, in milliseconds. 0 turns the latency columns off;
+// rows only look at this when they are created.
+void pama_latency_poll_set_interval(guint new_interval)
+{
+	interval = new_interval ? MAX(new_interval, WIDGET_LATENCY_MIN_INTERVAL) : 0;
+}
+guint pama_latency_poll_get_interval(void)
+{
+	return interval;
+}
+
+// Starts polling a PamaPulseSink, PamaPulseSource or PamaPulseSinkInput of
+// the given context, if the latency columns are on. Calls nest.
+void pama_latency_poll_add(PamaPulseContext *new_context, GObject *object)
+{
+	guint count;
+
+	if (0 == interval)
+		return;
+
+	if (new_context != context)
+	{
+		if (context)
+			g_object_remove_weak_pointer(G_OBJECT(context), (gpointer *)&context);
+		context = new_context;
+		g_object_add_weak_pointer(G_OBJECT(context), (gpointer *)&context);
+	}
+
+	if (NULL == objects)
+		objects = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+	count = GPOINTER_TO_UINT(g_hash_table_lookup(objects, object));
+	if (0 == count)
+		g_object_weak_ref(object, pama_latency_poll_weak_ref_notify, NULL);
+	g_hash_table_insert(objects, object, GUINT_TO_POINTER(count + 1));
+
+	if (0 == poll_source_id)
+		poll_source_id = g_timeout_add(interval, pama_latency_poll_tick, NULL);
+}
+void pama_latency_poll_remove(GObject *object)
+{
+	guint count;
+
+	if (NULL == objects)
+		return;
+
+	count = GPOINTER_TO_UINT(g_hash_table_lookup(objects, object));
+	if (0 == count)
+		return;
+
+	if (count > 1)
+	{
+		g_hash_table_insert(objects, object, GUINT_TO_POINTER(count - 1));
+		return;
+	}
+
+	g_object_weak_unref(object, pama_latency_poll_weak_ref_notify, NULL);
+	pama_latency_poll_weak_ref_notify(NULL, object);
+}
@@ -0,0 +1,38 @@
+/*
+ * pama-latency-poll.h: Polls the latency of visible devices and streams
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_LATENCY_POLL_H
+#define PAMA_LATENCY_POLL_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include "pama-pulse-context.h"
+
+G_BEGIN_DECLS
+
+void  pama_latency_poll_set_interval(guint interval);
+guint pama_latency_poll_get_interval(void);
+
+void  pama_latency_poll_add   (PamaPulseContext *context, GObject *object);
+void  pama_latency_poll_remove(GObject *object);
+
+G_END_DECLS
+
+#endif /* PAMA_LATENCY_POLL_H */
@@ -0,0 +1,165 @@
+/*
+ * pama-meter-benchmark.c: Measures and cross-checks the meter reduction kernels
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "pama-meter-kernels.h"
+
+/* Checks every kernel the CPU supports against the scalar one, on all channel
+ * counts up to 8 and on block lengths that do and do not fill whole
+ * registers, then reports how many samples per second each of them reduces.
+ * The test signal runs slightly past full scale, so clip counts are checked
+ * too.
+ * Exits with a failure status if any kernel disagrees.
+ *
+ * Usage: pama-meter-benchmark [FRAMES [CHANNELS [SECONDS]]] */
+
+#define BENCHMARK_MAX_CHANNELS 8
+#define BENCHMARK_SEED         0x70616d61
+
+/* Kernels may sum in a different order; peaks and counts must match exactly */
+#define BENCHMARK_RMS_TOLERANCE 1e-6
+
+#define BENCHMARK_AMPLITUDE 1.05
+
+static gfloat  *benchmark_new_signal(gsize n_samples);
+static gboolean benchmark_check(const PamaMeterKernel *reference, const PamaMeterKernel *kernel, const gfloat *signal);
+static gdouble  benchmark_run(const PamaMeterKernel *kernel, const gfloat *signal, gsize n_frames, guint channels, gdouble seconds);
+
+static const gsize check_lengths[] = { 0, 1, 3, 7, 8, 9, 255, 1024, 4099 };
+
+static gfloat *benchmark_new_signal(gsize n_samples)
+{
+	GRand  *rand = g_rand_new_with_seed(BENCHMARK_SEED);
+	gfloat *signal = g_new(gfloat, n_samples);
+	gsize   i;
+
+	for (i = 0; i < n_samples; i++)
+		signal[i] = g_rand_double_range(rand, -BENCHMARK_AMPLITUDE, BENCHMARK_AMPLITUDE);
+
+	g_rand_free(rand);
+	return signal;
+}
+
+static gboolean benchmark_check(const PamaMeterKernel *reference, const PamaMeterKernel *kernel, const gfloat *signal)
+{
+	gfloat   expected_peaks[BENCHMARK_MAX_CHANNELS], expected_rms[BENCHMARK_MAX_CHANNELS];
+	gfloat   peaks[BENCHMARK_MAX_CHANNELS], rms[BENCHMARK_MAX_CHANNELS];
+	PamaMeterOvers expected_overs, overs;
+	gboolean ok = TRUE;
+	guint    channels, c, l;
+
+	for (channels = 1; channels <= BENCHMARK_MAX_CHANNELS; channels++)
+	{
+		for (l = 0; l < G_N_ELEMENTS(check_lengths); l++)
+		{
+			gsize n_frames = check_lengths[l];
+
+			/* Start one sample in, so loads are not aligned either */
+			reference->reduce(signal + 1, n_frames, channels, expected_peaks, expected_rms, &expected_overs);
+			kernel->reduce   (signal + 1, n_frames, channels, peaks,          rms,          &overs);
+
+			if (overs.clipped != expected_overs.clipped || overs.near_clipped != expected_overs.near_clipped)
+			{
+				g_printerr("%s: %u channels, %" G_GSIZE_FORMAT " frames: %u clipped, %u near, expected %u clipped, %u near\n",
+				           kernel->name, channels, n_frames, overs.clipped, overs.near_clipped,
+				           expected_overs.clipped, expected_overs.near_clipped);
+				ok = FALSE;
+			}
+
+			for (c = 0; c < channels; c++)
+			{
+				if (peaks[c] != expected_peaks[c] || fabs(rms[c] - expected_rms[c]) > BENCHMARK_RMS_TOLERANCE * MAX(expected_rms[c], 1e-6))
+				{
+					g_printerr("%s: %u channels, %" G_GSIZE_FORMAT " frames, channel %u: peak %g rms %g, expected peak %g rms %g\n",
+					           kernel->name, channels, n_frames, c, peaks[c], rms[c], expected_peaks[c], expected_rms[c]);
+					ok = FALSE;
+				}
+			}
+		}
+	}
+
+	return ok;
+}
+
+// Returns the number of samples per second the kernel reduced, in blocks of
+// n_frames, over roughly the given time.
+static gdouble benchmark_run(const PamaMeterKernel *kernel, const gfloat *signal, gsize n_frames, guint channels, gdouble seconds)
+{
+	GTimer *timer = g_timer_new();
+	gfloat  peaks[BENCHMARK_MAX_CHANNELS], rms[BENCHMARK_MAX_CHANNELS];
+	PamaMeterOvers overs;
+	gdouble elapsed;
+	guint64 blocks = 0;
+	guint   i;
+
+	do
+	{
+		for (i = 0; i < 256; i++)
+			kernel->reduce(signal, n_frames, channels, peaks, rms, &overs);
+		blocks += 256;
+	}
+	while ((elapsed = g_timer_elapsed(timer, NULL)) < seconds);
+
+	g_timer_destroy(timer);
+	return blocks * n_frames * channels / elapsed;
+}
+
+int main(int argc, char *argv[])
+{
+	const PamaMeterKernel *kernels;
+	gfloat  *signal;
+	gsize    n_frames = 1024;
+	guint    channels = 2;
+	gdouble  seconds  = 1.0;
+	gboolean ok = TRUE;
+	guint    n_kernels, k;
+
+	if (argc > 1)
+		n_frames = strtoul(argv[1], NULL, 10);
+	if (argc > 2)
+		channels = CLAMP(strtoul(argv[2], NULL, 10), 1, BENCHMARK_MAX_CHANNELS);
+	if (argc > 3)
+		seconds = g_ascii_strtod(argv[3], NULL);
+
+	kernels = pama_meter_kernels_get_available(&n_kernels);
+	signal  = benchmark_new_signal(MAX(n_frames * channels, check_lengths[G_N_ELEMENTS(check_lengths) - 1] * BENCHMARK_MAX_CHANNELS) + 1);
+
+	g_print("Selected kernel: %s\n", pama_meter_kernels_get_name());
+	g_print("Blocks of %" G_GSIZE_FORMAT " frames, %u channels\n\n", n_frames, channels);
+	g_print("%-8s %14s  %s\n", "kernel", "samples/s", "matches scalar");
+
+	for (k = 0; k < n_kernels; k++)
+	{
+		gboolean matches = k == 0 || benchmark_check(&kernels[0], &kernels[k], signal);
+
+		g_print("%-8s %14.4g  %s\n", kernels[k].name, benchmark_run(&kernels[k], signal, n_frames, channels, seconds),
+		        k == 0 ? "-" : matches ? "yes" : "NO");
+		ok = ok && matches;
+	}
+
+	g_free(signal);
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
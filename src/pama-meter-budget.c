@@ -0,0 +1,149 @@
+/*
+ * pama-meter-budget.c: Shares a limited number of application meters between rows
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+
+#include "pama-meter-budget.h"
+#include "widget-settings.h"
+
+/* Every application meter is a record stream of its own on the server, so a
+ * popup full of applications must not open one for each of them. Rows ask for
+ * a meter while they are visible, and at most WIDGET_STREAM_METER_MAX of them
+ * get one: those that asked or changed most recently. Grants are worked out
+ * together a short while after the last change, so that scrolling through the
+ * list or dragging a slider does not open and close streams on every step. */
+
+typedef struct
+{
+	gpointer            owner;
+	PamaMeterBudgetFunc func;
+	guint               serial;
+	gboolean            granted;
+} PamaMeterBudgetEntry;
+
+static void     pama_meter_budget_schedule(void);
+static gboolean pama_meter_budget_rebalance(gpointer data);
+static gint     pama_meter_budget_compare(gconstpointer a, gconstpointer b);
+
+static GHashTable *entries = NULL; /* owner -> PamaMeterBudgetEntry */
+static guint       serial  = 0;    /* bumped on every request and touch */
+static guint       rebalance_source_id = 0;
+
+static void pama_meter_budget_schedule(void)
+{
+	if (rebalance_source_id)
+		return;
+
+	rebalance_source_id = g_timeout_add(WIDGET_STREAM_METER_REBALANCE_DELAY, pama_meter_budget_rebalance, NULL);
+}
+static gint pama_meter_budget_compare(gconstpointer a, gconstpointer b)
+{
+	const PamaMeterBudgetEntry *A = a, *B = b;
+
+	return A->serial == B->serial ? 0 : (A->serial > B->serial ? -1 : 1);
+}
+static gboolean pama_meter_budget_rebalance(gpointer data)
+{
+	GList *sorted, *iter;
+	guint  n = 0;
+
+	rebalance_source_id = 0;
+
+	sorted = g_list_sort(g_hash_table_get_values(entries), pama_meter_budget_compare);
+
+	/* Revoke first, so the server never has more than the budget open */
+	for (iter = g_list_nth(sorted, WIDGET_STREAM_METER_MAX); iter; iter = iter->next)
+	{
+		PamaMeterBudgetEntry *entry = iter->data;
+
+		if (!entry->granted)
+			continue;
+
+		entry->granted = FALSE;
+		entry->func(entry->owner, FALSE);
+	}
+
+	for (iter = sorted; iter && n < WIDGET_STREAM_METER_MAX; iter = iter->next, n++)
+	{
+		PamaMeterBudgetEntry *entry = iter->data;
+
+		if (entry->granted)
+			continue;
+
+		entry->granted = TRUE;
+		entry->func(entry->owner, TRUE);
+	}
+
+	g_list_free(sorted);
+	return FALSE;
+}
+
+
+// Asks for a meter on behalf of owner, which counts as a change. func is
+// called later if and when one is granted. Asking again does nothing more.
+void pama_meter_budget_request(gpointer owner, PamaMeterBudgetFunc func)
+{
+	PamaMeterBudgetEntry *entry;
+
+	if (NULL == entries)
+		entries = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+
+	if (g_hash_table_lookup(entries, owner))
+		return;
+
+	entry = g_new0(PamaMeterBudgetEntry, 1);
+	entry->owner  = owner;
+	entry->func   = func;
+	entry->serial = ++serial;
+	g_hash_table_insert(entries, owner, entry);
+
+	pama_meter_budget_schedule();
+}
+
+// Marks owner as recently changed, moving it ahead of the others.
+void pama_meter_budget_touch(gpointer owner)
+{
+	PamaMeterBudgetEntry *entry;
+
+	if (NULL == entries || NULL == (entry = g_hash_table_lookup(entries, owner)))
+		return;
+
+	entry->serial = ++serial;
+	if (!entry->granted)
+		pama_meter_budget_schedule();
+}
+
+// Gives up owner's place, and its meter if it had one. func is not called;
+// the owner is expected to close its meter itself.
+void pama_meter_budget_release(gpointer owner)
+{
+	PamaMeterBudgetEntry *entry;
+
+	if (NULL == entries || NULL == (entry = g_hash_table_lookup(entries, owner)))
+		return;
+
+	if (entry->granted)
+		pama_meter_budget_schedule();
+
+	g_hash_table_remove(entries, owner);
+}
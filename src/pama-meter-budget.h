@@ -0,0 +1,38 @@
+/*
+ * pama-meter-budget.h: Shares a limited number of application meters between rows
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_METER_BUDGET_H
+#define PAMA_METER_BUDGET_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Called with TRUE when the owner may open its meter, and with FALSE when it
+ * must close it again to make room for another */
+typedef void (*PamaMeterBudgetFunc)(gpointer owner, gboolean granted);
+
+void pama_meter_budget_request(gpointer owner, PamaMeterBudgetFunc func);
+void pama_meter_budget_touch  (gpointer owner);
+void pama_meter_budget_release(gpointer owner);
+
+G_END_DECLS
+
+#endif /* PAMA_METER_BUDGET_H */
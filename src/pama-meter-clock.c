@@ -0,0 +1,160 @@
+/*
+ * pama-meter-clock.c: Paints every level meter from one shared frame timer
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+
+#include "pama-meter-clock.h"
+#include "widget-settings.h"
+
+/* Meter streams deliver levels whenever the server sends them, a few dozen
+ * times a second each, and a popup can show many meters. Rather than have
+ * every delivery repaint its bar, deliveries only raise the bar's held peak,
+ * and one timer shared by all bars paints them at a steady frame rate. Each
+ * frame takes the peak held since the last one, lets the shown level fall
+ * back smoothly towards it, and only touches bars whose level moved by at
+ * least a pixel. The timer stops once every bar has fallen to zero and starts
+ * again with the next peak. */
+
+#define METER_CLOCK_HOLD_SCALE 65536 /* held peaks are fixed point, so they can be swapped atomically */
+
+typedef struct
+{
+	GtkProgressBar *bar;
+	volatile gint   hold;  /* highest level pushed since the last frame */
+	gdouble         shown; /* level as of the last frame */
+	gint            drawn; /* pixel the bar was last drawn to */
+} PamaMeterClockEntry;
+
+static gboolean pama_meter_clock_frame(gpointer data);
+
+static GSList *entries = NULL;
+static guint   frame_source_id = 0;
+static GTimer *frame_timer = NULL;
+
+static gboolean pama_meter_clock_frame(gpointer data)
+{
+	GSList  *iter;
+	gboolean moving = FALSE;
+	gdouble  decay;
+
+	decay = g_timer_elapsed(frame_timer, NULL) * WIDGET_METER_DECAY;
+	g_timer_start(frame_timer);
+
+	for (iter = entries; iter; iter = iter->next)
+	{
+		PamaMeterClockEntry *entry = iter->data;
+		gint    hold, drawn, width;
+		gdouble level;
+
+		do
+			hold = g_atomic_int_get(&entry->hold);
+		while (!g_atomic_int_compare_and_exchange(&entry->hold, hold, 0));
+
+		level = (gdouble) hold / METER_CLOCK_HOLD_SCALE;
+		entry->shown = MAX(level, entry->shown - decay);
+		if (entry->shown > 0.0)
+			moving = TRUE;
+
+		width = MAX(GTK_WIDGET(entry->bar)->allocation.width, 1);
+		drawn = entry->shown * width;
+		if (drawn == entry->drawn)
+			continue;
+
+		entry->drawn = drawn;
+		gtk_progress_bar_set_fraction(entry->bar, (gdouble) drawn / width);
+	}
+
+	if (moving)
+		return TRUE;
+
+	frame_source_id = 0;
+	return FALSE;
+}
+
+
+// Starts painting bar from the frame timer. It must be removed again before
+// it is destroyed.
+void pama_meter_clock_add(GtkProgressBar *bar)
+{
+	PamaMeterClockEntry *entry;
+
+	if (g_object_get_data(G_OBJECT(bar), "pama-meter-clock"))
+		return;
+
+	if (NULL == frame_timer)
+		frame_timer = g_timer_new();
+
+	entry = g_slice_new0(PamaMeterClockEntry);
+	entry->bar = bar;
+	g_object_set_data(G_OBJECT(bar), "pama-meter-clock", entry);
+	entries = g_slist_prepend(entries, entry);
+
+	gtk_progress_bar_set_fraction(bar, 0.0);
+}
+
+// Stops painting bar, and leaves it empty.
+void pama_meter_clock_remove(GtkProgressBar *bar)
+{
+	PamaMeterClockEntry *entry = g_object_get_data(G_OBJECT(bar), "pama-meter-clock");
+
+	if (NULL == entry)
+		return;
+
+	g_object_set_data(G_OBJECT(bar), "pama-meter-clock", NULL);
+	entries = g_slist_remove(entries, entry);
+	g_slice_free(PamaMeterClockEntry, entry);
+
+	gtk_progress_bar_set_fraction(bar, 0.0);
+
+	if (NULL == entries && frame_source_id)
+	{
+		g_source_remove(frame_source_id);
+		frame_source_id = 0;
+	}
+}
+
+// Holds level, from 0 to 1, for the next frame if it is the highest since the
+// last one. This is all a meter's read callback should do.
+void pama_meter_clock_push(GtkProgressBar *bar, gdouble level)
+{
+	PamaMeterClockEntry *entry = g_object_get_data(G_OBJECT(bar), "pama-meter-clock");
+	gint value = CLAMP(level, 0.0, 1.0) * METER_CLOCK_HOLD_SCALE;
+	gint hold;
+
+	if (NULL == entry)
+		return;
+
+	do
+	{
+		hold = g_atomic_int_get(&entry->hold);
+		if (hold >= value)
+			break;
+	}
+	while (!g_atomic_int_compare_and_exchange(&entry->hold, hold, value));
+
+	if (value > 0 && 0 == frame_source_id)
+	{
+		g_timer_start(frame_timer);
+		frame_source_id = g_timeout_add(WIDGET_METER_FRAME_INTERVAL, pama_meter_clock_frame, NULL);
+	}
+}
@@ -0,0 +1,35 @@
+/*
+ * pama-meter-clock.h: Paints every level meter from one shared frame timer
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_METER_CLOCK_H
+#define PAMA_METER_CLOCK_H
+
+#include <glib.h>
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+void pama_meter_clock_add   (GtkProgressBar *bar);
+void pama_meter_clock_remove(GtkProgressBar *bar);
+void pama_meter_clock_push  (GtkProgressBar *bar, gdouble level);
+
+G_END_DECLS
+
+#endif /* PAMA_METER_CLOCK_H */
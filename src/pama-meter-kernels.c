@@ -0,0 +1,474 @@
+/*
+ * pama-meter-kernels.c: Reduces blocks of samples to per-channel peak and RMS levels
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+#include <math.h>
+#include <string.h>
+
+#include "pama-meter-kernels.h"
+
+/* Meters reduce whatever the server delivered in the stream read callback,
+ * on the main loop, so the reduction has to be cheap. On x86 the SSE2 and
+ * AVX2 kernels work on four or eight samples at a time. Registers are loaded
+ * in runs covering the least common multiple of that width and the channel
+ * count, at most eight registers for up to eight channels (3 for 5.1 with
+ * SSE2), and each register of a run has accumulators of its own. Every lane
+ * of those then always holds the same channel of successive frames, so frames
+ * are de-interleaved for free: lane i of the run accumulates channel
+ * i % channels, and the lanes are only folded into channels once at the end.
+ * Squares are summed in doubles, as in the scalar
+ * kernel, so all of them agree to within float rounding of the input.
+ * Samples at and near full scale are counted while they are in registers
+ * anyway, by subtracting the all-ones masks of two comparisons from integer
+ * lane counters, so clip detection costs no second pass over the block.
+ *
+ * Layouts whose run would need more than PAMA_METER_MAX_RUN registers and
+ * other architectures use the scalar kernel. The best kernel the CPU supports
+ * is picked on first use.
+ *
+ * Loudness meters also run every sample through the two K-weighting biquads.
+ * Their state depends on the previous frame, so they cannot be spread over
+ * successive frames; instead the SSE2 filter runs the left and right channels
+ * of a stereo frame side by side in the two double lanes of a register. */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  define PAMA_METER_KERNELS_X86 1
+#  include <immintrin.h>
+#endif
+
+#define PAMA_METER_MAX_RUN 8
+
+static void pama_meter_kernels_select(void);
+static guint pama_meter_kernels_run_length(guint width, guint channels);
+static void pama_meter_kernels_reduce_scalar(const gfloat *samples, gsize n_frames, guint channels, gfloat *peaks, gfloat *rms, PamaMeterOvers *overs);
+static void pama_meter_kernels_finish(const gfloat *samples, gsize n_frames, gsize done_frames, guint channels,
+                                      const gfloat *lane_peaks, const gdouble *lane_sums, guint width,
+                                      gfloat *peaks, gfloat *rms, PamaMeterOvers *overs);
+#ifdef PAMA_METER_KERNELS_X86
+static void pama_meter_kernels_reduce_sse2(const gfloat *samples, gsize n_frames, guint channels, gfloat *peaks, gfloat *rms, PamaMeterOvers *overs);
+static void pama_meter_kernels_reduce_avx2(const gfloat *samples, gsize n_frames, guint channels, gfloat *peaks, gfloat *rms, PamaMeterOvers *overs);
+#endif
+
+static void pama_k_weighting_filter_scalar(PamaKWeighting *k, const gfloat *samples, gsize n_frames, guint channels, gdouble *sum_squares);
+#ifdef PAMA_METER_KERNELS_X86
+static void pama_k_weighting_filter_sse2  (PamaKWeighting *k, const gfloat *samples, gsize n_frames, gdouble *sum_squares);
+#endif
+
+static const PamaMeterKernel *kernel = NULL;
+
+static const PamaMeterKernel kernels[] =
+{
+	{ "scalar", pama_meter_kernels_reduce_scalar },
+#ifdef PAMA_METER_KERNELS_X86
+	{ "sse2",   pama_meter_kernels_reduce_sse2 },
+	{ "avx2",   pama_meter_kernels_reduce_avx2 },
+#endif
+};
+
+
+static void pama_meter_kernels_reduce_scalar(const gfloat *samples, gsize n_frames, guint channels, gfloat *peaks, gfloat *rms, PamaMeterOvers *overs)
+{
+	gdouble *sums = g_newa(gdouble, channels);
+	gsize    i;
+	guint    c;
+
+	for (c = 0; c < channels; c++)
+	{
+		peaks[c] = 0.0f;
+		sums[c]  = 0.0;
+	}
+	overs->clipped      = 0;
+	overs->near_clipped = 0;
+
+	for (i = 0; i < n_frames; i++, samples += channels)
+	{
+		for (c = 0; c < channels; c++)
+		{
+			gfloat s = fabsf(samples[c]);
+
+			peaks[c] = MAX(peaks[c], s);
+			sums[c] += (gdouble) s * s;
+			overs->clipped      += s >= PAMA_METER_FULL_SCALE;
+			overs->near_clipped += s >= PAMA_METER_NEAR_FULL_SCALE;
+		}
+	}
+
+	for (c = 0; c < channels; c++)
+		rms[c] = n_frames ? sqrt(sums[c] / n_frames) : 0.0f;
+}
+
+// Folds the lanes of a vector kernel into channels, and adds in the frames
+// after the last whole register. overs already holds the counts of the
+// frames before it.
+static void pama_meter_kernels_finish(const gfloat *samples, gsize n_frames, gsize done_frames, guint channels,
+                                      const gfloat *lane_peaks, const gdouble *lane_sums, guint width,
+                                      gfloat *peaks, gfloat *rms, PamaMeterOvers *overs)
+{
+	gdouble *sums = g_newa(gdouble, channels);
+	gsize    i;
+	guint    c;
+
+	for (c = 0; c < channels; c++)
+	{
+		peaks[c] = 0.0f;
+		sums[c]  = 0.0;
+	}
+
+	for (c = 0; c < width; c++)
+	{
+		peaks[c % channels] = MAX(peaks[c % channels], lane_peaks[c]);
+		sums [c % channels] += lane_sums[c];
+	}
+
+	for (i = done_frames, samples += done_frames * channels; i < n_frames; i++, samples += channels)
+	{
+		for (c = 0; c < channels; c++)
+		{
+			gfloat s = fabsf(samples[c]);
+
+			peaks[c] = MAX(peaks[c], s);
+			sums[c] += (gdouble) s * s;
+			overs->clipped      += s >= PAMA_METER_FULL_SCALE;
+			overs->near_clipped += s >= PAMA_METER_NEAR_FULL_SCALE;
+		}
+	}
+
+	for (c = 0; c < channels; c++)
+		rms[c] = n_frames ? sqrt(sums[c] / n_frames) : 0.0f;
+}
+
+// Returns how many registers of width lanes it takes until a frame starts in
+// the first lane again.
+static guint pama_meter_kernels_run_length(guint width, guint channels)
+{
+	guint a = width, b = channels, t;
+
+	while (b)
+	{
+		t = a % b;
+		a = b;
+		b = t;
+	}
+
+	return channels / a;
+}
+
+#ifdef PAMA_METER_KERNELS_X86
+__attribute__((target("sse2")))
+static void pama_meter_kernels_reduce_sse2(const gfloat *samples, gsize n_frames, guint channels, gfloat *peaks, gfloat *rms, PamaMeterOvers *overs)
+{
+	const __m128 abs_mask  = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	const __m128 full      = _mm_set1_ps(PAMA_METER_FULL_SCALE);
+	const __m128 near_full = _mm_set1_ps(PAMA_METER_NEAR_FULL_SCALE);
+	__m128  peak[PAMA_METER_MAX_RUN];
+	__m128d sum_lo[PAMA_METER_MAX_RUN], sum_hi[PAMA_METER_MAX_RUN];
+	__m128i clipped = _mm_setzero_si128(), near_clipped = _mm_setzero_si128();
+	gfloat  lane_peaks[4 * PAMA_METER_MAX_RUN];
+	gdouble lane_sums[4 * PAMA_METER_MAX_RUN];
+	guint32 lane_clipped[4], lane_near_clipped[4];
+	gsize   n_samples, i;
+	guint   run = pama_meter_kernels_run_length(4, channels), r;
+
+	if (run > PAMA_METER_MAX_RUN)
+	{
+		pama_meter_kernels_reduce_scalar(samples, n_frames, channels, peaks, rms, overs);
+		return;
+	}
+
+	for (r = 0; r < run; r++)
+	{
+		peak[r]   = _mm_setzero_ps();
+		sum_lo[r] = _mm_setzero_pd();
+		sum_hi[r] = _mm_setzero_pd();
+	}
+
+	n_samples = (n_frames * channels) / (4 * run) * (4 * run);
+	for (i = 0; i < n_samples; i += 4 * run)
+	{
+		for (r = 0; r < run; r++)
+		{
+			__m128  s  = _mm_and_ps(_mm_loadu_ps(samples + i + 4 * r), abs_mask);
+			__m128d lo = _mm_cvtps_pd(s);
+			__m128d hi = _mm_cvtps_pd(_mm_movehl_ps(s, s));
+
+			peak[r]      = _mm_max_ps(peak[r], s);
+			sum_lo[r]    = _mm_add_pd(sum_lo[r], _mm_mul_pd(lo, lo));
+			sum_hi[r]    = _mm_add_pd(sum_hi[r], _mm_mul_pd(hi, hi));
+			clipped      = _mm_sub_epi32(clipped,      _mm_castps_si128(_mm_cmpge_ps(s, full)));
+			near_clipped = _mm_sub_epi32(near_clipped, _mm_castps_si128(_mm_cmpge_ps(s, near_full)));
+		}
+	}
+
+	for (r = 0; r < run; r++)
+	{
+		_mm_storeu_ps(lane_peaks + 4 * r,    peak[r]);
+		_mm_storeu_pd(lane_sums  + 4 * r,     sum_lo[r]);
+		_mm_storeu_pd(lane_sums  + 4 * r + 2, sum_hi[r]);
+	}
+	_mm_storeu_si128((__m128i *) lane_clipped,      clipped);
+	_mm_storeu_si128((__m128i *) lane_near_clipped, near_clipped);
+
+	overs->clipped      = lane_clipped[0] + lane_clipped[1] + lane_clipped[2] + lane_clipped[3];
+	overs->near_clipped = lane_near_clipped[0] + lane_near_clipped[1] + lane_near_clipped[2] + lane_near_clipped[3];
+
+	pama_meter_kernels_finish(samples, n_frames, n_samples / channels, channels, lane_peaks, lane_sums, 4 * run, peaks, rms, overs);
+}
+
+__attribute__((target("avx2,fma")))
+static void pama_meter_kernels_reduce_avx2(const gfloat *samples, gsize n_frames, guint channels, gfloat *peaks, gfloat *rms, PamaMeterOvers *overs)
+{
+	const __m256 abs_mask  = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+	const __m256 full      = _mm256_set1_ps(PAMA_METER_FULL_SCALE);
+	const __m256 near_full = _mm256_set1_ps(PAMA_METER_NEAR_FULL_SCALE);
+	__m256  peak[PAMA_METER_MAX_RUN];
+	__m256d sum_lo[PAMA_METER_MAX_RUN], sum_hi[PAMA_METER_MAX_RUN];
+	__m256i clipped = _mm256_setzero_si256(), near_clipped = _mm256_setzero_si256();
+	gfloat  lane_peaks[8 * PAMA_METER_MAX_RUN];
+	gdouble lane_sums[8 * PAMA_METER_MAX_RUN];
+	guint32 lane_clipped[8], lane_near_clipped[8];
+	gsize   n_samples, i;
+	guint   run = pama_meter_kernels_run_length(8, channels), r, l;
+
+	if (run > PAMA_METER_MAX_RUN)
+	{
+		pama_meter_kernels_reduce_sse2(samples, n_frames, channels, peaks, rms, overs);
+		return;
+	}
+
+	for (r = 0; r < run; r++)
+	{
+		peak[r]   = _mm256_setzero_ps();
+		sum_lo[r] = _mm256_setzero_pd();
+		sum_hi[r] = _mm256_setzero_pd();
+	}
+
+	n_samples = (n_frames * channels) / (8 * run) * (8 * run);
+	for (i = 0; i < n_samples; i += 8 * run)
+	{
+		for (r = 0; r < run; r++)
+		{
+			__m256  s  = _mm256_and_ps(_mm256_loadu_ps(samples + i + 8 * r), abs_mask);
+			__m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(s));
+			__m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(s, 1));
+
+			peak[r]      = _mm256_max_ps(peak[r], s);
+			sum_lo[r]    = _mm256_fmadd_pd(lo, lo, sum_lo[r]);
+			sum_hi[r]    = _mm256_fmadd_pd(hi, hi, sum_hi[r]);
+			clipped      = _mm256_sub_epi32(clipped,      _mm256_castps_si256(_mm256_cmp_ps(s, full,      _CMP_GE_OQ)));
+			near_clipped = _mm256_sub_epi32(near_clipped, _mm256_castps_si256(_mm256_cmp_ps(s, near_full, _CMP_GE_OQ)));
+		}
+	}
+
+	for (r = 0; r < run; r++)
+	{
+		_mm256_storeu_ps(lane_peaks + 8 * r,    peak[r]);
+		_mm256_storeu_pd(lane_sums  + 8 * r,     sum_lo[r]);
+		_mm256_storeu_pd(lane_sums  + 8 * r + 4, sum_hi[r]);
+	}
+	_mm256_storeu_si256((__m256i *) lane_clipped,      clipped);
+	_mm256_storeu_si256((__m256i *) lane_near_clipped, near_clipped);
+
+	overs->clipped      = 0;
+	overs->near_clipped = 0;
+	for (l = 0; l < 8; l++)
+	{
+		overs->clipped      += lane_clipped[l];
+		overs->near_clipped += lane_near_clipped[l];
+	}
+
+	pama_meter_kernels_finish(samples, n_frames, n_samples / channels, channels, lane_peaks, lane_sums, 8 * run, peaks, rms, overs);
+}
+#endif
+
+
+static void pama_meter_kernels_select(void)
+{
+	guint n_kernels;
+
+	pama_meter_kernels_get_available(&n_kernels);
+	kernel = &kernels[n_kernels - 1];
+}
+
+// Reduces a block with the fastest kernel the CPU supports. peaks and rms
+// must have room for channels values each.
+void pama_meter_kernels_reduce(const gfloat *samples, gsize n_frames, guint channels, gfloat *peaks, gfloat *rms, PamaMeterOvers *overs)
+{
+	g_return_if_fail(channels > 0);
+
+	if (G_UNLIKELY(NULL == kernel))
+		pama_meter_kernels_select();
+
+	kernel->reduce(samples, n_frames, channels, peaks, rms, overs);
+}
+
+// Returns every kernel the CPU can run, from the scalar one to the fastest.
+// Used by the benchmark to compare them.
+const PamaMeterKernel *pama_meter_kernels_get_available(guint *n_kernels)
+{
+	*n_kernels = 1;
+#ifdef PAMA_METER_KERNELS_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2"))
+	{
+		*n_kernels = 2;
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+			*n_kernels = 3;
+	}
+#endif
+	return kernels;
+}
+
+const gchar *pama_meter_kernels_get_name(void)
+{
+	if (NULL == kernel)
+		pama_meter_kernels_select();
+
+	return kernel->name;
+}
+
+
+// Designs the filters for the given sample rate, as libebur128 does, so that
+// they match the coefficients tabulated in BS.1770 at 48kHz.
+void pama_k_weighting_init(PamaKWeighting *k, guint rate)
+{
+	gdouble f0, G, Q, K, Vh, Vb, a0;
+
+	memset(k, 0, sizeof(*k));
+
+	f0 = 1681.974450955533;
+	G  = 3.999843853973347;
+	Q  = 0.7071752369554196;
+	K  = tan(G_PI * f0 / rate);
+	Vh = pow(10.0, G / 20.0);
+	Vb = pow(Vh, 0.4996667741545416);
+	a0 = 1.0 + K / Q + K * K;
+
+	k->b[0][0] = (Vh + Vb * K / Q + K * K) / a0;
+	k->b[0][1] = 2.0 * (K * K - Vh) / a0;
+	k->b[0][2] = (Vh - Vb * K / Q + K * K) / a0;
+	k->a[0][0] = 1.0;
+	k->a[0][1] = 2.0 * (K * K - 1.0) / a0;
+	k->a[0][2] = (1.0 - K / Q + K * K) / a0;
+
+	f0 = 38.13547087602444;
+	Q  = 0.5003270373238773;
+	K  = tan(G_PI * f0 / rate);
+	a0 = 1.0 + K / Q + K * K;
+
+	k->b[1][0] = 1.0;
+	k->b[1][1] = -2.0;
+	k->b[1][2] = 1.0;
+	k->a[1][0] = 1.0;
+	k->a[1][1] = 2.0 * (K * K - 1.0) / a0;
+	k->a[1][2] = (1.0 - K / Q + K * K) / a0;
+}
+
+static void pama_k_weighting_filter_scalar(PamaKWeighting *k, const gfloat *samples, gsize n_frames, guint channels, gdouble *sum_squares)
+{
+	gsize i;
+	guint c, f;
+
+	for (i = 0; i < n_frames; i++, samples += channels)
+	{
+		for (c = 0; c < channels; c++)
+		{
+			gdouble x = samples[c], y = 0.0;
+
+			for (f = 0; f < 2; f++)
+			{
+				y            = k->b[f][0] * x + k->z[f][0][c];
+				k->z[f][0][c] = k->b[f][1] * x - k->a[f][1] * y + k->z[f][1][c];
+				k->z[f][1][c] = k->b[f][2] * x - k->a[f][2] * y;
+				x = y;
+			}
+
+			sum_squares[c] += y * y;
+		}
+	}
+}
+
+#ifdef PAMA_METER_KERNELS_X86
+__attribute__((target("sse2")))
+static void pama_k_weighting_filter_sse2(PamaKWeighting *k, const gfloat *samples, gsize n_frames, gdouble *sum_squares)
+{
+	__m128d b[2][3], a[2][3], z[2][2];
+	__m128d sum = _mm_loadu_pd(sum_squares);
+	gsize   i;
+	guint   f;
+
+	for (f = 0; f < 2; f++)
+	{
+		b[f][0] = _mm_set1_pd(k->b[f][0]);
+		b[f][1] = _mm_set1_pd(k->b[f][1]);
+		b[f][2] = _mm_set1_pd(k->b[f][2]);
+		a[f][1] = _mm_set1_pd(k->a[f][1]);
+		a[f][2] = _mm_set1_pd(k->a[f][2]);
+		z[f][0] = _mm_loadu_pd(k->z[f][0]);
+		z[f][1] = _mm_loadu_pd(k->z[f][1]);
+	}
+
+	for (i = 0; i < n_frames; i++, samples += 2)
+	{
+		/* One stereo frame, as two doubles */
+		__m128d x = _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd((const double *) samples)));
+		__m128d y = x;
+
+		for (f = 0; f < 2; f++)
+		{
+			y       = _mm_add_pd(_mm_mul_pd(b[f][0], x), z[f][0]);
+			z[f][0] = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(b[f][1], x), _mm_mul_pd(a[f][1], y)), z[f][1]);
+			z[f][1] = _mm_sub_pd(_mm_mul_pd(b[f][2], x), _mm_mul_pd(a[f][2], y));
+			x = y;
+		}
+
+		sum = _mm_add_pd(sum, _mm_mul_pd(y, y));
+	}
+
+	for (f = 0; f < 2; f++)
+	{
+		_mm_storeu_pd(k->z[f][0], z[f][0]);
+		_mm_storeu_pd(k->z[f][1], z[f][1]);
+	}
+	_mm_storeu_pd(sum_squares, sum);
+}
+#endif
+
+// K-weights n_frames frames of up to PAMA_K_WEIGHTING_MAX_CHANNELS channels,
+// keeping the filter state in k, and adds the squares of the result to
+// sum_squares for each channel.
+void pama_k_weighting_filter(PamaKWeighting *k, const gfloat *samples, gsize n_frames, guint channels, gdouble *sum_squares)
+{
+	g_return_if_fail(channels > 0 && channels <= PAMA_K_WEIGHTING_MAX_CHANNELS);
+
+	if (G_UNLIKELY(NULL == kernel))
+		pama_meter_kernels_select();
+
+#ifdef PAMA_METER_KERNELS_X86
+	if (2 == channels && kernel != &kernels[0])
+	{
+		pama_k_weighting_filter_sse2(k, samples, n_frames, sum_squares);
+		return;
+	}
+#endif
+	pama_k_weighting_filter_scalar(k, samples, n_frames, channels, sum_squares);
+}
@@ -0,0 +1,70 @@
+/*
+ * pama-meter-kernels.h: Reduces blocks of samples to per-channel peak and RMS levels
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_METER_KERNELS_H
+#define PAMA_METER_KERNELS_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Samples of at least the largest positive 16 bit value count as clipped;
+ * samples within 1dB of that count as near clipping */
+#define PAMA_METER_FULL_SCALE      (32767.0f / 32768.0f)
+#define PAMA_METER_NEAR_FULL_SCALE 0.891f
+
+/* How many samples of a block, over all channels, reached each level */
+typedef struct
+{
+	guint clipped;
+	guint near_clipped;
+} PamaMeterOvers;
+
+/* Reduces n_frames interleaved frames of channels samples each to the
+ * absolute peak and the RMS level of every channel, and counts the samples
+ * at or near full scale in the same pass */
+typedef void (*PamaMeterKernelFunc)(const gfloat *samples, gsize n_frames, guint channels, gfloat *peaks, gfloat *rms, PamaMeterOvers *overs);
+
+typedef struct
+{
+	const gchar         *name;
+	PamaMeterKernelFunc  reduce;
+} PamaMeterKernel;
+
+/* The K-weighting of ITU-R BS.1770: a high shelf for the acoustic effect of
+ * the head, then a high-pass. Filters at most this many channels. */
+#define PAMA_K_WEIGHTING_MAX_CHANNELS 2
+
+typedef struct
+{
+	gdouble b[2][3], a[2][3];                      /* shelf, then high-pass */
+	gdouble z[2][2][PAMA_K_WEIGHTING_MAX_CHANNELS]; /* transposed direct form II state */
+} PamaKWeighting;
+
+void                   pama_meter_kernels_reduce(const gfloat *samples, gsize n_frames, guint channels, gfloat *peaks, gfloat *rms, PamaMeterOvers *overs);
+const PamaMeterKernel *pama_meter_kernels_get_available(guint *n_kernels);
+const gchar           *pama_meter_kernels_get_name(void);
+
+void pama_k_weighting_init  (PamaKWeighting *k, guint rate);
+void pama_k_weighting_filter(PamaKWeighting *k, const gfloat *samples, gsize n_frames, guint channels, gdouble *sum_squares);
+
+G_END_DECLS
+
+#endif /* PAMA_METER_KERNELS_H */
@@ -31,6 +31,22 @@ struct _PamaPopupPrivate
 {
 	GtkWidget *align_widget;
 	PanelAppletOrient orientation;
+	gulong align_allocate_handler_id;
+
+	/* Realignment state, so that a burst of allocations moves the window at most once */
+	guint             realign_idle_id;
+	gboolean          anchor_valid, monitor_valid, aligned;
+	gint              anchor_x, anchor_y;
+	GdkRectangle      monitor;
+	GtkRequisition    aligned_req;
+	gint              aligned_anchor_x, aligned_anchor_y;
+	PanelAppletOrient aligned_orientation;
+
+	GdkScreen *screen;
+	gulong     monitors_changed_handler_id;
+
+	/* Hidden until the user starts typing */
+	GtkWidget *filter_entry;
 };
 
 G_DEFINE_TYPE(PamaPopup, pama_popup, GTK_TYPE_WINDOW);
@@ -38,6 +54,10 @@ G_DEFINE_TYPE(PamaPopup, pama_popup, GTK_TYPE_WINDOW);
 
 static void pama_popup_map_event(GtkWidget *widget, GdkEvent *event, gpointer data);
 static void pama_popup_size_allocated(GtkWidget *widget, GtkAllocation *allocation, gpointer data);
+static void pama_popup_align_widget_size_allocated(GtkWidget *widget, GtkAllocation *allocation, gpointer data);
+static void pama_popup_monitors_changed(GdkScreen *screen, gpointer data);
+static gboolean pama_popup_realign_idle(gpointer data);
+static void pama_popup_move_to_anchor(PamaPopup *popup, const GtkRequisition *window_req);
 static void pama_popup_child_menu_hidden(GtkWidget *menu, gpointer data);
 static void pama_popup_child_button_clicked(GtkButton *button, gpointer data);
 static gboolean pama_popup_restore_grabs(PamaPopup *popup);
@@ -70,8 +90,29 @@ static void pama_popup_dispose(GObject *gobject)
 	/*PamaPopup *popup = PAMA_POPUP(object);*/
 	PamaPopupPrivate *priv = PAMA_POPUP_GET_PRIVATE(gobject);
 
+	if (priv->realign_idle_id)
+	{
+		g_source_remove(priv->realign_idle_id);
+		priv->realign_idle_id = 0;
+	}
+
+	if (priv->screen)
+	{
+		g_signal_handler_disconnect(priv->screen, priv->monitors_changed_handler_id);
+		priv->monitors_changed_handler_id = 0;
+		priv->screen = NULL;
+	}
+
+	if (priv->filter_entry)
+	{
+		g_object_unref(priv->filter_entry);
+		priv->filter_entry = NULL;
+	}
+
 	if (priv->align_widget)
 	{
+		g_signal_handler_disconnect(priv->align_widget, priv->align_allocate_handler_id);
+		priv->align_allocate_handler_id = 0;
 		g_object_unref(priv->align_widget);
 		priv->align_widget = NULL;
 	}
@@ -79,6 +120,19 @@ static void pama_popup_dispose(GObject *gobject)
 	G_OBJECT_CLASS(pama_popup_parent_class)->dispose(gobject);
 }
 
+// Sets the entry that printable key presses anywhere in the popup are sent
+// to. The entry should be packed with no-show-all set; it is shown on the
+// first key press and hidden again by ESC.
+void pama_popup_set_filter_entry(PamaPopup *popup, GtkEntry *entry)
+{
+	PamaPopupPrivate *priv = PAMA_POPUP_GET_PRIVATE(popup);
+
+	if (priv->filter_entry)
+		g_object_unref(priv->filter_entry);
+
+	priv->filter_entry = entry ? g_object_ref(entry) : NULL;
+}
+
 void pama_popup_show(PamaPopup *popup)
 {
 	gtk_widget_show_all(GTK_WIDGET(popup));
@@ -106,85 +160,181 @@ static void pama_popup_map_event(GtkWidget *widget, GdkEvent *event, gpointer da
 void pama_popup_set_popup_alignment(PamaPopup *popup, GtkWidget *align_widget, PanelAppletOrient orientation)
 {
 	PamaPopupPrivate *priv = PAMA_POPUP_GET_PRIVATE(popup);
+	GdkScreen *screen;
 
 	if (align_widget != priv->align_widget)
 	{
 		/* Unref the old alignment widget, if there was one */
 		if (priv->align_widget)
 		{
+			g_signal_handler_disconnect(priv->align_widget, priv->align_allocate_handler_id);
 			g_object_unref(priv->align_widget);
 		}
 
 		priv->align_widget = align_widget;
 		g_object_ref(priv->align_widget);
+		priv->align_allocate_handler_id = g_signal_connect(priv->align_widget, "size-allocate", G_CALLBACK(pama_popup_align_widget_size_allocated), popup);
 	}
 	priv->orientation = orientation;
 
+	/* Monitor geometry is cached until the screen reports a change */
+	screen = gtk_widget_get_screen(align_widget);
+	if (screen != priv->screen)
+	{
+		if (priv->screen)
+			g_signal_handler_disconnect(priv->screen, priv->monitors_changed_handler_id);
+
+		priv->screen = screen;
+		priv->monitors_changed_handler_id = g_signal_connect(screen, "monitors-changed", G_CALLBACK(pama_popup_monitors_changed), popup);
+	}
+
+	priv->anchor_valid = FALSE;
+	priv->monitor_valid = FALSE;
+
 	pama_popup_realign(popup);
 }
 
+// Recalculate the popup position straight away.
 void pama_popup_realign(PamaPopup *popup)
 {
 	GtkRequisition window_req;
+
+	gtk_widget_size_request(GTK_WIDGET(popup), &window_req);
+	pama_popup_move_to_anchor(popup, &window_req);
+}
+
+// Recalculate the popup position once the current batch of resizes has been processed.
+void pama_popup_queue_realign(PamaPopup *popup)
+{
+	PamaPopupPrivate *priv = PAMA_POPUP_GET_PRIVATE(popup);
+
+	/* Resizes run at GTK_PRIORITY_RESIZE, so this runs once per frame, after all of them */
+	if (!priv->realign_idle_id)
+		priv->realign_idle_id = g_idle_add_full(GDK_PRIORITY_REDRAW, pama_popup_realign_idle, popup, NULL);
+}
+
+static gboolean pama_popup_realign_idle(gpointer data)
+{
+	PamaPopup *popup = PAMA_POPUP(data);
+	PamaPopupPrivate *priv = PAMA_POPUP_GET_PRIVATE(popup);
+	GtkRequisition window_req;
+
+	priv->realign_idle_id = 0;
+
+	/* The resize that queued this has already computed the requisition */
+	gtk_widget_get_child_requisition(GTK_WIDGET(popup), &window_req);
+	pama_popup_move_to_anchor(popup, &window_req);
+
+	return FALSE;
+}
+
+static void pama_popup_move_to_anchor(PamaPopup *popup, const GtkRequisition *window_req)
+{
 	int x, y;
-	GdkScreen *screen;
-	GdkRectangle monitor;
-	int monitor_idx;
+	GdkRectangle *monitor;
 	PamaPopupPrivate *priv = PAMA_POPUP_GET_PRIVATE(popup);
 
-	if (!priv->align_widget)
+	if (!priv->align_widget || !priv->align_widget->window)
 		return;
-	
-	gdk_window_get_origin(priv->align_widget->window, &x, &y);
-	x += priv->align_widget->allocation.x;
-	y += priv->align_widget->allocation.y;
-	gtk_widget_size_request(GTK_WIDGET(popup), &window_req);
-	
-	screen = gtk_window_get_screen(GTK_WINDOW(popup));
-	monitor_idx = gdk_screen_get_monitor_at_window(screen, priv->align_widget->window);
-	gdk_screen_get_monitor_geometry(screen, monitor_idx, &monitor);
-	
+
+	if (!priv->anchor_valid)
+	{
+		gdk_window_get_origin(priv->align_widget->window, &priv->anchor_x, &priv->anchor_y);
+		priv->anchor_x += priv->align_widget->allocation.x;
+		priv->anchor_y += priv->align_widget->allocation.y;
+		priv->anchor_valid = TRUE;
+
+		/* The anchor may have moved onto another monitor */
+		priv->monitor_valid = FALSE;
+	}
+
+	if (!priv->monitor_valid)
+	{
+		int monitor_idx = gdk_screen_get_monitor_at_point(priv->screen, priv->anchor_x, priv->anchor_y);
+		gdk_screen_get_monitor_geometry(priv->screen, monitor_idx, &priv->monitor);
+		priv->monitor_valid = TRUE;
+	}
+
+	/* Nothing that affects the position has changed since the last move */
+	if (priv->aligned &&
+	    priv->aligned_req.width  == window_req->width  &&
+	    priv->aligned_req.height == window_req->height &&
+	    priv->aligned_anchor_x   == priv->anchor_x     &&
+	    priv->aligned_anchor_y   == priv->anchor_y     &&
+	    priv->aligned_orientation == priv->orientation)
+		return;
+
+	x = priv->anchor_x;
+	y = priv->anchor_y;
+	monitor = &priv->monitor;
+
 	switch (priv->orientation)
 	{
 		case PANEL_APPLET_ORIENT_UP:
-			y -= window_req.height - 2;
+			y -= window_req->height - 2;
 			
-			if (x + window_req.width > monitor.x + monitor.width)
-				x = monitor.x + monitor.width - window_req.width;
+			if (x + window_req->width > monitor->x + monitor->width)
+				x = monitor->x + monitor->width - window_req->width;
 			
 			break;
 			
 		case PANEL_APPLET_ORIENT_DOWN:
 			y += priv->align_widget->allocation.height + 2;
 			
-			if (x + window_req.width > monitor.x + monitor.width)
-				x = monitor.x + monitor.width - window_req.width;
+			if (x + window_req->width > monitor->x + monitor->width)
+				x = monitor->x + monitor->width - window_req->width;
 						
 			break;
 			
 		case PANEL_APPLET_ORIENT_RIGHT:
 			x += priv->align_widget->allocation.width + 2;
 			
-			if (y + window_req.height > monitor.y + monitor.height)
-				y = monitor.y + monitor.height - window_req.height;
+			if (y + window_req->height > monitor->y + monitor->height)
+				y = monitor->y + monitor->height - window_req->height;
 			
 			break;
 			
 		case PANEL_APPLET_ORIENT_LEFT:
-			x -= window_req.width - 2;
+			x -= window_req->width - 2;
 			
-			if (y + window_req.height > monitor.y + monitor.height)
-				y = monitor.y + monitor.height - window_req.height;
+			if (y + window_req->height > monitor->y + monitor->height)
+				y = monitor->y + monitor->height - window_req->height;
 			
 			break;
 	}
 	
 	gtk_window_move(GTK_WINDOW(popup), x, y);
+
+	priv->aligned             = TRUE;
+	priv->aligned_req         = *window_req;
+	priv->aligned_anchor_x    = priv->anchor_x;
+	priv->aligned_anchor_y    = priv->anchor_y;
+	priv->aligned_orientation = priv->orientation;
 }
 
 static void pama_popup_size_allocated(GtkWidget *widget, GtkAllocation *allocation, gpointer data)
 {
-	pama_popup_realign(PAMA_POPUP(widget));
+	pama_popup_queue_realign(PAMA_POPUP(widget));
+}
+
+// The anchor's screen position has to be queried again after it is reallocated.
+static void pama_popup_align_widget_size_allocated(GtkWidget *widget, GtkAllocation *allocation, gpointer data)
+{
+	PamaPopup *popup = PAMA_POPUP(data);
+	PamaPopupPrivate *priv = PAMA_POPUP_GET_PRIVATE(popup);
+
+	priv->anchor_valid = FALSE;
+	pama_popup_queue_realign(popup);
+}
+
+static void pama_popup_monitors_changed(GdkScreen *screen, gpointer data)
+{
+	PamaPopup *popup = PAMA_POPUP(data);
+	PamaPopupPrivate *priv = PAMA_POPUP_GET_PRIVATE(popup);
+
+	priv->monitor_valid = FALSE;
+	priv->aligned = FALSE;
+	pama_popup_queue_realign(popup);
 }
 
 // Add grab-broken listeners to children when they take one of the grabs.
@@ -203,8 +353,9 @@ static gboolean pama_popup_grab_broken(GtkWidget *widget, GdkEventGrabBroken *ev
 		}
 		else if (GTK_IS_MENU(child_widget))
 		{
-			// Is a menu; restore grabs when it is unmapped
-			g_signal_connect(child_widget, "hide", G_CALLBACK(pama_popup_child_menu_hidden), widget);
+			// Is a menu; restore grabs when it is unmapped. Menus may be kept and shown again, so only connect once.
+			if (!g_signal_handler_find(child_widget, G_SIGNAL_MATCH_FUNC | G_SIGNAL_MATCH_DATA, 0, 0, NULL, pama_popup_child_menu_hidden, widget))
+				g_signal_connect(child_widget, "hide", G_CALLBACK(pama_popup_child_menu_hidden), widget);
 		}
 	}
 	else
@@ -249,14 +400,35 @@ static gboolean pama_popup_button_pressed(GtkWidget *widget, GdkEventButton *eve
 	return FALSE;
 }
 
-// Allow closing the popup by pressing ESC
+// Allow closing the popup by pressing ESC, and start filtering when the user types
 static gboolean pama_popup_key_pressed(GtkWidget *widget, GdkEventKey *event, gpointer data)
 {
+	PamaPopupPrivate *priv = PAMA_POPUP_GET_PRIVATE(widget);
+	GtkWidget *entry = priv->filter_entry;
+
 	if (event->keyval == GDK_Escape)
 	{
+		/* The first ESC only clears the filter */
+		if (entry && GTK_WIDGET_VISIBLE(entry))
+		{
+			gtk_entry_set_text(GTK_ENTRY(entry), "");
+			gtk_widget_hide(entry);
+			return TRUE;
+		}
+
 		gtk_widget_destroy(widget);
 		return TRUE;
 	}
 
+	if (entry && !GTK_WIDGET_HAS_FOCUS(entry) &&
+	    !(event->state & (GDK_CONTROL_MASK | GDK_MOD1_MASK)) &&
+	    g_unichar_isgraph(gdk_keyval_to_unicode(event->keyval)))
+	{
+		gtk_widget_show(entry);
+		gtk_widget_grab_focus(entry);
+		gtk_editable_set_position(GTK_EDITABLE(entry), -1);
+		return gtk_widget_event(entry, (GdkEvent *) event);
+	}
+
 	return FALSE;
 }
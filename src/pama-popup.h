@@ -53,6 +53,8 @@ GType pama_popup_get_type();
 
 void pama_popup_set_popup_alignment(PamaPopup *popup, GtkWidget *align_to, PanelAppletOrient orientation);
 void pama_popup_realign(PamaPopup *popup);
+void pama_popup_queue_realign(PamaPopup *popup);
+void pama_popup_set_filter_entry(PamaPopup *popup, GtkEntry *entry);
 void pama_popup_show(PamaPopup *popup);
 
 G_END_DECLS
@@ -36,6 +36,7 @@ struct _PamaPulseClientPrivate
 	GString *icon_name;
 	GString *application_id;
 	GString *hostname;
+	GString *process_binary;
 	gboolean is_local;
 };
 
@@ -56,6 +57,7 @@ enum
 	PROP_ICON_NAME,
 	PROP_APPLICATION_ID,
 	PROP_HOSTNAME,
+	PROP_PROCESS_BINARY,
 	PROP_IS_LOCAL
 };
 
@@ -105,6 +107,13 @@ static void pama_pulse_client_class_init(PamaPulseClientClass *klass)
 	                            G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS);
 	g_object_class_install_property(gobject_class, PROP_HOSTNAME, pspec);
 
+	pspec = g_param_spec_string("process-binary",
+	                            "Client process binary",
+	                            "Name of the executable this client is running in.",
+	                            "",
+	                            G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_PROCESS_BINARY, pspec);
+
 	pspec = g_param_spec_boolean("is-local",
 	                             "Client is local",
 	                             "Indicates whether this client is running on the same machine as the daemon",
@@ -125,6 +134,7 @@ static void pama_pulse_client_init(PamaPulseClient *self)
 	priv->icon_name = g_string_new("");
 	priv->application_id = g_string_new("");
 	priv->hostname = g_string_new("");
+	priv->process_binary = g_string_new("");
 }
 
 static void pama_pulse_client_finalize(GObject *gobject)
@@ -134,6 +144,8 @@ static void pama_pulse_client_finalize(GObject *gobject)
 	g_string_free(self->priv->name, TRUE);
 	g_string_free(self->priv->icon_name, TRUE);
 	g_string_free(self->priv->application_id, TRUE);
+	g_string_free(self->priv->hostname, TRUE);
+	g_string_free(self->priv->process_binary, TRUE);
 
 	/* Chain up to the parent class */
 	G_OBJECT_CLASS (pama_pulse_client_parent_class)->finalize (gobject);
@@ -165,6 +177,10 @@ static void pama_pulse_client_get_property(GObject *gobject, guint property_id,
 			g_value_set_string(value, self->priv->hostname->str);
 			break;
 
+		case PROP_PROCESS_BINARY:
+			g_value_set_string(value, self->priv->process_binary->str);
+			break;
+
 		case PROP_IS_LOCAL:
 			g_value_set_boolean(value, self->priv->is_local);
 			break;
@@ -200,6 +216,10 @@ static void pama_pulse_client_set_property(GObject *gobject, guint property_id,
 			g_string_assign(self->priv->hostname, g_value_get_string(value));
 			break;
 
+		case PROP_PROCESS_BINARY:
+			g_string_assign(self->priv->process_binary, g_value_get_string(value));
+			break;
+
 		case PROP_IS_LOCAL:
 			self->priv->is_local = g_value_get_boolean(value);
 			break;
@@ -25,6 +25,7 @@
 #include <glib/gi18n.h>
  
 #include "pama-pulse-context.h"
+#include "pama-icon-cache.h"
 
 #define PAMA_PULSE_CONTEXT_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE ((obj), PAMA_TYPE_PULSE_CONTEXT, PamaPulseContextPrivate))
 G_DEFINE_TYPE(PamaPulseContext, pama_pulse_context, G_TYPE_OBJECT);
@@ -761,10 +762,15 @@ static void sink_cb         (pa_context *c, const pa_sink_info          *i, int
 	if (sink)
 	{
 		g_object_set(sink, 
-		             "volume",      (guint)    pa_cvolume_avg(&i->volume),
+		             "volume",      (guint)    pa_cvolume_max(&i->volume),
 		             "base-volume", (guint)    i->base_volume,
 		             "channels",    (guchar)   i->channel_map.channels,
+		             "cvolume",                &i->volume,
+		             "channel-map",            &i->channel_map,
 		             "mute",        (gboolean) i->mute,
+		             "state",       (gint)     i->state,
+		             "latency",            (guint64) i->latency,
+		             "configured-latency", (guint64) i->configured_latency,
 		             "description",            description,
 		             "hostname",               (NULL != hostname) ? hostname : "",
 		             "icon-name",   (gchar *)  pa_proplist_gets(i->proplist, "device.icon_name"),
@@ -777,10 +783,15 @@ static void sink_cb         (pa_context *c, const pa_sink_info          *i, int
 		sink = g_object_new(PAMA_TYPE_PULSE_SINK, 
 	                        "context",                self,
 	                        "index",       (guint)    i->index,
-	                        "volume",      (guint)    pa_cvolume_avg(&i->volume),
+	                        "volume",      (guint)    pa_cvolume_max(&i->volume),
 		                    "base-volume", (guint)    i->base_volume,
 	                        "channels",    (guchar)   i->channel_map.channels,
+	                        "cvolume",                &i->volume,
+	                        "channel-map",            &i->channel_map,
 	                        "mute",        (gboolean) i->mute,
+	                        "state",       (gint)     i->state,
+	                        "latency",            (guint64) i->latency,
+	                        "configured-latency", (guint64) i->configured_latency,
 	                        "name",                   i->name,
 	                        "description",            description,
 	                        "hostname",               (NULL != hostname) ? hostname : "",
@@ -817,10 +828,15 @@ static void source_cb       (pa_context *c, const pa_source_info        *i, int
 	if (source)
 	{
 		g_object_set(source,
-		             "volume",      (guint)    pa_cvolume_avg(&i->volume),
+		             "volume",      (guint)    pa_cvolume_max(&i->volume),
 		             "base-volume", (guint)    i->base_volume,
 		             "channels",    (guchar)   i->channel_map.channels,
+		             "cvolume",                &i->volume,
+		             "channel-map",            &i->channel_map,
 		             "mute",        (gboolean) i->mute,
+		             "state",       (gint)     i->state,
+		             "latency",            (guint64) i->latency,
+		             "configured-latency", (guint64) i->configured_latency,
 		             "description",            description,
 	                 "hostname",               (NULL != hostname) ? hostname : "",
 		             "icon-name",   (gchar *)  pa_proplist_gets(i->proplist, "device.icon_name"),
@@ -831,10 +847,15 @@ static void source_cb       (pa_context *c, const pa_source_info        *i, int
 		source = g_object_new(PAMA_TYPE_PULSE_SOURCE, 
 	                          "context",     self,
 	                          "index",       (guint)    i->index,
-	                          "volume",      (guint)    pa_cvolume_avg(&i->volume),
+	                          "volume",      (guint)    pa_cvolume_max(&i->volume),
 		                      "base-volume", (guint)    i->base_volume,
 	                          "channels",    (guchar)   i->channel_map.channels,
+	                          "cvolume",                &i->volume,
+	                          "channel-map",            &i->channel_map,
 	                          "mute",        (gboolean) i->mute,
+	                          "state",       (gint)     i->state,
+	                          "latency",            (guint64) i->latency,
+	                          "configured-latency", (guint64) i->configured_latency,
 	                          "name",                   i->name,
 	                          "description",            description,
 	                          "hostname",               (NULL != hostname) ? hostname : "",
@@ -859,9 +880,15 @@ static void client_cb       (pa_context *c, const pa_client_info        *i, int
 	gboolean is_local;
 	gchar *application_id = (gchar *)pa_proplist_gets(i->proplist, "application.id");
 	gchar *hostname = (gchar *) pa_proplist_gets(i->proplist, "application.process.host");
+	gchar *process_binary = (gchar *) pa_proplist_gets(i->proplist, "application.process.binary");
+	gchar *icon_name = (gchar *) pa_proplist_gets(i->proplist, "application.icon_name");
 
 	if (!application_id)
 		application_id = "";
+	if (!process_binary)
+		process_binary = "";
+	if (!icon_name)
+		icon_name = "";
 	if (!hostname)
 		hostname = self->priv->hostname->str;
 	
@@ -873,7 +900,9 @@ static void client_cb       (pa_context *c, const pa_client_info        *i, int
 		             "name", i->name,
 		             "hostname", hostname,
 		             "is-local", is_local,
+		             "icon-name", icon_name,
 		             "application-id", application_id,
+		             "process-binary", process_binary,
 		             NULL);
 	}
 	else
@@ -883,9 +912,15 @@ static void client_cb       (pa_context *c, const pa_client_info        *i, int
 		                      "name",          i->name,
 		                      "hostname",      hostname,
 		                      "is-local",      is_local,
+		                      "icon-name",     icon_name,
 		                      "application-id", application_id,
+		                      "process-binary", process_binary,
 		                      NULL);
 		self->priv->clients = g_slist_prepend(self->priv->clients, client);
+
+		// Have the icon decoded before the client's first stream shows up
+		if (is_local)
+			pama_icon_cache_prefetch(icon_name);
 		g_signal_emit(self, context_signals[CLIENT_ADDED_SIGNAL], 0, i->index);
 	}
 }
@@ -909,9 +944,14 @@ static void sink_input_cb   (pa_context *c, const pa_sink_input_info    *i, int
 	if (sink_input)
 	{
 		g_object_set(sink_input,
-		             "volume",    (guint)    pa_cvolume_avg(&i->volume),
+		             "volume",    (guint)    pa_cvolume_max(&i->volume),
 		             "channels",  (guchar)   i->channel_map.channels,
+		             "cvolume",              &i->volume,
+		             "channel-map",          &i->channel_map,
 		             "mute",      (gboolean) i->mute,
+		             "corked",    (gboolean) i->corked,
+		             "buffer-latency", (guint64) i->buffer_usec,
+		             "sink-latency",   (guint64) i->sink_usec,
 		             "name",                 i->name,
 		             "sink",                 sink,
 		             "icon-name",            icon_name,
@@ -925,9 +965,14 @@ static void sink_input_cb   (pa_context *c, const pa_sink_input_info    *i, int
 		sink_input = g_object_new(PAMA_TYPE_PULSE_SINK_INPUT, 
 		                          "context",              self,
 		                          "index",     (guint)    i->index,
-		                          "volume",    (guint)    pa_cvolume_avg(&i->volume),
+		                          "volume",    (guint)    pa_cvolume_max(&i->volume),
 		                          "channels",  (guchar)   i->channel_map.channels,
+		                          "cvolume",              &i->volume,
+		                          "channel-map",          &i->channel_map,
 		                          "mute",      (gboolean) i->mute,
+		                          "corked",    (gboolean) i->corked,
+		                          "buffer-latency", (guint64) i->buffer_usec,
+		                          "sink-latency",   (guint64) i->sink_usec,
 		                          "name",                 i->name,
 		                          "client",               client,
 		                          "sink",                 sink,
@@ -0,0 +1,630 @@
+/*
+ * pama-pulse-meter.c: A GObject wrapper for a PulseAudio peak detection stream
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+ 
+#include <math.h>
+#include <string.h>
+#include "pama-pulse-meter.h"
+#include "pama-meter-kernels.h"
+#include "pama-clip-history.h"
+
+#define PAMA_PULSE_METER_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE((obj), PAMA_TYPE_PULSE_METER, PamaPulseMeterPrivate))
+
+/* With PA_STREAM_PEAK_DETECT the server sends one peak per sample, so the
+ * sample rate is the number of peaks delivered each second */
+#define METER_RATE 25
+
+/* Application meters are only there to tell which one is making noise, and
+ * there may be many of them, so they get far fewer */
+#define METER_STREAM_RATE 10
+
+/* Loudness needs the audio itself. The K-weighting only shapes the response
+ * above about 1.5kHz a little, so 16kHz keeps nearly all of it while a dozen
+ * stereo meters still filter under half a million samples a second. Loudness
+ * is measured over 100ms blocks: momentary over the last 400ms of them and
+ * short-term over the last 3s, as in EBU R128. */
+#define LOUDNESS_RATE              16000
+#define LOUDNESS_BLOCK_FRAMES      (LOUDNESS_RATE / 10)
+#define LOUDNESS_MOMENTARY_BLOCKS  4
+#define LOUDNESS_SHORT_TERM_BLOCKS 30
+
+/* Near full scale for this long, in seconds, counts as running over rather
+ * than as a stray peak. Samples near full scale at most METER_OVER_GAP
+ * seconds apart, or in successive frames, belong to the same run, so a loud
+ * waveform that swings through zero in between still counts as one. */
+#define METER_OVER_DURATION 0.2
+#define METER_OVER_GAP      0.05
+
+struct _PamaPulseMeterPrivate
+{
+	PamaPulseContext   *context;
+	PamaPulseSource    *source;
+	PamaPulseSinkInput *sink_input;
+	pa_stream          *stream;
+	guint               rate;
+	gdouble             level;
+
+	GObject            *history_owner; /* weak; where clipping is recorded */
+	guint64             frames;         /* read so far */
+	guint64             run_start, run_end; /* frames of the current run near full scale */
+	gboolean            run_counted;
+	gboolean            clipping;
+
+	gboolean            loudness;
+	guint               channels;
+	PamaKWeighting      k_weighting;
+	gdouble             block_sums[PAMA_K_WEIGHTING_MAX_CHANNELS];
+	gsize               block_frames;
+	gdouble             block_powers[LOUDNESS_SHORT_TERM_BLOCKS]; /* ring of mean squares, one per block */
+	guint               n_blocks;
+	gdouble             momentary, short_term;
+};
+
+static void     pama_pulse_meter_init(PamaPulseMeter *meter);
+static void     pama_pulse_meter_class_init(PamaPulseMeterClass *klass);
+static GObject* pama_pulse_meter_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties);
+static void     pama_pulse_meter_dispose(GObject *gobject);
+static void     pama_pulse_meter_get_property(GObject *gobject, guint property_id,       GValue *value, GParamSpec *pspec);
+static void     pama_pulse_meter_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec);
+
+static void     pama_pulse_meter_read(pa_stream *stream, size_t length, void *userdata);
+static guint    pama_pulse_meter_track_overs(PamaPulseMeter *self, const gfloat *samples, gsize n_frames, guint channels, guint *clipped);
+static void     pama_pulse_meter_read_loudness(PamaPulseMeter *self, const gfloat *samples, gsize n_frames);
+static gdouble  pama_pulse_meter_mean_loudness(PamaPulseMeter *self, guint n_blocks);
+static void     pama_pulse_meter_state_changed(pa_stream *stream, void *userdata);
+
+G_DEFINE_TYPE(PamaPulseMeter, pama_pulse_meter, G_TYPE_OBJECT);
+
+static gboolean measure_loudness = FALSE;
+
+enum
+{
+	PROP_0,
+
+	PROP_CONTEXT,
+	PROP_SOURCE,
+	PROP_SINK_INPUT,
+	PROP_LEVEL,
+	PROP_CLIPPING,
+	PROP_MOMENTARY,
+	PROP_SHORT_TERM
+};
+
+static void pama_pulse_meter_class_init(PamaPulseMeterClass *klass)
+{
+	GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+	GParamSpec   *pspec;
+	
+	gobject_class->constructor  = pama_pulse_meter_constructor;
+	gobject_class->dispose      = pama_pulse_meter_dispose;
+	gobject_class->get_property = pama_pulse_meter_get_property;
+	gobject_class->set_property = pama_pulse_meter_set_property;
+
+	pspec = g_param_spec_object("context",
+	                            "Pulse context object",
+	                            "The PamaPulseContext to record through.",
+	                            PAMA_TYPE_PULSE_CONTEXT,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_CONTEXT, pspec);
+
+	pspec = g_param_spec_object("source",
+	                            "Source",
+	                            "The PamaPulseSource whose level is measured; for a sink, its monitor.",
+	                            PAMA_TYPE_PULSE_SOURCE,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_SOURCE, pspec);
+
+	pspec = g_param_spec_object("sink-input",
+	                            "Sink input",
+	                            "The PamaPulseSinkInput to measure on its own, or NULL for the whole source.",
+	                            PAMA_TYPE_PULSE_SINK_INPUT,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_SINK_INPUT, pspec);
+
+	pspec = g_param_spec_double("level",
+	                            "Level",
+	                            "The most recent peak level, from 0 to 1.",
+	                            0.0,
+	                            1.0,
+	                            0.0,
+	                            G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_LEVEL, pspec);
+
+	pspec = g_param_spec_boolean("clipping",
+	                             "Clipping",
+	                             "Whether the source or sink input clipped or ran near full scale lately.",
+	                             FALSE,
+	                             G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_CLIPPING, pspec);
+
+	pspec = g_param_spec_double("momentary",
+	                            "Momentary loudness",
+	                            "The loudness over the last 400ms in LUFS, or minus infinity in silence. Only measured when loudness is.",
+	                            -G_MAXDOUBLE,
+	                            G_MAXDOUBLE,
+	                            -G_MAXDOUBLE,
+	                            G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_MOMENTARY, pspec);
+
+	pspec = g_param_spec_double("short-term",
+	                            "Short-term loudness",
+	                            "The loudness over the last 3s in LUFS, or minus infinity in silence. Only measured when loudness is.",
+	                            -G_MAXDOUBLE,
+	                            G_MAXDOUBLE,
+	                            -G_MAXDOUBLE,
+	                            G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_SHORT_TERM, pspec);
+
+	g_type_class_add_private(klass, sizeof(PamaPulseMeterPrivate));
+}
+
+static void pama_pulse_meter_init(PamaPulseMeter *self)
+{
+	self->priv = PAMA_PULSE_METER_GET_PRIVATE(self);
+	self->priv->momentary  = -INFINITY;
+	self->priv->short_term = -INFINITY;
+}
+
+static GObject* pama_pulse_meter_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties)
+{
+	GObject *gobject = G_OBJECT_CLASS(pama_pulse_meter_parent_class)->constructor(gtype, n_properties, properties);
+	PamaPulseMeter *self = PAMA_PULSE_METER(gobject);
+	pa_context     *c;
+	pa_sample_spec  spec;
+	pa_buffer_attr  attr;
+	guint           index;
+	guint           sink_input_index = PA_INVALID_INDEX;
+	guint           clipped, overs;
+	guchar          channels;
+	gchar          *device;
+	pa_stream_flags_t flags = PA_STREAM_DONT_MOVE | PA_STREAM_ADJUST_LATENCY;
+
+	if (NULL == self->priv->context)
+		g_error("An attempt was made to create a meter with no context.");
+	if (NULL == self->priv->source)
+		g_error("An attempt was made to create a meter with no source.");
+
+	g_object_get(self->priv->context,
+	             "context", &c,
+	             NULL);
+	g_object_get(self->priv->source,
+	             "index",    &index,
+	             "channels", &channels,
+	             NULL);
+	/* Clipping is recorded on what is measured, which must not be kept alive either */
+	self->priv->history_owner = self->priv->sink_input ? G_OBJECT(self->priv->sink_input) : G_OBJECT(self->priv->source);
+	g_object_add_weak_pointer(self->priv->history_owner, (gpointer *)&self->priv->history_owner);
+	self->priv->clipping = pama_clip_history_get(self->priv->history_owner, &clipped, &overs);
+
+	if (self->priv->sink_input)
+	{
+		g_object_get(self->priv->sink_input,
+		             "index",    &sink_input_index,
+		             "channels", &channels,
+		             NULL);
+		g_object_unref(self->priv->sink_input);
+		self->priv->sink_input = NULL;
+	}
+
+	/* The stream keeps the connection alive by itself, and holding on to the
+	 * source would keep its widget from seeing it removed */
+	g_object_unref(self->priv->source);
+	self->priv->source = NULL;
+	g_object_unref(self->priv->context);
+	self->priv->context = NULL;
+
+	if (PA_CONTEXT_READY != pa_context_get_state(c))
+		return gobject;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.maxlength = (uint32_t) -1;
+	spec.format    = PA_SAMPLE_FLOAT32;
+
+	self->priv->loudness = measure_loudness;
+	if (self->priv->loudness)
+	{
+		/* Surround is left to the server to mix down to stereo */
+		self->priv->channels = CLAMP(channels, 1, PAMA_K_WEIGHTING_MAX_CHANNELS);
+		pama_k_weighting_init(&self->priv->k_weighting, LOUDNESS_RATE);
+
+		spec.rate     = LOUDNESS_RATE;
+		spec.channels = self->priv->channels;
+		attr.fragsize = LOUDNESS_BLOCK_FRAMES * pa_frame_size(&spec);
+	}
+	else
+	{
+		spec.rate     = PA_INVALID_INDEX == sink_input_index ? METER_RATE : METER_STREAM_RATE;
+		spec.channels = 1;
+
+		/* One peak per fragment, so each one is delivered as soon as it is measured */
+		attr.fragsize = sizeof(float);
+		flags |= PA_STREAM_PEAK_DETECT;
+	}
+
+	self->priv->rate = spec.rate;
+
+	self->priv->stream = pa_stream_new(c, self->priv->loudness ? _("Loudness") : _("Peak detect"), &spec, NULL);
+	if (NULL == self->priv->stream)
+		return gobject;
+
+	pa_stream_set_read_callback (self->priv->stream, pama_pulse_meter_read,          self);
+	pa_stream_set_state_callback(self->priv->stream, pama_pulse_meter_state_changed, self);
+
+	/* Records just this one application from its sink's monitor */
+	if (PA_INVALID_INDEX != sink_input_index)
+		pa_stream_set_monitor_stream(self->priv->stream, sink_input_index);
+
+	device = g_strdup_printf("%u", index);
+
+	if (pa_stream_connect_record(self->priv->stream, device, &attr, flags) < 0)
+	{
+		pa_stream_unref(self->priv->stream);
+		self->priv->stream = NULL;
+	}
+	g_free(device);
+
+	return gobject;
+}
+static void pama_pulse_meter_dispose(GObject *gobject)
+{
+	PamaPulseMeter *self = PAMA_PULSE_METER(gobject);
+
+	if (self->priv->stream)
+	{
+		pa_stream_set_read_callback (self->priv->stream, NULL, NULL);
+		pa_stream_set_state_callback(self->priv->stream, NULL, NULL);
+		pa_stream_disconnect(self->priv->stream);
+		pa_stream_unref(self->priv->stream);
+		self->priv->stream = NULL;
+	}
+
+	if (self->priv->history_owner)
+	{
+		g_object_remove_weak_pointer(self->priv->history_owner, (gpointer *)&self->priv->history_owner);
+		self->priv->history_owner = NULL;
+	}
+
+	if (self->priv->source)
+	{
+		g_object_unref(self->priv->source);
+		self->priv->source = NULL;
+	}
+
+	if (self->priv->sink_input)
+	{
+		g_object_unref(self->priv->sink_input);
+		self->priv->sink_input = NULL;
+	}
+
+	if (self->priv->context)
+	{
+		g_object_unref(self->priv->context);
+		self->priv->context = NULL;
+	}
+
+	G_OBJECT_CLASS(pama_pulse_meter_parent_class)->dispose(gobject);
+}
+
+static void pama_pulse_meter_get_property(GObject *gobject, guint property_id,       GValue *value, GParamSpec *pspec)
+{
+	PamaPulseMeter *self = PAMA_PULSE_METER(gobject);
+
+	switch(property_id)
+	{
+		case PROP_LEVEL:
+			g_value_set_double(value, self->priv->level);
+			break;
+
+		case PROP_CLIPPING:
+			g_value_set_boolean(value, self->priv->clipping);
+			break;
+
+		case PROP_MOMENTARY:
+			g_value_set_double(value, self->priv->momentary);
+			break;
+
+		case PROP_SHORT_TERM:
+			g_value_set_double(value, self->priv->short_term);
+			break;
+
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID(self, property_id, pspec);
+			break;
+	}
+}
+static void pama_pulse_meter_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec)
+{
+	PamaPulseMeter *self = PAMA_PULSE_METER(gobject);
+
+	switch(property_id)
+	{
+		case PROP_CONTEXT:
+			self->priv->context = g_value_dup_object(value);
+			break;
+
+		case PROP_SOURCE:
+			self->priv->source = g_value_dup_object(value);
+			break;
+
+		case PROP_SINK_INPUT:
+			self->priv->sink_input = g_value_dup_object(value);
+			break;
+
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID(self, property_id, pspec);
+			break;
+	}
+}
+
+
+static void pama_pulse_meter_read(pa_stream *stream, size_t length, void *userdata)
+{
+	PamaPulseMeter *self = userdata;
+	const void *data;
+	gfloat peak = 0.0f, block_peaks[PAMA_K_WEIGHTING_MAX_CHANNELS], block_rms[PAMA_K_WEIGHTING_MAX_CHANNELS];
+	PamaMeterOvers block_overs;
+	gboolean got_peak = FALSE, clipping;
+	guint channels = self->priv->loudness ? self->priv->channels : 1;
+	gsize frame_size = channels * sizeof(float);
+	guint c, clipped = 0, overs = 0;
+
+	/* Peaks that queued up since the last callback are folded into one, so
+	 * a short burst between two redraws still shows */
+	while (pa_stream_readable_size(stream) > 0)
+	{
+		if (pa_stream_peek(stream, &data, &length) < 0 || 0 == length)
+			break;
+
+		if (data && length >= frame_size)
+		{
+			pama_meter_kernels_reduce(data, length / frame_size, channels, block_peaks, block_rms, &block_overs);
+			for (c = 0; c < channels; c++)
+				peak = MAX(peak, block_peaks[c]);
+			got_peak = TRUE;
+
+			/* The kernel only counts samples; chunks with samples near full
+			 * scale, which are rare, are looked at again to time the runs
+			 * and to count clipped frames, whatever the number of channels */
+			if (block_overs.near_clipped)
+				overs += pama_pulse_meter_track_overs(self, data, length / frame_size, channels, &clipped);
+			self->priv->frames += length / frame_size;
+
+			if (self->priv->loudness)
+				pama_pulse_meter_read_loudness(self, data, length / frame_size);
+		}
+
+		pa_stream_drop(stream);
+	}
+
+	if (!got_peak)
+		return;
+
+	self->priv->level = CLAMP(peak, 0.0f, 1.0f);
+	g_object_notify(G_OBJECT(self), "level");
+
+	if (NULL == self->priv->history_owner)
+		return;
+
+	pama_clip_history_add(self->priv->history_owner, clipped, overs);
+	clipping = pama_clip_history_get(self->priv->history_owner, &clipped, &overs);
+	if (clipping != self->priv->clipping)
+	{
+		self->priv->clipping = clipping;
+		g_object_notify(G_OBJECT(self), "clipping");
+	}
+}
+// Times runs of samples near full scale, in frames of the stream, so that how
+// long a run must last does not depend on how the server splits the stream
+// into chunks. Returns how many runs reached METER_OVER_DURATION, and adds the
+// frames with any channel at full scale to clipped.
+static guint pama_pulse_meter_track_overs(PamaPulseMeter *self, const gfloat *samples, gsize n_frames, guint channels, guint *clipped)
+{
+	PamaPulseMeterPrivate *priv = self->priv;
+	guint64 gap = MAX(1, (guint64)(priv->rate * METER_OVER_GAP));
+	guint64 duration = MAX(1, (guint64)(priv->rate * METER_OVER_DURATION));
+	guint64 frame;
+	gsize   i;
+	guint   c, overs = 0;
+
+	for (i = 0; i < n_frames; i++, samples += channels)
+	{
+		for (c = 0; c < channels; c++)
+		{
+			if (fabsf(samples[c]) >= PAMA_METER_NEAR_FULL_SCALE)
+				break;
+		}
+		if (c == channels)
+			continue;
+
+		for (; c < channels; c++)
+		{
+			if (fabsf(samples[c]) >= PAMA_METER_FULL_SCALE)
+			{
+				(*clipped)++;
+				break;
+			}
+		}
+
+		frame = priv->frames + i;
+		if (0 == priv->run_end || priv->run_end - 1 + gap < frame)
+		{
+			priv->run_start   = frame;
+			priv->run_counted = FALSE;
+		}
+		/* Stored one past the frame, so that 0 means no run yet */
+		priv->run_end = frame + 1;
+
+		if (!priv->run_counted && priv->run_end - priv->run_start >= duration)
+		{
+			priv->run_counted = TRUE;
+			overs++;
+		}
+	}
+
+	return overs;
+}
+// Feeds the K-weighting with a chunk of the stream, which need not line up
+// with the 100ms blocks, and updates the loudness after each complete block.
+static void pama_pulse_meter_read_loudness(PamaPulseMeter *self, const gfloat *samples, gsize n_frames)
+{
+	PamaPulseMeterPrivate *priv = self->priv;
+	gdouble power;
+	gsize   n;
+	guint   c;
+
+	while (n_frames > 0)
+	{
+		n = MIN(n_frames, LOUDNESS_BLOCK_FRAMES - priv->block_frames);
+		pama_k_weighting_filter(&priv->k_weighting, samples, n, priv->channels, priv->block_sums);
+		priv->block_frames += n;
+		samples  += n * priv->channels;
+		n_frames -= n;
+
+		if (priv->block_frames < LOUDNESS_BLOCK_FRAMES)
+			break;
+
+		/* Left, right and mono channels all have a weight of 1 */
+		power = 0.0;
+		for (c = 0; c < priv->channels; c++)
+		{
+			power += priv->block_sums[c] / LOUDNESS_BLOCK_FRAMES;
+			priv->block_sums[c] = 0.0;
+		}
+		priv->block_frames = 0;
+
+		priv->block_powers[priv->n_blocks % LOUDNESS_SHORT_TERM_BLOCKS] = power;
+		priv->n_blocks++;
+
+		priv->momentary  = pama_pulse_meter_mean_loudness(self, LOUDNESS_MOMENTARY_BLOCKS);
+		priv->short_term = pama_pulse_meter_mean_loudness(self, LOUDNESS_SHORT_TERM_BLOCKS);
+
+		g_object_freeze_notify(G_OBJECT(self));
+		g_object_notify(G_OBJECT(self), "momentary");
+		g_object_notify(G_OBJECT(self), "short-term");
+		g_object_thaw_notify(G_OBJECT(self));
+	}
+}
+// The loudness of the last n_blocks blocks, or of as many as there have been
+// since the meter started.
+static gdouble pama_pulse_meter_mean_loudness(PamaPulseMeter *self, guint n_blocks)
+{
+	PamaPulseMeterPrivate *priv = self->priv;
+	gdouble power = 0.0;
+	guint   i;
+
+	n_blocks = MIN(n_blocks, priv->n_blocks);
+	for (i = 1; i <= n_blocks; i++)
+		power += priv->block_powers[(priv->n_blocks - i) % LOUDNESS_SHORT_TERM_BLOCKS];
+
+	return -0.691 + 10.0 * log10(power / n_blocks);
+}
+static void pama_pulse_meter_state_changed(pa_stream *stream, void *userdata)
+{
+	PamaPulseMeter *self = userdata;
+
+	switch (pa_stream_get_state(stream))
+	{
+		case PA_STREAM_FAILED:
+		case PA_STREAM_TERMINATED:
+			/* The source went away; show silence rather than its last peak */
+			self->priv->level      = 0.0;
+			self->priv->momentary  = -INFINITY;
+			self->priv->short_term = -INFINITY;
+			g_object_freeze_notify(G_OBJECT(self));
+			g_object_notify(G_OBJECT(self), "level");
+			g_object_notify(G_OBJECT(self), "momentary");
+			g_object_notify(G_OBJECT(self), "short-term");
+			g_object_thaw_notify(G_OBJECT(self));
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+PamaPulseMeter *pama_pulse_meter_new(PamaPulseContext *context, PamaPulseSource *source)
+{
+	return g_object_new(PAMA_TYPE_PULSE_METER,
+	                    "context", context,
+	                    "source", source,
+	                    NULL);
+}
+
+// Meters a single application through the monitor of the sink it plays on.
+// Returns NULL if that sink has no monitor.
+PamaPulseMeter *pama_pulse_meter_new_for_sink_input(PamaPulseContext *context, PamaPulseSinkInput *sink_input)
+{
+	PamaPulseMeter  *meter;
+	PamaPulseSink   *sink;
+	PamaPulseSource *monitor = NULL;
+
+	g_object_get(sink_input, "sink", &sink, NULL);
+	if (sink)
+	{
+		g_object_get(sink, "monitor", &monitor, NULL);
+		g_object_unref(sink);
+	}
+	if (NULL == monitor)
+		return NULL;
+
+	meter = g_object_new(PAMA_TYPE_PULSE_METER,
+	                     "context", context,
+	                     "source", monitor,
+	                     "sink-input", sink_input,
+	                     NULL);
+	g_object_unref(monitor);
+	return meter;
+}
+
+gdouble pama_pulse_meter_get_level(const PamaPulseMeter *self)
+{
+	return self->priv->level;
+}
+gboolean pama_pulse_meter_get_clipping(const PamaPulseMeter *self)
+{
+	return self->priv->clipping;
+}
+
+gboolean pama_pulse_meter_get_measures_loudness(const PamaPulseMeter *self)
+{
+	return self->priv->loudness;
+}
+gdouble pama_pulse_meter_get_momentary(const PamaPulseMeter *self)
+{
+	return self->priv->momentary;
+}
+gdouble pama_pulse_meter_get_short_term(const PamaPulseMeter *self)
+{
+	return self->priv->short_term;
+}
+
+// Makes meters created from now on measure loudness as well as peaks. This
+// costs a stream of real audio each rather than a trickle of peaks, so it is
+// off unless asked for.
+void pama_pulse_meter_set_measure_loudness(gboolean loudness)
+{
+	measure_loudness = loudness;
+}
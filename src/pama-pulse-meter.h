@@ -0,0 +1,71 @@
+/*
+ * pama-pulse-meter.h: A GObject wrapper for a PulseAudio peak detection stream
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef __PAMA_PULSE_METER_H__
+#define __PAMA_PULSE_METER_H__
+
+#include <glib.h>
+#include <glib-object.h>
+#include <pulse/pulseaudio.h>
+#include "pama-pulse-context.h"
+
+G_BEGIN_DECLS
+
+#define PAMA_TYPE_PULSE_METER            (pama_pulse_meter_get_type())
+#define PAMA_PULSE_METER(obj)            (G_TYPE_CHECK_INSTANCE_CAST((obj), PAMA_TYPE_PULSE_METER, PamaPulseMeter))
+#define PAMA_IS_PULSE_METER(obj)         (G_TYPE_CHECK_INSTANCE_TYPE((obj), PAMA_TYPE_PULSE_METER))
+#define PAMA_PULSE_METER_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST((klass), PAMA_TYPE_PULSE_METER, PamaPulseMeterClass))
+#define PAMA_IS_PULSE_METER_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE((klass), PAMA_TYPE_PULSE_METER))
+#define PAMA_PULSE_METER_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS((obj), PAMA_TYPE_PULSE_METER, PamaPulseMeterClass))
+
+typedef struct _PamaPulseMeter        PamaPulseMeter;
+typedef struct _PamaPulseMeterClass   PamaPulseMeterClass;
+typedef struct _PamaPulseMeterPrivate PamaPulseMeterPrivate;
+
+struct _PamaPulseMeter
+{
+	GObject parent_instance;
+	
+	/*< private >*/
+	PamaPulseMeterPrivate *priv;
+};
+
+struct _PamaPulseMeterClass
+{
+	GObjectClass parent_class;
+};
+
+GType pama_pulse_meter_get_type(void);
+
+/* methods */
+PamaPulseMeter *pama_pulse_meter_new(PamaPulseContext *context, PamaPulseSource *source);
+PamaPulseMeter *pama_pulse_meter_new_for_sink_input(PamaPulseContext *context, PamaPulseSinkInput *sink_input);
+
+gdouble  pama_pulse_meter_get_level(const PamaPulseMeter *meter);
+gboolean pama_pulse_meter_get_clipping(const PamaPulseMeter *meter);
+gboolean pama_pulse_meter_get_measures_loudness(const PamaPulseMeter *meter);
+gdouble  pama_pulse_meter_get_momentary (const PamaPulseMeter *meter);
+gdouble  pama_pulse_meter_get_short_term(const PamaPulseMeter *meter);
+
+void pama_pulse_meter_set_measure_loudness(gboolean loudness);
+
+G_END_DECLS
+
+#endif /* __PAMA_PULSE_METER_H__ */
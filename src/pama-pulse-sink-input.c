@@ -27,6 +27,7 @@
 #include <string.h>
 #include "pama-pulse-sink-input.h"
 #include "pama-pulse-context.h"
+#include "pama-icon-cache.h"
 
 #define PAMA_PULSE_SINK_INPUT_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE((obj), PAMA_TYPE_PULSE_SINK_INPUT, PamaPulseSinkInputPrivate))
 
@@ -35,7 +36,12 @@ struct _PamaPulseSinkInputPrivate
 	guint32           index;
 	guint32           volume;
 	guint8            channels;
+	pa_cvolume        cvolume;
+	pa_channel_map    channel_map;
 	gboolean          mute;
+	gboolean          corked;
+	pa_usec_t         buffer_latency;
+	pa_usec_t         sink_latency;
 	GString          *name;
 	PamaPulseClient  *client;
 	PamaPulseSink    *sink;
@@ -47,9 +53,10 @@ struct _PamaPulseSinkInputPrivate
 	pa_operation *current_op;
 	gboolean mute_pending;
 	gboolean volume_pending;
+	gboolean volume_written; /* not yet reported back by the server */
 	gboolean move_pending;
 	gboolean new_mute;
-	guint32  new_volume;
+	pa_cvolume new_cvolume;
 	PamaPulseSink *new_sink;
 };
 
@@ -60,6 +67,7 @@ static void pama_pulse_sink_input_get_property(GObject *gobject, guint property_
 static void pama_pulse_sink_input_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec);
 
 static void pama_pulse_sink_input_operation_done(pa_context *c, int success, PamaPulseSinkInput *self);
+static const pa_cvolume *pama_pulse_sink_input_get_target_cvolume(PamaPulseSinkInput *self);
 
 G_DEFINE_TYPE(PamaPulseSinkInput, pama_pulse_sink_input, G_TYPE_OBJECT);
 
@@ -70,7 +78,12 @@ enum
 	PROP_INDEX,
 	PROP_VOLUME,
 	PROP_CHANNELS,
+	PROP_CVOLUME,
+	PROP_CHANNEL_MAP,
 	PROP_MUTE,
+	PROP_CORKED,
+	PROP_BUFFER_LATENCY,
+	PROP_SINK_LATENCY,
 	PROP_NAME,
 	PROP_CLIENT,
 	PROP_SINK,
@@ -117,6 +130,18 @@ static void pama_pulse_sink_input_class_init(PamaPulseSinkInputClass *klass)
 							   G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS);
 	g_object_class_install_property(gobject_class, PROP_CHANNELS, pspec);
 
+	pspec = g_param_spec_pointer("cvolume",
+	                             "Channel volumes",
+	                             "A pa_cvolume with the volume of each channel of this sink input; it is copied",
+	                             G_PARAM_WRITABLE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_CVOLUME, pspec);
+
+	pspec = g_param_spec_pointer("channel-map",
+	                             "Channel map",
+	                             "A pa_channel_map with the position of each channel of this sink input; it is copied",
+	                             G_PARAM_WRITABLE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_CHANNEL_MAP, pspec);
+
 	pspec = g_param_spec_boolean("mute",
 	                             "Sink input mute flag",
 	                             "Indicates whether the sink input has been muted",
@@ -124,6 +149,31 @@ static void pama_pulse_sink_input_class_init(PamaPulseSinkInputClass *klass)
 	                             G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS);
 	g_object_class_install_property(gobject_class, PROP_MUTE, pspec);
 
+	pspec = g_param_spec_boolean("corked",
+	                             "Sink input corked flag",
+	                             "Indicates whether the sink input has been paused by its client",
+	                             FALSE,
+	                             G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_CORKED, pspec);
+
+	pspec = g_param_spec_uint64("buffer-latency",
+	                            "Buffer latency",
+	                            "How long the audio queued for the sink input takes to play, in microseconds. Only kept up to date while polled.",
+	                            0,
+	                            G_MAXUINT64,
+	                            0,
+	                            G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_BUFFER_LATENCY, pspec);
+
+	pspec = g_param_spec_uint64("sink-latency",
+	                            "Sink latency",
+	                            "The latency of the sink the sink input plays on, in microseconds. Only kept up to date while polled.",
+	                            0,
+	                            G_MAXUINT64,
+	                            0,
+	                            G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_SINK_LATENCY, pspec);
+
 	pspec = g_param_spec_string("name",
 	                            "Sink input identifier",
 	                            "The systematic name assigned to this sink input.",
@@ -223,6 +273,18 @@ static void pama_pulse_sink_input_get_property(GObject *gobject, guint property_
 			g_value_set_boolean(value, self->priv->mute);
 			break;
 
+		case PROP_CORKED:
+			g_value_set_boolean(value, self->priv->corked);
+			break;
+
+		case PROP_BUFFER_LATENCY:
+			g_value_set_uint64(value, self->priv->buffer_latency);
+			break;
+
+		case PROP_SINK_LATENCY:
+			g_value_set_uint64(value, self->priv->sink_latency);
+			break;
+
 		case PROP_NAME:
 			g_value_set_string(value, self->priv->name->str);
 			break;
@@ -270,10 +332,37 @@ static void pama_pulse_sink_input_set_property(GObject *gobject, guint property_
 			self->priv->channels = g_value_get_uchar(value);
 			break;
 
+		case PROP_CVOLUME:
+			if (g_value_get_pointer(value))
+				self->priv->cvolume = *(const pa_cvolume *)g_value_get_pointer(value);
+			else
+				pa_cvolume_init(&self->priv->cvolume);
+			self->priv->volume_written = FALSE;
+			break;
+
+		case PROP_CHANNEL_MAP:
+			if (g_value_get_pointer(value))
+				self->priv->channel_map = *(const pa_channel_map *)g_value_get_pointer(value);
+			else
+				pa_channel_map_init(&self->priv->channel_map);
+			break;
+
 		case PROP_MUTE:
 			self->priv->mute = g_value_get_boolean(value);
 			break;
 
+		case PROP_CORKED:
+			self->priv->corked = g_value_get_boolean(value);
+			break;
+
+		case PROP_BUFFER_LATENCY:
+			self->priv->buffer_latency = g_value_get_uint64(value);
+			break;
+
+		case PROP_SINK_LATENCY:
+			self->priv->sink_latency = g_value_get_uint64(value);
+			break;
+
 		case PROP_NAME:
 			g_string_assign(self->priv->name, g_value_get_string(value));
 			break;
@@ -345,7 +434,7 @@ static void pama_pulse_sink_input_operation_done(pa_context *c, int success, Pam
 
 	if (self->priv->volume_pending)
 	{
-		pama_pulse_sink_input_set_volume(self, self->priv->new_volume);
+		pama_pulse_sink_input_set_cvolume(self, &self->priv->new_cvolume);
 		self->priv->volume_pending = FALSE;
 		return;
 	}
@@ -372,25 +461,66 @@ void pama_pulse_sink_input_set_mute(PamaPulseSinkInput *self, gboolean mute)
 }
 
 void pama_pulse_sink_input_set_volume(PamaPulseSinkInput *self, const guint32 volume)
+{
+	pa_cvolume cvolume = *pama_pulse_sink_input_get_target_cvolume(self);
+
+	/* Scaled rather than set, so that the balance between the channels survives */
+	if (pa_cvolume_valid(&cvolume))
+		pa_cvolume_scale(&cvolume, volume);
+	else
+		pa_cvolume_set(&cvolume, self->priv->channels, volume);
+
+	pama_pulse_sink_input_set_cvolume(self, &cvolume);
+}
+void pama_pulse_sink_input_set_cvolume(PamaPulseSinkInput *self, const pa_cvolume *cvolume)
 {
 	pa_context *c;
-	pa_cvolume cvolume;
-	
+
 	if (self->priv->current_op)
 	{
 		self->priv->volume_pending = TRUE;
-		self->priv->new_volume = volume;
+		self->priv->new_cvolume = *cvolume;
 		return;
 	}
-	
+
+	/* Writing back what the server already has only sets other mixers off */
+	if (!self->priv->volume_written && pa_cvolume_equal(cvolume, &self->priv->cvolume))
+		return;
+
 	g_object_get(self->priv->context,
 	             "context", &c, 
 				 NULL);
 
-	pa_cvolume_set(&cvolume, self->priv->channels, volume);
-	pa_operation *o = pa_context_set_sink_input_volume(c, self->priv->index, &cvolume, (pa_context_success_cb_t)pama_pulse_sink_input_operation_done, self);
+	pa_operation *o = pa_context_set_sink_input_volume(c, self->priv->index, cvolume, (pa_context_success_cb_t)pama_pulse_sink_input_operation_done, self);
 	if (o)
+	{
 		self->priv->current_op = o;
+		self->priv->volume_written = TRUE;
+	}
+}
+void pama_pulse_sink_input_set_balance(PamaPulseSinkInput *self, gfloat balance)
+{
+	pa_cvolume cvolume = *pama_pulse_sink_input_get_target_cvolume(self);
+
+	if (pa_cvolume_set_balance(&cvolume, &self->priv->channel_map, balance))
+		pama_pulse_sink_input_set_cvolume(self, &cvolume);
+}
+static const pa_cvolume *pama_pulse_sink_input_get_target_cvolume(PamaPulseSinkInput *self)
+{
+	/* Changes made while a write is in flight build on the one that will follow it */
+	if (self->priv->volume_pending)
+		return &self->priv->new_cvolume;
+
+	return &self->priv->cvolume;
+}
+
+const pa_cvolume *pama_pulse_sink_input_get_cvolume(const PamaPulseSinkInput *self)
+{
+	return &self->priv->cvolume;
+}
+const pa_channel_map *pama_pulse_sink_input_get_channel_map(const PamaPulseSinkInput *self)
+{
+	return &self->priv->channel_map;
 }
 
 void pama_pulse_sink_input_set_sink(PamaPulseSinkInput *self, PamaPulseSink *sink)
@@ -415,43 +545,27 @@ void pama_pulse_sink_input_set_sink(PamaPulseSinkInput *self, PamaPulseSink *sin
 
 GIcon *pama_pulse_sink_input_build_gicon(const PamaPulseSinkInput *self)
 {
-	GIcon *icon = NULL, *temp;
-	GEmblem *shared = NULL;
+	GIcon *icon;
 	gchar *client_icon_name;
 	gboolean is_local;
 
 	g_object_get(self->priv->client, "is-local", &is_local, NULL);
 
-	if (!is_local)
-	{
-		temp = g_themed_icon_new("emblem-shared");
-		shared = g_emblem_new_with_origin(temp, G_EMBLEM_ORIGIN_DEVICE);
-		g_object_unref(temp);
-	}
-
 	// Use the first icon available from:
 	// 1. The stream's icon
 	// 2. The client's icon
 	// 3. A fallback icon
 	if (0 < strlen(self->priv->icon_name->str))
-	{
-		temp = g_themed_icon_new_with_default_fallbacks(self->priv->icon_name->str);
-	}
-	else
-	{
-		g_object_get(self->priv->client, "icon-name", &client_icon_name, NULL);
-
-		if (0 < strlen(client_icon_name))
-			temp = g_themed_icon_new_with_default_fallbacks(client_icon_name);
-		else
-			temp = g_themed_icon_new_with_default_fallbacks("application-x-executable");
-		
-		g_free(client_icon_name);
-	}
+		return pama_icon_cache_get_gicon(self->priv->icon_name->str, !is_local);
+
+	g_object_get(self->priv->client, "icon-name", &client_icon_name, NULL);
 
-	if (shared)
-		icon = g_emblemed_icon_new(temp, shared);
+	if (0 < strlen(client_icon_name))
+		icon = pama_icon_cache_get_gicon(client_icon_name, !is_local);
+	else
+		icon = pama_icon_cache_get_gicon("application-x-executable", !is_local);
 
-	return icon ? icon : temp;
+	g_free(client_icon_name);
+	return icon;
 }
 
@@ -62,8 +62,13 @@ gint pama_pulse_sink_input_compare_by_name            (gconstpointer a, gconstpo
 
 void pama_pulse_sink_input_set_mute(PamaPulseSinkInput *sink_input, gboolean mute);
 void pama_pulse_sink_input_set_volume(PamaPulseSinkInput *sink_input, const guint32 volume);
+void pama_pulse_sink_input_set_cvolume(PamaPulseSinkInput *sink_input, const pa_cvolume *cvolume);
+void pama_pulse_sink_input_set_balance(PamaPulseSinkInput *sink_input, gfloat balance);
 void pama_pulse_sink_input_set_sink(PamaPulseSinkInput *sink_input, PamaPulseSink *sink);
 
+const pa_cvolume     *pama_pulse_sink_input_get_cvolume(const PamaPulseSinkInput *sink_input);
+const pa_channel_map *pama_pulse_sink_input_get_channel_map(const PamaPulseSinkInput *sink_input);
+
 GIcon *pama_pulse_sink_input_build_gicon(const PamaPulseSinkInput *sink_input);
 
 G_END_DECLS
@@ -62,8 +62,15 @@ gint pama_pulse_sink_compare_by_hostname   (gconstpointer a, gconstpointer b);
 
 void pama_pulse_sink_set_mute(PamaPulseSink *sink, gboolean mute);
 void pama_pulse_sink_set_volume(PamaPulseSink *sink, const guint32 volume);
+void pama_pulse_sink_set_cvolume(PamaPulseSink *sink, const pa_cvolume *cvolume);
+void pama_pulse_sink_set_balance(PamaPulseSink *sink, gfloat balance);
+void pama_pulse_sink_set_fade(PamaPulseSink *sink, gfloat fade);
 void pama_pulse_sink_set_as_default(PamaPulseSink *sink);
 
+const pa_cvolume     *pama_pulse_sink_get_cvolume(const PamaPulseSink *sink);
+const pa_channel_map *pama_pulse_sink_get_channel_map(const PamaPulseSink *sink);
+gboolean              pama_pulse_sink_is_running(const PamaPulseSink *sink);
+
 GIcon *pama_pulse_sink_build_gicon(const PamaPulseSink *sink);
 
 G_END_DECLS
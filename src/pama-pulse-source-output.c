@@ -27,6 +27,7 @@
 #include <string.h>
 #include "pama-pulse-source-output.h"
 #include "pama-pulse-context.h"
+#include "pama-icon-cache.h"
 
 #define PAMA_PULSE_SOURCE_OUTPUT_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE((obj), PAMA_TYPE_PULSE_SOURCE_OUTPUT, PamaPulseSourceOutputPrivate))
 
@@ -274,43 +275,27 @@ void pama_pulse_source_output_set_source(PamaPulseSourceOutput *self, PamaPulseS
 
 GIcon *pama_pulse_source_output_build_gicon(const PamaPulseSourceOutput *self)
 {
-	GIcon *icon = NULL, *temp;
-	GEmblem *shared = NULL;
+	GIcon *icon;
 	gchar *client_icon_name;
 	gboolean is_local;
 
 	g_object_get(self->priv->client, "is-local", &is_local, NULL);
 
-	if (!is_local)
-	{
-		temp = g_themed_icon_new("emblem-shared");
-		shared = g_emblem_new_with_origin(temp, G_EMBLEM_ORIGIN_DEVICE);
-		g_object_unref(temp);
-	}
-
 	// Use the first icon available from:
 	// 1. The stream's icon
 	// 2. The client's icon
 	// 3. A fallback icon
 	if (0 < strlen(self->priv->icon_name->str))
-	{
-		temp = g_themed_icon_new_with_default_fallbacks(self->priv->icon_name->str);
-	}
-	else
-	{
-		g_object_get(self->priv->client, "icon-name", &client_icon_name, NULL);
-
-		if (0 < strlen(client_icon_name))
-			temp = g_themed_icon_new_with_default_fallbacks(client_icon_name);
-		else
-			temp = g_themed_icon_new_with_default_fallbacks("application-x-executable");
-		
-		g_free(client_icon_name);
-	}
+		return pama_icon_cache_get_gicon(self->priv->icon_name->str, !is_local);
 
-	if (shared)
-		icon = g_emblemed_icon_new(temp, shared);
+	g_object_get(self->priv->client, "icon-name", &client_icon_name, NULL);
+
+	if (0 < strlen(client_icon_name))
+		icon = pama_icon_cache_get_gicon(client_icon_name, !is_local);
+	else
+		icon = pama_icon_cache_get_gicon("application-x-executable", !is_local);
 
-	return icon ? icon : temp;
+	g_free(client_icon_name);
+	return icon;
 }
 
@@ -27,6 +27,7 @@
 #include <string.h>
 #include "pama-pulse-context.h"
 #include "pama-pulse-source.h"
+#include "pama-icon-cache.h"
 
 #define PAMA_PULSE_SOURCE_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE((obj), PAMA_TYPE_PULSE_SOURCE, PamaPulseSourcePrivate))
 
@@ -35,7 +36,12 @@ struct _PamaPulseSourcePrivate
 	guint32           index;
 	guint32           volume, base_volume;
 	guint8            channels;
+	pa_cvolume        cvolume;
+	pa_channel_map    channel_map;
 	gboolean          mute;
+	gint              state;
+	pa_usec_t         latency;
+	pa_usec_t         configured_latency;
 	GString *         name;
 	GString *         description;
 	pa_source_flags_t flags;
@@ -48,8 +54,9 @@ struct _PamaPulseSourcePrivate
 	pa_operation *current_op;
 	gboolean mute_pending;
 	gboolean volume_pending;
+	gboolean volume_written; /* not yet reported back by the server */
 	gboolean new_mute;
-	guint32  new_volume;
+	pa_cvolume new_cvolume;
 };
 
 static void pama_pulse_source_init(PamaPulseSource *source);
@@ -59,6 +66,7 @@ static void pama_pulse_source_get_property(GObject *gobject, guint property_id,
 static void pama_pulse_source_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec);
 
 static void pama_pulse_source_operation_done(pa_context *c, int success, PamaPulseSource *self);
+static const pa_cvolume *pama_pulse_source_get_target_cvolume(PamaPulseSource *self);
 
 G_DEFINE_TYPE(PamaPulseSource, pama_pulse_source, G_TYPE_OBJECT);
 
@@ -71,7 +79,12 @@ enum
 	PROP_VOLUME,
 	PROP_BASE_VOLUME,
 	PROP_CHANNELS,
+	PROP_CVOLUME,
+	PROP_CHANNEL_MAP,
 	PROP_MUTE,
+	PROP_STATE,
+	PROP_LATENCY,
+	PROP_CONFIGURED_LATENCY,
 	PROP_NAME,
 	PROP_DESCRIPTION,
 	PROP_CONTEXT,
@@ -128,6 +141,18 @@ static void pama_pulse_source_class_init(PamaPulseSourceClass *klass)
 							   G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS);
 	g_object_class_install_property(gobject_class, PROP_CHANNELS, pspec);
 
+	pspec = g_param_spec_pointer("cvolume",
+	                             "Channel volumes",
+	                             "A pa_cvolume with the volume of each channel of this source; it is copied",
+	                             G_PARAM_WRITABLE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_CVOLUME, pspec);
+
+	pspec = g_param_spec_pointer("channel-map",
+	                             "Channel map",
+	                             "A pa_channel_map with the position of each channel of this source; it is copied",
+	                             G_PARAM_WRITABLE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_CHANNEL_MAP, pspec);
+
 	pspec = g_param_spec_boolean("mute",
 	                             "Mute",
 	                             "Indicates whether the source has been muted",
@@ -135,6 +160,33 @@ static void pama_pulse_source_class_init(PamaPulseSourceClass *klass)
 	                             G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS);
 	g_object_class_install_property(gobject_class, PROP_MUTE, pspec);
 
+	pspec = g_param_spec_int("state",
+	                         "State",
+	                         "The pa_source_state_t of the source: running while any stream is recording from it, idle, or suspended",
+	                         PA_SOURCE_INVALID_STATE,
+	                         PA_SOURCE_SUSPENDED,
+	                         PA_SOURCE_INVALID_STATE,
+	                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_STATE, pspec);
+
+	pspec = g_param_spec_uint64("latency",
+	                            "Latency",
+	                            "How long a sample takes to reach the source from the hardware, in microseconds. Only kept up to date while polled.",
+	                            0,
+	                            G_MAXUINT64,
+	                            0,
+	                            G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_LATENCY, pspec);
+
+	pspec = g_param_spec_uint64("configured-latency",
+	                            "Configured latency",
+	                            "The latency the source was last configured for, in microseconds. Only kept up to date while polled.",
+	                            0,
+	                            G_MAXUINT64,
+	                            0,
+	                            G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_CONFIGURED_LATENCY, pspec);
+
 	pspec = g_param_spec_string("name",
 	                            "Name",
 	                            "The systematic name assigned to this source.",
@@ -255,6 +307,18 @@ static void pama_pulse_source_get_property(GObject *gobject, guint property_id,
 			g_value_set_boolean(value, self->priv->mute);
 			break;
 
+		case PROP_STATE:
+			g_value_set_int(value, self->priv->state);
+			break;
+
+		case PROP_LATENCY:
+			g_value_set_uint64(value, self->priv->latency);
+			break;
+
+		case PROP_CONFIGURED_LATENCY:
+			g_value_set_uint64(value, self->priv->configured_latency);
+			break;
+
 		case PROP_NAME:
 			g_value_set_string(value, self->priv->name->str);
 			break;
@@ -310,10 +374,37 @@ static void pama_pulse_source_set_property(GObject *gobject, guint property_id,
 			self->priv->channels = g_value_get_uchar(value);
 			break;
 
+		case PROP_CVOLUME:
+			if (g_value_get_pointer(value))
+				self->priv->cvolume = *(const pa_cvolume *)g_value_get_pointer(value);
+			else
+				pa_cvolume_init(&self->priv->cvolume);
+			self->priv->volume_written = FALSE;
+			break;
+
+		case PROP_CHANNEL_MAP:
+			if (g_value_get_pointer(value))
+				self->priv->channel_map = *(const pa_channel_map *)g_value_get_pointer(value);
+			else
+				pa_channel_map_init(&self->priv->channel_map);
+			break;
+
 		case PROP_MUTE:
 			self->priv->mute = g_value_get_boolean(value);
 			break;
 
+		case PROP_STATE:
+			self->priv->state = g_value_get_int(value);
+			break;
+
+		case PROP_LATENCY:
+			self->priv->latency = g_value_get_uint64(value);
+			break;
+
+		case PROP_CONFIGURED_LATENCY:
+			self->priv->configured_latency = g_value_get_uint64(value);
+			break;
+
 		case PROP_NAME:
 			g_string_assign(self->priv->name, g_value_get_string(value));
 			break;
@@ -430,7 +521,7 @@ static void pama_pulse_source_operation_done(pa_context *c, int success, PamaPul
 
 	if (self->priv->volume_pending)
 	{
-		pama_pulse_source_set_volume(self, self->priv->new_volume);
+		pama_pulse_source_set_cvolume(self, &self->priv->new_cvolume);
 		self->priv->volume_pending = FALSE;
 	}
 }
@@ -456,25 +547,66 @@ void pama_pulse_source_set_mute(PamaPulseSource *self, gboolean mute)
 }
 
 void pama_pulse_source_set_volume(PamaPulseSource *self, const guint32 volume)
+{
+	pa_cvolume cvolume = *pama_pulse_source_get_target_cvolume(self);
+
+	/* Scaled rather than set, so that the balance between the channels survives */
+	if (pa_cvolume_valid(&cvolume))
+		pa_cvolume_scale(&cvolume, volume);
+	else
+		pa_cvolume_set(&cvolume, self->priv->channels, volume);
+
+	pama_pulse_source_set_cvolume(self, &cvolume);
+}
+void pama_pulse_source_set_cvolume(PamaPulseSource *self, const pa_cvolume *cvolume)
 {
 	pa_context *c;
-	pa_cvolume cvolume;
 
 	if (self->priv->current_op)
 	{
 		self->priv->volume_pending = TRUE;
-		self->priv->new_volume = volume;
+		self->priv->new_cvolume = *cvolume;
 		return;
 	}
 
+	/* Writing back what the server already has only sets other mixers off */
+	if (!self->priv->volume_written && pa_cvolume_equal(cvolume, &self->priv->cvolume))
+		return;
+
 	g_object_get(self->priv->context,
 	             "context", &c, 
 				 NULL);
 
-	pa_cvolume_set(&cvolume, self->priv->channels, volume);
-	pa_operation *o = pa_context_set_source_volume_by_index(c, self->priv->index, &cvolume, (pa_context_success_cb_t)pama_pulse_source_operation_done, self);
+	pa_operation *o = pa_context_set_source_volume_by_index(c, self->priv->index, cvolume, (pa_context_success_cb_t)pama_pulse_source_operation_done, self);
 	if (o)
+	{
 		self->priv->current_op = o;
+		self->priv->volume_written = TRUE;
+	}
+}
+void pama_pulse_source_set_balance(PamaPulseSource *self, gfloat balance)
+{
+	pa_cvolume cvolume = *pama_pulse_source_get_target_cvolume(self);
+
+	if (pa_cvolume_set_balance(&cvolume, &self->priv->channel_map, balance))
+		pama_pulse_source_set_cvolume(self, &cvolume);
+}
+static const pa_cvolume *pama_pulse_source_get_target_cvolume(PamaPulseSource *self)
+{
+	/* Changes made while a write is in flight build on the one that will follow it */
+	if (self->priv->volume_pending)
+		return &self->priv->new_cvolume;
+
+	return &self->priv->cvolume;
+}
+
+const pa_cvolume *pama_pulse_source_get_cvolume(const PamaPulseSource *self)
+{
+	return &self->priv->cvolume;
+}
+const pa_channel_map *pama_pulse_source_get_channel_map(const PamaPulseSource *self)
+{
+	return &self->priv->channel_map;
 }
 
 void pama_pulse_source_set_as_default(PamaPulseSource *self)
@@ -492,8 +624,6 @@ void pama_pulse_source_set_as_default(PamaPulseSource *self)
 
 GIcon *pama_pulse_source_build_gicon(const PamaPulseSource *self)
 {
-	GIcon *icon = NULL, *temp;
-	GEmblem *shared = NULL;
 	PamaPulseSink *monitored_sink = pama_pulse_source_get_monitored_sink(self);
 
 	// Makes sure that the icon for a monitor matches the icon of the monitored
@@ -502,19 +632,7 @@ GIcon *pama_pulse_source_build_gicon(const PamaPulseSource *self)
 	if (monitored_sink)
 		return pama_pulse_sink_build_gicon(monitored_sink);
 
-	if (self->priv->network)
-	{
-		temp = g_themed_icon_new("emblem-shared");
-		shared = g_emblem_new_with_origin(temp, G_EMBLEM_ORIGIN_DEVICE);
-		g_object_unref(temp);
-	}
-
-	temp = g_themed_icon_new_with_default_fallbacks(self->priv->icon_name->str);
-
-	if (shared)
-		icon = g_emblemed_icon_new(temp, shared);
-
-	return icon ? icon : temp;
+	return pama_icon_cache_get_gicon(self->priv->icon_name->str, self->priv->network);
 }
 
 PamaPulseSink *pama_pulse_source_get_monitored_sink(const PamaPulseSource *self)
@@ -524,3 +642,8 @@ PamaPulseSink *pama_pulse_source_get_monitored_sink(const PamaPulseSource *self)
 
 	return pama_pulse_context_get_sink_by_index(self->priv->context, self->priv->monitored_sink_index);
 }
+
+gboolean pama_pulse_source_is_running(const PamaPulseSource *self)
+{
+	return PA_SOURCE_RUNNING == self->priv->state;
+}
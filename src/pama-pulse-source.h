@@ -65,8 +65,14 @@ gint pama_pulse_source_compare_by_is_monitor (gconstpointer a, gconstpointer b);
 
 void pama_pulse_source_set_mute(PamaPulseSource *source, gboolean mute);
 void pama_pulse_source_set_volume(PamaPulseSource *source, const guint32 volume);
+void pama_pulse_source_set_cvolume(PamaPulseSource *source, const pa_cvolume *cvolume);
+void pama_pulse_source_set_balance(PamaPulseSource *source, gfloat balance);
 void pama_pulse_source_set_as_default(PamaPulseSource *source);
 
+const pa_cvolume     *pama_pulse_source_get_cvolume(const PamaPulseSource *source);
+const pa_channel_map *pama_pulse_source_get_channel_map(const PamaPulseSource *source);
+gboolean              pama_pulse_source_is_running(const PamaPulseSource *source);
+
 GIcon *pama_pulse_source_build_gicon(const PamaPulseSource *source);
 
 PamaPulseSink *pama_pulse_source_get_monitored_sink(const PamaPulseSource *source);
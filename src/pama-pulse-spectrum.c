@@ -0,0 +1,352 @@
+/*
+ * pama-pulse-spectrum.c: Records a source and analyses its frequency content
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+ 
+#include <string.h>
+#include "pama-pulse-spectrum.h"
+#include "pama-fft.h"
+
+#define PAMA_PULSE_SPECTRUM_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE((obj), PAMA_TYPE_PULSE_SPECTRUM, PamaPulseSpectrumPrivate))
+
+/* Hum sits at 50 or 60Hz and its harmonics, and feedback howls somewhere in
+ * the speech band, so 16kHz covers everything of interest. 2048 points give
+ * bins under 8Hz wide, enough to tell 50Hz from 60Hz. Successive transforms
+ * overlap by half, for about 16 spectra a second. */
+#define SPECTRUM_RATE 16000
+#define SPECTRUM_SIZE 2048
+#define SPECTRUM_HOP  (SPECTRUM_SIZE / 2)
+
+/* How often the share of a CPU spent on analysis is updated, in seconds */
+#define SPECTRUM_LOAD_INTERVAL 1.0
+
+struct _PamaPulseSpectrumPrivate
+{
+	PamaPulseContext *context;
+	PamaPulseSource  *source;
+	pa_stream        *stream;
+
+	PamaFft          *fft;
+	gfloat            samples[SPECTRUM_SIZE];
+	guint             n_samples;
+	gfloat            levels[SPECTRUM_SIZE / 2 + 1];
+
+	GTimer           *busy_timer, *load_timer;
+	gdouble           busy;
+	gdouble           load;
+};
+
+static void     pama_pulse_spectrum_init(PamaPulseSpectrum *spectrum);
+static void     pama_pulse_spectrum_class_init(PamaPulseSpectrumClass *klass);
+static GObject* pama_pulse_spectrum_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties);
+static void     pama_pulse_spectrum_dispose(GObject *gobject);
+static void     pama_pulse_spectrum_finalize(GObject *gobject);
+static void     pama_pulse_spectrum_get_property(GObject *gobject, guint property_id,       GValue *value, GParamSpec *pspec);
+static void     pama_pulse_spectrum_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec);
+
+static void     pama_pulse_spectrum_read(pa_stream *stream, size_t length, void *userdata);
+
+G_DEFINE_TYPE(PamaPulseSpectrum, pama_pulse_spectrum, G_TYPE_OBJECT);
+
+enum
+{
+	PROP_0,
+
+	PROP_CONTEXT,
+	PROP_SOURCE,
+	PROP_LOAD
+};
+enum
+{
+	CHANGED_SIGNAL,
+	LAST_SIGNAL
+};
+static guint spectrum_signals[LAST_SIGNAL] = {0,};
+
+static void pama_pulse_spectrum_class_init(PamaPulseSpectrumClass *klass)
+{
+	GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+	GParamSpec   *pspec;
+	
+	gobject_class->constructor  = pama_pulse_spectrum_constructor;
+	gobject_class->dispose      = pama_pulse_spectrum_dispose;
+	gobject_class->finalize     = pama_pulse_spectrum_finalize;
+	gobject_class->get_property = pama_pulse_spectrum_get_property;
+	gobject_class->set_property = pama_pulse_spectrum_set_property;
+
+	pspec = g_param_spec_object("context",
+	                            "Pulse context object",
+	                            "The PamaPulseContext to record through.",
+	                            PAMA_TYPE_PULSE_CONTEXT,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_CONTEXT, pspec);
+
+	pspec = g_param_spec_object("source",
+	                            "Source",
+	                            "The PamaPulseSource to analyse; for a sink, its monitor.",
+	                            PAMA_TYPE_PULSE_SOURCE,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_SOURCE, pspec);
+
+	pspec = g_param_spec_double("load",
+	                            "Load",
+	                            "The share of one CPU spent analysing the recording, from 0 to 1.",
+	                            0.0,
+	                            1.0,
+	                            0.0,
+	                            G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_LOAD, pspec);
+
+	spectrum_signals[CHANGED_SIGNAL] =
+		g_signal_new("changed",
+		             G_TYPE_FROM_CLASS(gobject_class),
+		             G_SIGNAL_RUN_LAST,
+		             0,
+		             NULL,
+		             NULL,
+		             g_cclosure_marshal_VOID__VOID,
+		             G_TYPE_NONE,
+		             0);
+
+	g_type_class_add_private(klass, sizeof(PamaPulseSpectrumPrivate));
+}
+
+static void pama_pulse_spectrum_init(PamaPulseSpectrum *self)
+{
+	guint i;
+
+	self->priv = PAMA_PULSE_SPECTRUM_GET_PRIVATE(self);
+
+	for (i = 0; i < G_N_ELEMENTS(self->priv->levels); i++)
+		self->priv->levels[i] = -G_MAXFLOAT;
+}
+
+static GObject* pama_pulse_spectrum_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties)
+{
+	GObject *gobject = G_OBJECT_CLASS(pama_pulse_spectrum_parent_class)->constructor(gtype, n_properties, properties);
+	PamaPulseSpectrum *self = PAMA_PULSE_SPECTRUM(gobject);
+	pa_context     *c;
+	pa_sample_spec  spec;
+	pa_buffer_attr  attr;
+	guint           index;
+	gchar          *device;
+
+	if (NULL == self->priv->context)
+		g_error("An attempt was made to create a spectrum with no context.");
+	if (NULL == self->priv->source)
+		g_error("An attempt was made to create a spectrum with no source.");
+
+	g_object_get(self->priv->context,
+	             "context", &c,
+	             NULL);
+	g_object_get(self->priv->source,
+	             "index", &index,
+	             NULL);
+
+	/* As with meters, the stream alone keeps what it needs alive */
+	g_object_unref(self->priv->source);
+	self->priv->source = NULL;
+	g_object_unref(self->priv->context);
+	self->priv->context = NULL;
+
+	self->priv->fft        = pama_fft_new(SPECTRUM_SIZE);
+	self->priv->busy_timer = g_timer_new();
+	self->priv->load_timer = g_timer_new();
+
+	if (PA_CONTEXT_READY != pa_context_get_state(c))
+		return gobject;
+
+	spec.format   = PA_SAMPLE_FLOAT32;
+	spec.rate     = SPECTRUM_RATE;
+	spec.channels = 1;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.maxlength = (uint32_t) -1;
+	attr.fragsize  = SPECTRUM_HOP * sizeof(float);
+
+	self->priv->stream = pa_stream_new(c, _("Spectrum analyser"), &spec, NULL);
+	if (NULL == self->priv->stream)
+		return gobject;
+
+	pa_stream_set_read_callback(self->priv->stream, pama_pulse_spectrum_read, self);
+
+	device = g_strdup_printf("%u", index);
+	if (pa_stream_connect_record(self->priv->stream, device, &attr, PA_STREAM_DONT_MOVE | PA_STREAM_ADJUST_LATENCY) < 0)
+	{
+		pa_stream_unref(self->priv->stream);
+		self->priv->stream = NULL;
+	}
+	g_free(device);
+
+	return gobject;
+}
+static void pama_pulse_spectrum_dispose(GObject *gobject)
+{
+	PamaPulseSpectrum *self = PAMA_PULSE_SPECTRUM(gobject);
+
+	if (self->priv->stream)
+	{
+		pa_stream_set_read_callback(self->priv->stream, NULL, NULL);
+		pa_stream_disconnect(self->priv->stream);
+		pa_stream_unref(self->priv->stream);
+		self->priv->stream = NULL;
+	}
+
+	if (self->priv->source)
+	{
+		g_object_unref(self->priv->source);
+		self->priv->source = NULL;
+	}
+
+	if (self->priv->context)
+	{
+		g_object_unref(self->priv->context);
+		self->priv->context = NULL;
+	}
+
+	G_OBJECT_CLASS(pama_pulse_spectrum_parent_class)->dispose(gobject);
+}
+static void pama_pulse_spectrum_finalize(GObject *gobject)
+{
+	PamaPulseSpectrum *self = PAMA_PULSE_SPECTRUM(gobject);
+
+	pama_fft_free(self->priv->fft);
+	if (self->priv->busy_timer)
+		g_timer_destroy(self->priv->busy_timer);
+	if (self->priv->load_timer)
+		g_timer_destroy(self->priv->load_timer);
+
+	G_OBJECT_CLASS(pama_pulse_spectrum_parent_class)->finalize(gobject);
+}
+
+static void pama_pulse_spectrum_get_property(GObject *gobject, guint property_id,       GValue *value, GParamSpec *pspec)
+{
+	PamaPulseSpectrum *self = PAMA_PULSE_SPECTRUM(gobject);
+
+	switch(property_id)
+	{
+		case PROP_LOAD:
+			g_value_set_double(value, self->priv->load);
+			break;
+
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID(self, property_id, pspec);
+			break;
+	}
+}
+static void pama_pulse_spectrum_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec)
+{
+	PamaPulseSpectrum *self = PAMA_PULSE_SPECTRUM(gobject);
+
+	switch(property_id)
+	{
+		case PROP_CONTEXT:
+			self->priv->context = g_value_dup_object(value);
+			break;
+
+		case PROP_SOURCE:
+			self->priv->source = g_value_dup_object(value);
+			break;
+
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID(self, property_id, pspec);
+			break;
+	}
+}
+
+
+// Collects samples until a transform's worth has arrived, analyses them, and
+// keeps the second half for the next transform. The time spent here is what
+// the load accounts for.
+static void pama_pulse_spectrum_read(pa_stream *stream, size_t length, void *userdata)
+{
+	PamaPulseSpectrum *self = userdata;
+	PamaPulseSpectrumPrivate *priv = self->priv;
+	const void *data;
+	gboolean changed = FALSE;
+	gsize n, offset;
+
+	g_timer_start(priv->busy_timer);
+
+	while (pa_stream_readable_size(stream) > 0)
+	{
+		if (pa_stream_peek(stream, &data, &length) < 0 || 0 == length)
+			break;
+
+		for (offset = 0; data && offset < length / sizeof(float); offset += n)
+		{
+			n = MIN(length / sizeof(float) - offset, SPECTRUM_SIZE - priv->n_samples);
+			memcpy(priv->samples + priv->n_samples, (const gfloat *) data + offset, n * sizeof(float));
+			priv->n_samples += n;
+
+			if (priv->n_samples < SPECTRUM_SIZE)
+				continue;
+
+			pama_fft_spectrum(priv->fft, priv->samples, priv->levels);
+			memmove(priv->samples, priv->samples + SPECTRUM_HOP, (SPECTRUM_SIZE - SPECTRUM_HOP) * sizeof(float));
+			priv->n_samples = SPECTRUM_SIZE - SPECTRUM_HOP;
+			changed = TRUE;
+		}
+
+		pa_stream_drop(stream);
+	}
+
+	priv->busy += g_timer_elapsed(priv->busy_timer, NULL);
+
+	if (g_timer_elapsed(priv->load_timer, NULL) >= SPECTRUM_LOAD_INTERVAL)
+	{
+		priv->load = CLAMP(priv->busy / g_timer_elapsed(priv->load_timer, NULL), 0.0, 1.0);
+		priv->busy = 0.0;
+		g_timer_start(priv->load_timer);
+		g_object_notify(G_OBJECT(self), "load");
+	}
+
+	if (changed)
+		g_signal_emit(self, spectrum_signals[CHANGED_SIGNAL], 0);
+}
+
+
+PamaPulseSpectrum *pama_pulse_spectrum_new(PamaPulseContext *context, PamaPulseSource *source)
+{
+	return g_object_new(PAMA_TYPE_PULSE_SPECTRUM,
+	                    "context", context,
+	                    "source", source,
+	                    NULL);
+}
+
+// Returns the level of each frequency from 0Hz up to half the rate, evenly
+// spaced, in dB relative to a full scale sine.
+const gfloat *pama_pulse_spectrum_get_levels(const PamaPulseSpectrum *self, guint *n_levels)
+{
+	*n_levels = G_N_ELEMENTS(self->priv->levels);
+	return self->priv->levels;
+}
+guint pama_pulse_spectrum_get_rate(const PamaPulseSpectrum *self)
+{
+	return SPECTRUM_RATE;
+}
+gdouble pama_pulse_spectrum_get_load(const PamaPulseSpectrum *self)
+{
+	return self->priv->load;
+}
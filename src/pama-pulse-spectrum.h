@@ -0,0 +1,66 @@
+/*
+ * pama-pulse-spectrum.h: Records a source and analyses its frequency content
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef __PAMA_PULSE_SPECTRUM_H__
+#define __PAMA_PULSE_SPECTRUM_H__
+
+#include <glib.h>
+#include <glib-object.h>
+#include <pulse/pulseaudio.h>
+#include "pama-pulse-context.h"
+
+G_BEGIN_DECLS
+
+#define PAMA_TYPE_PULSE_SPECTRUM            (pama_pulse_spectrum_get_type())
+#define PAMA_PULSE_SPECTRUM(obj)            (G_TYPE_CHECK_INSTANCE_CAST((obj), PAMA_TYPE_PULSE_SPECTRUM, PamaPulseSpectrum))
+#define PAMA_IS_PULSE_SPECTRUM(obj)         (G_TYPE_CHECK_INSTANCE_TYPE((obj), PAMA_TYPE_PULSE_SPECTRUM))
+#define PAMA_PULSE_SPECTRUM_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST((klass), PAMA_TYPE_PULSE_SPECTRUM, PamaPulseSpectrumClass))
+#define PAMA_IS_PULSE_SPECTRUM_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE((klass), PAMA_TYPE_PULSE_SPECTRUM))
+#define PAMA_PULSE_SPECTRUM_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS((obj), PAMA_TYPE_PULSE_SPECTRUM, PamaPulseSpectrumClass))
+
+typedef struct _PamaPulseSpectrum        PamaPulseSpectrum;
+typedef struct _PamaPulseSpectrumClass   PamaPulseSpectrumClass;
+typedef struct _PamaPulseSpectrumPrivate PamaPulseSpectrumPrivate;
+
+struct _PamaPulseSpectrum
+{
+	GObject parent_instance;
+	
+	/*< private >*/
+	PamaPulseSpectrumPrivate *priv;
+};
+
+struct _PamaPulseSpectrumClass
+{
+	GObjectClass parent_class;
+};
+
+GType pama_pulse_spectrum_get_type(void);
+
+/* methods */
+PamaPulseSpectrum *pama_pulse_spectrum_new(PamaPulseContext *context, PamaPulseSource *source);
+
+const gfloat *pama_pulse_spectrum_get_levels(const PamaPulseSpectrum *spectrum, guint *n_levels);
+guint         pama_pulse_spectrum_get_rate  (const PamaPulseSpectrum *spectrum);
+gdouble       pama_pulse_spectrum_get_load  (const PamaPulseSpectrum *spectrum);
+
+G_END_DECLS
+
+#endif /* __PAMA_PULSE_SPECTRUM_H__ */
@@ -0,0 +1,629 @@
+/*
+ * pama-sink-input-group-widget.c: A widget that controls all sink inputs of one application at once
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <math.h>
+#include <string.h>
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include "pama-sink-input-group-widget.h"
+#include "pama-sink-input-widget.h"
+#include "pama-device-menu.h"
+#include "pama-icon-cache.h"
+#include "pama-volume-map.h"
+#include "widget-settings.h"
+
+static void     pama_sink_input_group_widget_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec);
+static GObject* pama_sink_input_group_widget_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties);
+static void     pama_sink_input_group_widget_dispose(GObject *gobject);
+static void     pama_sink_input_group_widget_finalize(GObject *gobject);
+static void     pama_sink_input_group_widget_weak_ref_notify(gpointer data, GObject *where_the_object_was);
+static void     pama_sink_input_group_widget_member_weak_ref_notify(gpointer data, GObject *where_the_object_was);
+
+static void     pama_sink_input_group_widget_sink_input_notify(GObject *gobject, GParamSpec *pspec, PamaSinkInputGroupWidget *widget);
+
+static void     pama_sink_input_group_widget_update_values(PamaSinkInputGroupWidget *widget);
+static gboolean pama_sink_input_group_widget_name_query_tooltip(GtkWidget *label, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data);
+static void     pama_sink_input_group_widget_mute_toggled(GtkToggleButton *togglebutton, PamaSinkInputGroupWidget *widget);
+static void     pama_sink_input_group_widget_volume_changed(GtkRange *range, PamaSinkInputGroupWidget *widget);
+static void     pama_sink_input_group_widget_expand_toggled(GtkToggleButton *togglebutton, PamaSinkInputGroupWidget *widget);
+
+static void     pama_sink_input_group_widget_add_member_widget(PamaSinkInputGroupWidget *widget, PamaPulseSinkInput *sink_input);
+
+struct _PamaSinkInputGroupWidgetPrivate
+{
+	GtkWidget *expand, *arrow, *icon, *name, *volume, *value, *mute;
+	GtkWidget *members_align, *members_box;
+	GtkSizeGroup     *icon_sizegroup;
+	GtkWidget        *sink_menu;
+	PamaPulseContext *context;
+	gchar            *key;
+	gboolean          updating;
+
+	/* The member streams; each has a weak reference and a notify handler */
+	GSList *sink_inputs;
+};
+
+G_DEFINE_TYPE(PamaSinkInputGroupWidget, pama_sink_input_group_widget, GTK_TYPE_VBOX);
+#define PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE((obj), PAMA_TYPE_SINK_INPUT_GROUP_WIDGET, PamaSinkInputGroupWidgetPrivate))
+
+enum 
+{
+	PROP_0,
+
+	PROP_CONTEXT,
+	PROP_KEY,
+	PROP_ICON_SIZEGROUP,
+	PROP_SINK_MENU
+};
+
+static void pama_sink_input_group_widget_class_init(PamaSinkInputGroupWidgetClass *klass)
+{
+	GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+	GParamSpec *pspec;
+
+	gobject_class->set_property = pama_sink_input_group_widget_set_property;
+	gobject_class->constructor  = pama_sink_input_group_widget_constructor;
+	gobject_class->dispose      = pama_sink_input_group_widget_dispose;
+	gobject_class->finalize     = pama_sink_input_group_widget_finalize;
+
+	pspec = g_param_spec_object("context",
+	                            "Pulse context object",
+	                            "The PamaPulseContext which the sink inputs belong to.",
+	                            PAMA_TYPE_PULSE_CONTEXT,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_CONTEXT, pspec);
+
+	pspec = g_param_spec_string("key",
+	                            "Group key",
+	                            "The key shared by all members, as built by pama_sink_input_group_widget_build_key().",
+	                            "",
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_KEY, pspec);
+
+	pspec = g_param_spec_object("icon-sizegroup",
+	                            "Icon sizegroup",
+	                            "The GtkSizeGroup to add the group's and its members' icons to.",
+	                            GTK_TYPE_SIZE_GROUP,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_ICON_SIZEGROUP, pspec);
+
+	pspec = g_param_spec_object("sink-menu",
+	                            "Sink menu",
+	                            "The PamaDeviceMenu shared by the members' widgets.",
+	                            PAMA_TYPE_DEVICE_MENU,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_SINK_MENU, pspec);
+
+	g_type_class_add_private(klass, sizeof(PamaSinkInputGroupWidgetPrivate));
+}
+
+static void pama_sink_input_group_widget_init(PamaSinkInputGroupWidget *widget)
+{
+}
+
+static void pama_sink_input_group_widget_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec)
+{
+	PamaSinkInputGroupWidget *widget = PAMA_SINK_INPUT_GROUP_WIDGET(gobject);
+	PamaSinkInputGroupWidgetPrivate *priv = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(widget);
+
+	switch(property_id)
+	{
+		case PROP_CONTEXT:
+			priv->context = g_value_get_object(value);
+			g_object_weak_ref(G_OBJECT(priv->context), pama_sink_input_group_widget_weak_ref_notify, widget);
+			break;
+
+		case PROP_KEY:
+			g_free(priv->key);
+			priv->key = g_value_dup_string(value);
+			break;
+
+		case PROP_ICON_SIZEGROUP:
+			priv->icon_sizegroup = g_value_dup_object(value);
+			break;
+
+		case PROP_SINK_MENU:
+			priv->sink_menu = g_value_dup_object(value);
+			break;
+
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
+			break;
+	}
+}
+static GObject* pama_sink_input_group_widget_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties)
+{
+	GtkWidget *header, *alignment, *inner_box;
+	GtkWidget *expand, *arrow, *icon, *name, *volume, *value, *mute;
+	GtkWidget *members_align, *members_box;
+
+	GObject *gobject = G_OBJECT_CLASS(pama_sink_input_group_widget_parent_class)->constructor(gtype, n_properties, properties);
+	PamaSinkInputGroupWidget *widget = PAMA_SINK_INPUT_GROUP_WIDGET(gobject);
+	PamaSinkInputGroupWidgetPrivate *priv = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(widget);
+
+	if (NULL == priv->context)
+		g_error("An attempt was made to create a sink input group widget with no context.");
+	if (NULL == priv->icon_sizegroup)
+		g_error("An attempt was made to create a sink input group widget with no icon sizegroup");
+	if (NULL == priv->sink_menu)
+		g_error("An attempt was made to create a sink input group widget with no sink menu.");
+
+	gtk_box_set_spacing(GTK_BOX(widget), 6);
+
+	header = gtk_hbox_new(FALSE, 0);
+	gtk_box_pack_start(GTK_BOX(widget), header, FALSE, FALSE, 0);
+
+	expand = gtk_toggle_button_new();
+	gtk_button_set_relief(GTK_BUTTON(expand), GTK_RELIEF_NONE);
+	gtk_widget_set_tooltip_text(GTK_WIDGET(expand), _("Show this application's individual streams"));
+	gtk_box_pack_start(GTK_BOX(header), expand, FALSE, FALSE, 0);
+	priv->expand = expand;
+
+	arrow = gtk_arrow_new(GTK_ARROW_RIGHT, GTK_SHADOW_NONE);
+	gtk_container_add(GTK_CONTAINER(expand), arrow);
+	priv->arrow = arrow;
+
+	alignment = gtk_alignment_new(0, 0.5, 0, 0);
+	gtk_alignment_set_padding(GTK_ALIGNMENT(alignment), 0, 0, 0, 6);
+	gtk_box_pack_start(GTK_BOX(header), alignment, FALSE, FALSE, 0);
+
+	icon = gtk_image_new();
+	gtk_container_add(GTK_CONTAINER(alignment), icon);
+	gtk_size_group_add_widget(priv->icon_sizegroup, icon);
+	priv->icon = icon;
+
+	name = g_object_new(GTK_TYPE_LABEL,
+	                    "ellipsize", PANGO_ELLIPSIZE_MIDDLE,
+	                    "has-tooltip", TRUE,
+	                    "wrap", FALSE,
+	                    "width-chars", WIDGET_NAME_WIDTH_IN_CHARS,
+	                    "xalign", 0.0f,
+	                    NULL);
+	gtk_box_pack_start(GTK_BOX(header), name, FALSE, FALSE, 0);
+	priv->name = name;
+	g_signal_connect(name, "query-tooltip", G_CALLBACK(pama_sink_input_group_widget_name_query_tooltip), NULL);
+
+	alignment = gtk_alignment_new(0, 0.5, 0, 0);
+	gtk_box_pack_start(GTK_BOX(header), alignment, FALSE, FALSE, 0);
+
+	volume = gtk_hscale_new_with_range(0, WIDGET_VOLUME_SLIDER_DB_RANGE, 2.5); /* for scroll steps of 5dB */
+	gtk_scale_set_draw_value   (GTK_SCALE(volume), FALSE);
+	gtk_widget_set_size_request(volume, WIDGET_VOLUME_SLIDER_WIDTH, -1);
+	gtk_container_add(GTK_CONTAINER(alignment), volume);
+	priv->volume = volume;
+
+	alignment = gtk_alignment_new(0, 0.5, 0, 0);
+	gtk_box_pack_start(GTK_BOX(header), alignment, FALSE, FALSE, 0);
+
+	inner_box = gtk_hbox_new(FALSE, 6);
+	gtk_container_add(GTK_CONTAINER(alignment), inner_box);
+
+	value = g_object_new(GTK_TYPE_LABEL,
+	                     "width-chars", WIDGET_VALUE_WIDTH_IN_CHARS,
+	                     "xalign", 1.0f,
+	                     NULL);
+	gtk_box_pack_start(GTK_BOX(inner_box), value, FALSE, FALSE, 0);
+	priv->value = value;
+
+	mute = gtk_check_button_new();
+	gtk_toggle_button_set_mode(GTK_TOGGLE_BUTTON(mute), FALSE);
+	gtk_widget_set_tooltip_text(GTK_WIDGET(mute), _("Mute all of this application's audio output"));
+	gtk_container_add(GTK_CONTAINER(mute), gtk_image_new_from_icon_name("audio-volume-muted", GTK_ICON_SIZE_MENU));
+	gtk_box_pack_start(GTK_BOX(inner_box), mute, FALSE, FALSE, 0);
+	priv->mute = mute;
+
+	/* The member widgets are only built while the group is expanded */
+	members_align = g_object_new(GTK_TYPE_ALIGNMENT,
+	                             "xscale", 1.0f,
+	                             "left-padding", 24,
+	                             "no-show-all", TRUE,
+	                             NULL);
+	gtk_box_pack_start(GTK_BOX(widget), members_align, FALSE, FALSE, 0);
+	priv->members_align = members_align;
+
+	members_box = gtk_vbox_new(FALSE, 6);
+	gtk_container_add(GTK_CONTAINER(members_align), members_box);
+	priv->members_box = members_box;
+
+	g_signal_connect(volume, "value-changed", G_CALLBACK(pama_sink_input_group_widget_volume_changed), widget);
+	g_signal_connect(mute,   "toggled",       G_CALLBACK(pama_sink_input_group_widget_mute_toggled),   widget);
+	g_signal_connect(expand, "toggled",       G_CALLBACK(pama_sink_input_group_widget_expand_toggled), widget);
+
+	return gobject;
+}
+static void pama_sink_input_group_widget_dispose(GObject *gobject)
+{
+	PamaSinkInputGroupWidget *widget = PAMA_SINK_INPUT_GROUP_WIDGET(gobject);
+	PamaSinkInputGroupWidgetPrivate *priv = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(widget);
+	GSList *iter;
+
+	for (iter = priv->sink_inputs; iter; iter = iter->next)
+	{
+		g_signal_handlers_disconnect_by_func(iter->data, pama_sink_input_group_widget_sink_input_notify, widget);
+		g_object_weak_unref(G_OBJECT(iter->data), pama_sink_input_group_widget_member_weak_ref_notify, widget);
+	}
+	g_slist_free(priv->sink_inputs);
+	priv->sink_inputs = NULL;
+
+	if (priv->context)
+	{
+		g_object_weak_unref(G_OBJECT(priv->context), pama_sink_input_group_widget_weak_ref_notify, widget);
+		priv->context = NULL;
+	}
+
+	if (priv->icon_sizegroup)
+	{
+		g_object_unref(priv->icon_sizegroup);
+		priv->icon_sizegroup = NULL;
+	}
+
+	if (priv->sink_menu)
+	{
+		g_object_unref(priv->sink_menu);
+		priv->sink_menu = NULL;
+	}
+
+	G_OBJECT_CLASS(pama_sink_input_group_widget_parent_class)->dispose(gobject);
+}
+static void pama_sink_input_group_widget_finalize(GObject *gobject)
+{
+	PamaSinkInputGroupWidgetPrivate *priv = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(gobject);
+
+	g_free(priv->key);
+
+	G_OBJECT_CLASS(pama_sink_input_group_widget_parent_class)->finalize(gobject);
+}
+static void pama_sink_input_group_widget_weak_ref_notify(gpointer data, GObject *where_the_object_was)
+{
+	PamaSinkInputGroupWidget *widget = data;
+	PamaSinkInputGroupWidgetPrivate *priv = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(widget);
+
+	if ((GObject *)priv->context == where_the_object_was)
+		priv->context = NULL;
+
+	/* widget is no longer usable without the context. */
+	gtk_object_destroy(GTK_OBJECT(widget));
+}
+static void pama_sink_input_group_widget_member_weak_ref_notify(gpointer data, GObject *where_the_object_was)
+{
+	PamaSinkInputGroupWidget *widget = data;
+	PamaSinkInputGroupWidgetPrivate *priv = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(widget);
+
+	priv->sink_inputs = g_slist_remove(priv->sink_inputs, where_the_object_was);
+
+	/* The last member is gone; so is the group */
+	if (!priv->sink_inputs)
+		gtk_object_destroy(GTK_OBJECT(widget));
+	else
+		pama_sink_input_group_widget_update_values(widget);
+}
+
+
+static void pama_sink_input_group_widget_sink_input_notify(GObject *gobject, GParamSpec *pspec, PamaSinkInputGroupWidget *widget)
+{
+	if (strcmp(pspec->name, "volume") && strcmp(pspec->name, "mute"))
+		return;
+
+	pama_sink_input_group_widget_update_values(widget);
+}
+
+// Names are ellipsized, so their tooltip shows the whole label. It is only
+// built when the tooltip is about to be shown.
+static gboolean pama_sink_input_group_widget_name_query_tooltip(GtkWidget *label, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data)
+{
+	gtk_tooltip_set_markup(tooltip, gtk_label_get_label(GTK_LABEL(label)));
+	return TRUE;
+}
+
+static void pama_sink_input_group_widget_update_values(PamaSinkInputGroupWidget *widget)
+{
+	PamaSinkInputGroupWidgetPrivate *priv = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(widget);
+	PamaPulseSinkInput *first;
+	PamaPulseClient    *client;
+	GIcon    *icon;
+	GSList   *iter;
+	gchar    *temp, *count;
+	gchar    *client_name, *hostname;
+	gboolean  is_local;
+	gboolean  all_muted = TRUE;
+	guint     volume, max_volume = PA_VOLUME_MUTED;
+	gboolean  mute;
+	guint     n_sink_inputs;
+	double    volume_dB;
+
+	if (!priv->sink_inputs)
+		return;
+
+	priv->updating = TRUE;
+
+	for (iter = priv->sink_inputs; iter; iter = iter->next)
+	{
+		g_object_get(iter->data,
+		             "volume", &volume,
+		             "mute",   &mute,
+		             NULL);
+
+		max_volume = MAX(max_volume, volume);
+		all_muted  = all_muted && mute;
+	}
+
+	first = PAMA_PULSE_SINK_INPUT(priv->sink_inputs->data);
+	g_object_get(first, "client", &client, NULL);
+	g_object_get(client,
+	             "name",     &client_name,
+	             "hostname", &hostname,
+	             "is-local", &is_local,
+	             NULL);
+
+	icon = pama_pulse_sink_input_build_gicon(first);
+	pama_icon_cache_set_image(GTK_IMAGE(priv->icon), icon, WIDGET_ICON_SIZE);
+	g_object_unref(icon);
+
+	n_sink_inputs = g_slist_length(priv->sink_inputs);
+	count = g_strdup_printf(ngettext("%u stream", "%u streams", n_sink_inputs), n_sink_inputs);
+	if (is_local)
+		temp = g_markup_printf_escaped("<b>%s</b>\n%s", client_name, count);
+	else
+		temp = g_markup_printf_escaped("<b>%s</b> (on %s)\n%s", client_name, hostname, count);
+	gtk_label_set_markup(GTK_LABEL(priv->name), temp);
+	g_free(temp);
+	g_free(count);
+	g_free(client_name);
+	g_free(hostname);
+	g_object_unref(client);
+
+	volume_dB = pama_volume_map_to_dB(max_volume);
+	if (isinf(volume_dB))
+		gtk_label_set_text(GTK_LABEL(priv->value), "-∞dB");
+	else
+	{
+		temp = g_strdup_printf("%+.1fdB", volume_dB);
+		gtk_label_set_text(GTK_LABEL(priv->value), temp);
+		g_free(temp);
+	}
+
+	/* The slider shows the loudest member */
+	gtk_range_set_value(GTK_RANGE(priv->volume), pama_volume_map_to_slider(max_volume));
+	gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(priv->mute), all_muted);
+
+	gtk_widget_set_sensitive(priv->volume, !all_muted);
+	gtk_widget_set_sensitive(priv->value,  !all_muted);
+
+	priv->updating = FALSE;
+}
+
+static void pama_sink_input_group_widget_mute_toggled(GtkToggleButton *togglebutton, PamaSinkInputGroupWidget *widget)
+{
+	PamaSinkInputGroupWidgetPrivate *priv = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(widget);
+	gboolean mute = gtk_toggle_button_get_active(togglebutton);
+	GSList *iter;
+
+	if (priv->updating)
+		return;
+
+	for (iter = priv->sink_inputs; iter; iter = iter->next)
+		pama_pulse_sink_input_set_mute(PAMA_PULSE_SINK_INPUT(iter->data), mute);
+}
+// Moves every member by the same number of decibels, so that the loudest one
+// ends up where the slider is and the balance between them is kept. All the
+// requests are issued in one go and leave in the same write to the server.
+static void pama_sink_input_group_widget_volume_changed(GtkRange *range, PamaSinkInputGroupWidget *widget)
+{
+	PamaSinkInputGroupWidgetPrivate *priv = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(widget);
+	double target_dB = pama_volume_map_to_dB(pama_volume_map_from_slider(gtk_range_get_value(range)));
+	double max_volume_dB, delta_dB;
+	guint volume, max_volume = PA_VOLUME_MUTED;
+	GSList *iter;
+
+	if (priv->updating)
+		return;
+
+	/* Measured against the members' last known volumes rather than the slider,
+	 * so a drag that outruns the server's replies does not accumulate */
+	for (iter = priv->sink_inputs; iter; iter = iter->next)
+	{
+		g_object_get(iter->data, "volume", &volume, NULL);
+		max_volume = MAX(max_volume, volume);
+	}
+	max_volume_dB = pama_volume_map_to_dB(max_volume);
+	delta_dB = target_dB - max_volume_dB;
+
+	for (iter = priv->sink_inputs; iter; iter = iter->next)
+	{
+		double volume_dB;
+
+		g_object_get(iter->data, "volume", &volume, NULL);
+		volume_dB = pama_volume_map_to_dB(volume);
+
+		/* Silent members have nothing to keep the balance with */
+		if (isinf(volume_dB) || isinf(max_volume_dB))
+			volume_dB = target_dB;
+		else
+			volume_dB = MIN(volume_dB + delta_dB, 0);
+
+		pama_pulse_sink_input_set_volume(PAMA_PULSE_SINK_INPUT(iter->data), pama_volume_map_from_dB(volume_dB));
+	}
+}
+
+static void pama_sink_input_group_widget_expand_toggled(GtkToggleButton *togglebutton, PamaSinkInputGroupWidget *widget)
+{
+	PamaSinkInputGroupWidgetPrivate *priv = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(widget);
+	GList *children, *child;
+	GSList *iter;
+
+	if (gtk_toggle_button_get_active(togglebutton))
+	{
+		gtk_arrow_set(GTK_ARROW(priv->arrow), GTK_ARROW_DOWN, GTK_SHADOW_NONE);
+
+		for (iter = priv->sink_inputs; iter; iter = iter->next)
+			pama_sink_input_group_widget_add_member_widget(widget, PAMA_PULSE_SINK_INPUT(iter->data));
+
+		gtk_widget_show(priv->members_box);
+		gtk_widget_show(priv->members_align);
+	}
+	else
+	{
+		gtk_arrow_set(GTK_ARROW(priv->arrow), GTK_ARROW_RIGHT, GTK_SHADOW_NONE);
+		gtk_widget_hide(priv->members_align);
+
+		/* Collapsed groups cost no more than their header */
+		children = gtk_container_get_children(GTK_CONTAINER(priv->members_box));
+		for (child = children; child; child = child->next)
+			gtk_widget_destroy(GTK_WIDGET(child->data));
+		g_list_free(children);
+	}
+}
+
+static void pama_sink_input_group_widget_add_member_widget(PamaSinkInputGroupWidget *widget, PamaPulseSinkInput *sink_input)
+{
+	PamaSinkInputGroupWidgetPrivate *priv = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(widget);
+	GtkWidget *sink_input_widget;
+
+	sink_input_widget = 
+		g_object_new(PAMA_TYPE_SINK_INPUT_WIDGET,
+		             "context", priv->context, 
+		             "sink-input", sink_input,
+		             "icon-sizegroup", priv->icon_sizegroup,
+		             "sink-menu", priv->sink_menu,
+		             NULL);
+
+	gtk_box_pack_start(GTK_BOX(priv->members_box), sink_input_widget, FALSE, FALSE, 0);
+	gtk_widget_show_all(sink_input_widget);
+}
+
+void pama_sink_input_group_widget_add_sink_input(PamaSinkInputGroupWidget *widget, PamaPulseSinkInput *sink_input)
+{
+	PamaSinkInputGroupWidgetPrivate *priv = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(widget);
+
+	if (g_slist_find(priv->sink_inputs, sink_input))
+		return;
+
+	priv->sink_inputs = g_slist_append(priv->sink_inputs, sink_input);
+	g_object_weak_ref(G_OBJECT(sink_input), pama_sink_input_group_widget_member_weak_ref_notify, widget);
+	g_signal_connect(sink_input, "notify", G_CALLBACK(pama_sink_input_group_widget_sink_input_notify), widget);
+
+	if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(priv->expand)))
+		pama_sink_input_group_widget_add_member_widget(widget, sink_input);
+
+	pama_sink_input_group_widget_update_values(widget);
+}
+
+// Takes a stream out of the group, destroying its row if the group is
+// expanded, and the group itself if it was the last. Returns FALSE if it was
+// no member.
+gboolean pama_sink_input_group_widget_remove_sink_input(PamaSinkInputGroupWidget *widget, PamaPulseSinkInput *sink_input)
+{
+	PamaSinkInputGroupWidgetPrivate *priv = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(widget);
+	GList *children, *iter;
+
+	if (!g_slist_find(priv->sink_inputs, sink_input))
+		return FALSE;
+
+	children = gtk_container_get_children(GTK_CONTAINER(priv->members_box));
+	for (iter = children; iter; iter = iter->next)
+	{
+		if (pama_sink_input_widget_get_sink_input(PAMA_SINK_INPUT_WIDGET(iter->data)) == sink_input)
+			gtk_widget_destroy(GTK_WIDGET(iter->data));
+	}
+	g_list_free(children);
+
+	g_signal_handlers_disconnect_by_func(sink_input, pama_sink_input_group_widget_sink_input_notify, widget);
+	g_object_weak_unref(G_OBJECT(sink_input), pama_sink_input_group_widget_member_weak_ref_notify, widget);
+	pama_sink_input_group_widget_member_weak_ref_notify(widget, G_OBJECT(sink_input));
+	return TRUE;
+}
+
+// Returns the member sink inputs. The list belongs to the widget.
+GSList *pama_sink_input_group_widget_get_sink_inputs(PamaSinkInputGroupWidget *widget)
+{
+	PamaSinkInputGroupWidgetPrivate *priv = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(widget);
+
+	return priv->sink_inputs;
+}
+
+const gchar *pama_sink_input_group_widget_get_key(PamaSinkInputGroupWidget *widget)
+{
+	PamaSinkInputGroupWidgetPrivate *priv = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(widget);
+
+	return priv->key;
+}
+
+// Streams are grouped by the executable they come from, or by client name for
+// clients that do not say; streams on different hosts are never grouped.
+gchar *pama_sink_input_group_widget_build_key(PamaPulseSinkInput *sink_input)
+{
+	PamaPulseClient *client;
+	gchar *process_binary, *client_name, *hostname;
+	gchar *key;
+
+	g_object_get(sink_input, "client", &client, NULL);
+	g_object_get(client,
+	             "process-binary", &process_binary,
+	             "name",           &client_name,
+	             "hostname",       &hostname,
+	             NULL);
+
+	if (*process_binary)
+		key = g_strdup_printf("%s@%s", process_binary, hostname);
+	else
+		key = g_strdup_printf("%s@%s", client_name, hostname);
+
+	g_free(process_binary);
+	g_free(client_name);
+	g_free(hostname);
+	g_object_unref(client);
+
+	return key;
+}
+
+gint pama_sink_input_group_widget_compare(gconstpointer a, gconstpointer b)
+{
+	PamaSinkInputGroupWidgetPrivate *A = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(a);
+	PamaSinkInputGroupWidgetPrivate *B = PAMA_SINK_INPUT_GROUP_WIDGET_GET_PRIVATE(b);
+
+	PamaPulseClient *Ac, *Bc;
+	gint result;
+
+	if (!A->sink_inputs || !B->sink_inputs)
+		return (A->sink_inputs ? 1 : 0) - (B->sink_inputs ? 1 : 0);
+
+	g_object_get(A->sink_inputs->data, "client", &Ac, NULL);
+	g_object_get(B->sink_inputs->data, "client", &Bc, NULL);
+
+	result = pama_pulse_client_compare_by_is_local(Ac, Bc);
+	if (!result)
+	{
+		result = pama_pulse_client_compare_by_hostname(Ac, Bc);
+		if (!result)
+		{
+			result = pama_pulse_client_compare_by_name(Ac, Bc);
+			if (!result)
+				result = strcmp(A->key, B->key);
+		}
+	}
+
+	g_object_unref(Ac);
+	g_object_unref(Bc);
+	return result;
+}
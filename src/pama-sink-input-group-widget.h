@@ -0,0 +1,66 @@
+/*
+ * pama-sink-input-group-widget.h: A widget that controls all sink inputs of one application at once
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_SINK_INPUT_GROUP_WIDGET_H
+#define PAMA_SINK_INPUT_GROUP_WIDGET_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+#include <pulse/pulseaudio.h>
+#include "pama-pulse-context.h"
+
+G_BEGIN_DECLS
+
+#define PAMA_TYPE_SINK_INPUT_GROUP_WIDGET                  (pama_sink_input_group_widget_get_type ())
+#define PAMA_SINK_INPUT_GROUP_WIDGET(obj)                  (G_TYPE_CHECK_INSTANCE_CAST ((obj), PAMA_TYPE_SINK_INPUT_GROUP_WIDGET, PamaSinkInputGroupWidget))
+#define PAMA_IS_SINK_INPUT_GROUP_WIDGET(obj)               (G_TYPE_CHECK_INSTANCE_TYPE ((obj), PAMA_TYPE_SINK_INPUT_GROUP_WIDGET))
+#define PAMA_SINK_INPUT_GROUP_WIDGET_CLASS(klass)          (G_TYPE_CHECK_CLASS_CAST ((klass), PAMA_TYPE_SINK_INPUT_GROUP_WIDGET, PamaSinkInputGroupWidgetClass))
+#define PAMA_IS_SINK_INPUT_GROUP_WIDGET_CLASS(klass)       (G_TYPE_CHECK_CLASS_TYPE ((klass), PAMA_TYPE_SINK_INPUT_GROUP_WIDGET))
+#define PAMA_SINK_INPUT_GROUP_WIDGET_GET_CLASS(obj)        (G_TYPE_INSTANCE_GET_CLASS ((obj), PAMA_TYPE_SINK_INPUT_GROUP_WIDGET, PamaSinkInputGroupWidgetClass))
+
+typedef struct _PamaSinkInputGroupWidget        PamaSinkInputGroupWidget;
+typedef struct _PamaSinkInputGroupWidgetClass   PamaSinkInputGroupWidgetClass;
+typedef struct _PamaSinkInputGroupWidgetPrivate PamaSinkInputGroupWidgetPrivate;
+
+struct _PamaSinkInputGroupWidget
+{
+	GtkVBox parent_instance;
+};
+
+struct _PamaSinkInputGroupWidgetClass
+{
+	GtkVBoxClass parent_class;
+};
+
+GType pama_sink_input_group_widget_get_type();
+
+/* methods */
+gint         pama_sink_input_group_widget_compare(gconstpointer a, gconstpointer b);
+gchar       *pama_sink_input_group_widget_build_key(PamaPulseSinkInput *sink_input);
+const gchar *pama_sink_input_group_widget_get_key(PamaSinkInputGroupWidget *widget);
+void         pama_sink_input_group_widget_add_sink_input(PamaSinkInputGroupWidget *widget, PamaPulseSinkInput *sink_input);
+gboolean     pama_sink_input_group_widget_remove_sink_input(PamaSinkInputGroupWidget *widget, PamaPulseSinkInput *sink_input);
+GSList      *pama_sink_input_group_widget_get_sink_inputs(PamaSinkInputGroupWidget *widget);
+
+G_END_DECLS
+
+#endif /* PAMA_SINK_INPUT_GROUP_WIDGET_H */
+
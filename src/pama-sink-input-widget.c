@@ -25,6 +25,15 @@
 #include <glib/gi18n.h>
  
 #include "pama-sink-input-widget.h"
+#include "pama-device-menu.h"
+#include "pama-feedback-sound.h"
+#include "pama-icon-cache.h"
+#include "pama-latency-poll.h"
+#include "pama-clip-history.h"
+#include "pama-meter-clock.h"
+#include "pama-meter-budget.h"
+#include "pama-pulse-meter.h"
+#include "pama-volume-map.h"
 #include "widget-settings.h"
 
 static void     pama_sink_input_widget_class_init(PamaSinkInputWidgetClass *klass);
@@ -35,24 +44,42 @@ static void     pama_sink_input_widget_dispose(GObject *gobject);
 static void     pama_sink_input_widget_weak_ref_notify(gpointer data, GObject *where_the_object_was);
 
 static void     pama_sink_input_widget_sink_input_notify(GObject *gobject, GParamSpec *pspec, PamaSinkInputWidget *widget);
+static void     pama_sink_input_widget_corked_notify    (GObject *gobject, GParamSpec *pspec, PamaSinkInputWidget *widget);
 
 static void     pama_sink_input_widget_update_values(PamaSinkInputWidget *widget);
+static gboolean pama_sink_input_widget_name_query_tooltip(GtkWidget *label, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data);
+static void     pama_sink_input_widget_map(GtkWidget *gtk_widget, gpointer data);
+static void     pama_sink_input_widget_unmap(GtkWidget *gtk_widget, gpointer data);
+static void     pama_sink_input_widget_update_meter(PamaSinkInputWidget *widget);
+static void     pama_sink_input_widget_meter_granted(gpointer owner, gboolean granted);
+static void     pama_sink_input_widget_start_meter(PamaSinkInputWidget *widget);
+static void     pama_sink_input_widget_stop_meter (PamaSinkInputWidget *widget);
+static void     pama_sink_input_widget_level_notify(GObject *gobject, GParamSpec *pspec, gpointer data);
+static void     pama_sink_input_widget_clipping_notify(GObject *gobject, GParamSpec *pspec, gpointer data);
+static void     pama_sink_input_widget_loudness_notify(GObject *gobject, GParamSpec *pspec, gpointer data);
+static gboolean pama_sink_input_widget_loudness_query_tooltip(GtkWidget *label, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data);
+static void     pama_sink_input_widget_latency_notify(GObject *gobject, GParamSpec *pspec, gpointer data);
+static gboolean pama_sink_input_widget_latency_query_tooltip(GtkWidget *label, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data);
+static void     pama_sink_input_widget_set_polling(PamaSinkInputWidget *widget, gboolean polling);
 static void     pama_sink_input_widget_mute_toggled(GtkToggleButton *togglebutton, PamaSinkInputWidget *widget);
 static void     pama_sink_input_widget_volume_changed(GtkRange *range, PamaSinkInputWidget *widget);
+static void     pama_sink_input_widget_balance_changed(GtkRange *range, PamaSinkInputWidget *widget);
 
 static void     pama_sink_input_widget_sink_button_clicked(GtkButton *button, PamaSinkInputWidget *widget);
-static void     pama_sink_input_widget_sink_menu_hidden(GtkWidget *menu_window, PamaSinkInputWidget *widget);
-static void     pama_sink_input_widget_sink_menu_item_toggled(GtkCheckMenuItem *item, PamaSinkInputWidget *widget);
 
 struct _PamaSinkInputWidgetPrivate
 {
-	GtkWidget *icon, *name, *volume, *value, *mute, *sink_button, *sink_menu, *sink_button_image;
+	GtkWidget *icon, *name, *volume, *level, *loudness, *latency, *balance, *value, *mute, *sink_button, *sink_menu, *sink_button_image;
 	GtkSizeGroup       *icon_sizegroup;
 	PamaPulseContext   *context;
 	PamaPulseSinkInput *sink_input;
 	gboolean            updating;
+	gboolean            dirty;
+	gboolean            polling;
+	PamaPulseMeter     *meter;
+	PamaPulseSink      *meter_sink; /* only compared against, never dereferenced */
 	
-	gulong context_notify_handler_id, sink_input_notify_handler_id;
+	gulong context_notify_handler_id, sink_input_notify_handler_id, sink_input_corked_handler_id, latency_notify_handler_id;
 };
 
 G_DEFINE_TYPE(PamaSinkInputWidget, pama_sink_input_widget, GTK_TYPE_HBOX);
@@ -64,7 +91,8 @@ enum
 
 	PROP_SINK_INPUT,
 	PROP_CONTEXT,
-	PROP_ICON_SIZEGROUP
+	PROP_ICON_SIZEGROUP,
+	PROP_SINK_MENU
 };
 enum
 {
@@ -103,6 +131,13 @@ static void pama_sink_input_widget_class_init(PamaSinkInputWidgetClass *klass)
 	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
 	g_object_class_install_property(gobject_class, PROP_ICON_SIZEGROUP, pspec);
 
+	pspec = g_param_spec_object("sink-menu",
+	                            "Sink menu",
+	                            "The PamaDeviceMenu used to move the sink input to another sink.",
+	                            PAMA_TYPE_DEVICE_MENU,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_SINK_MENU, pspec);
+
 	widget_signals[REORDER_REQUEST_SIGNAL] =
 		g_signal_new("reorder-request",
 		             G_TYPE_FROM_CLASS(gobject_class),
@@ -142,6 +177,10 @@ static void pama_sink_input_widget_set_property(GObject *gobject, guint property
 			priv->icon_sizegroup = g_value_dup_object(value);
 			break;
 
+		case PROP_SINK_MENU:
+			priv->sink_menu = g_value_dup_object(value);
+			break;
+
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
 			break;
@@ -150,7 +189,7 @@ static void pama_sink_input_widget_set_property(GObject *gobject, guint property
 static GObject* pama_sink_input_widget_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties)
 {
 	GtkWidget *icon, *name, *alignment;
-	GtkWidget *inner_box, *volume, *value, *mute, *sink_button, *sink_button_image;
+	GtkWidget *inner_box, *volume_box, *volume, *level, *loudness, *latency, *balance, *value, *mute, *sink_button, *sink_button_image;
 
 	GObject *gobject = G_OBJECT_CLASS(pama_sink_input_widget_parent_class)->constructor(gtype, n_properties, properties);
 	PamaSinkInputWidget *widget = PAMA_SINK_INPUT_WIDGET(gobject);
@@ -162,6 +201,8 @@ static GObject* pama_sink_input_widget_constructor(GType gtype, guint n_properti
 		g_error("An attempt was made to create a sink_input widget with no context.");
 	if (NULL == priv->icon_sizegroup)
 		g_error("An attempt was made to create a sink_input widget with no icon sizegroup");
+	if (NULL == priv->sink_menu)
+		g_error("An attempt was made to create a sink_input widget with no sink menu.");
 
 	alignment = gtk_alignment_new(0, 0.5, 0, 0);
 	gtk_alignment_set_padding(GTK_ALIGNMENT(alignment), 0, 0, 0, 6);
@@ -174,12 +215,14 @@ static GObject* pama_sink_input_widget_constructor(GType gtype, guint n_properti
 
 	name = g_object_new(GTK_TYPE_LABEL,
 	                    "ellipsize", PANGO_ELLIPSIZE_MIDDLE,
+	                    "has-tooltip", TRUE,
 	                    "wrap", FALSE,
 	                    "width-chars", WIDGET_NAME_WIDTH_IN_CHARS,
 	                    "xalign", 0.0f,
 	                    NULL);
 	gtk_box_pack_start(GTK_BOX(widget), name, FALSE, FALSE, 0);
 	priv->name = name;
+	g_signal_connect(name, "query-tooltip", G_CALLBACK(pama_sink_input_widget_name_query_tooltip), widget);
 
 	alignment = gtk_alignment_new(0, 0.5, 0, 0);
 	gtk_box_pack_start(GTK_BOX(widget), alignment, FALSE, FALSE, 0);
@@ -187,15 +230,58 @@ static GObject* pama_sink_input_widget_constructor(GType gtype, guint n_properti
 	volume = gtk_hscale_new_with_range(0, WIDGET_VOLUME_SLIDER_DB_RANGE, 2.5); /* for scroll steps of 5dB */
 	gtk_scale_set_draw_value   (GTK_SCALE(volume), FALSE);
 	gtk_widget_set_size_request(volume, WIDGET_VOLUME_SLIDER_WIDTH, -1);
-	gtk_container_add(GTK_CONTAINER(alignment), volume);
+	volume_box = gtk_vbox_new(FALSE, 0);
+	gtk_container_add(GTK_CONTAINER(alignment), volume_box);
+	gtk_box_pack_start(GTK_BOX(volume_box), volume, FALSE, FALSE, 0);
 	priv->volume = volume;
 
+	/* Peak level, fed only while a meter is granted from the shared budget */
+	level = gtk_progress_bar_new();
+	gtk_widget_set_size_request(level, WIDGET_VOLUME_SLIDER_WIDTH, WIDGET_LEVEL_METER_HEIGHT);
+	gtk_box_pack_start(GTK_BOX(volume_box), level, FALSE, FALSE, 0);
+	priv->level = level;
+
+	/* Only shown for channel maps that have a left and a right */
+	alignment = gtk_alignment_new(0, 0.5, 0, 0);
+	gtk_box_pack_start(GTK_BOX(widget), alignment, FALSE, FALSE, 0);
+
+	balance = gtk_hscale_new_with_range(-1.0, 1.0, 0.1);
+	gtk_scale_set_draw_value   (GTK_SCALE(balance), FALSE);
+	gtk_scale_add_mark         (GTK_SCALE(balance), 0.0, GTK_POS_BOTTOM, NULL);
+	gtk_widget_set_size_request(balance, WIDGET_BALANCE_SLIDER_WIDTH, -1);
+	gtk_widget_set_tooltip_text(balance, _("Balance between the left and right speakers"));
+	gtk_widget_set_no_show_all (balance, TRUE);
+	gtk_container_add(GTK_CONTAINER(alignment), balance);
+	priv->balance = balance;
+
 	alignment = gtk_alignment_new(0, 0.5, 0, 0);
 	gtk_box_pack_start(GTK_BOX(widget), alignment, FALSE, FALSE, 0);
 
 	inner_box = gtk_hbox_new(FALSE, 6);
 	gtk_container_add(GTK_CONTAINER(alignment), inner_box);
 
+	/* Only shown while the meter measures loudness */
+	loudness = g_object_new(GTK_TYPE_LABEL,
+	                        "width-chars", WIDGET_LOUDNESS_WIDTH_IN_CHARS,
+	                        "xalign", 1.0f,
+	                        "has-tooltip", TRUE,
+	                        NULL);
+	gtk_widget_set_no_show_all(loudness, TRUE);
+	gtk_box_pack_start(GTK_BOX(inner_box), loudness, FALSE, FALSE, 0);
+	g_signal_connect(loudness, "query-tooltip", G_CALLBACK(pama_sink_input_widget_loudness_query_tooltip), widget);
+	priv->loudness = loudness;
+
+	/* Only shown when latency is polled */
+	latency = g_object_new(GTK_TYPE_LABEL,
+	                       "width-chars", WIDGET_LATENCY_WIDTH_IN_CHARS,
+	                       "xalign", 1.0f,
+	                       "has-tooltip", TRUE,
+	                       NULL);
+	gtk_widget_set_no_show_all(latency, 0 == pama_latency_poll_get_interval());
+	gtk_box_pack_start(GTK_BOX(inner_box), latency, FALSE, FALSE, 0);
+	g_signal_connect(latency, "query-tooltip", G_CALLBACK(pama_sink_input_widget_latency_query_tooltip), widget);
+	priv->latency = latency;
+
 	value = g_object_new(GTK_TYPE_LABEL,
 	                     "width-chars", WIDGET_VALUE_WIDTH_IN_CHARS,
 	                     "xalign", 1.0f,
@@ -222,10 +308,16 @@ static GObject* pama_sink_input_widget_constructor(GType gtype, guint n_properti
 	pama_sink_input_widget_update_values(widget);
 
 	g_signal_connect(volume,      "value-changed", G_CALLBACK(pama_sink_input_widget_volume_changed),      widget);
+	g_signal_connect(balance,     "value-changed", G_CALLBACK(pama_sink_input_widget_balance_changed),     widget);
 	g_signal_connect(mute,        "toggled",       G_CALLBACK(pama_sink_input_widget_mute_toggled),        widget);
 	g_signal_connect(sink_button, "clicked",       G_CALLBACK(pama_sink_input_widget_sink_button_clicked), widget);
 
 	priv->sink_input_notify_handler_id = g_signal_connect(priv->sink_input, "notify::volume", G_CALLBACK(pama_sink_input_widget_sink_input_notify), widget);
+	priv->latency_notify_handler_id = g_signal_connect(priv->sink_input, "notify::sink-latency", G_CALLBACK(pama_sink_input_widget_latency_notify), widget);
+	pama_sink_input_widget_latency_notify(G_OBJECT(priv->sink_input), NULL, widget);
+	priv->sink_input_corked_handler_id = g_signal_connect(priv->sink_input, "notify::corked", G_CALLBACK(pama_sink_input_widget_corked_notify),     widget);
+	g_signal_connect(widget, "map",   G_CALLBACK(pama_sink_input_widget_map),   NULL);
+	g_signal_connect(widget, "unmap", G_CALLBACK(pama_sink_input_widget_unmap), NULL);
 
 	/* We no longer need to keep a reference to the icon sizegroup */
 	g_object_unref(priv->icon_sizegroup);
@@ -238,6 +330,9 @@ static void pama_sink_input_widget_dispose(GObject *gobject)
 	PamaSinkInputWidget *widget = PAMA_SINK_INPUT_WIDGET(gobject);
 	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(widget);
 
+	pama_meter_budget_release(widget);
+	pama_sink_input_widget_stop_meter(widget);
+
 	if (priv->sink_input)
 	{
 		if (priv->sink_input_notify_handler_id)
@@ -245,6 +340,18 @@ static void pama_sink_input_widget_dispose(GObject *gobject)
 			g_signal_handler_disconnect(priv->sink_input, priv->sink_input_notify_handler_id);
 			priv->sink_input_notify_handler_id = 0;
 		}
+		if (priv->latency_notify_handler_id)
+		{
+			g_signal_handler_disconnect(priv->sink_input, priv->latency_notify_handler_id);
+			priv->latency_notify_handler_id = 0;
+		}
+
+		pama_sink_input_widget_set_polling(widget, FALSE);
+		if (priv->sink_input_corked_handler_id)
+		{
+			g_signal_handler_disconnect(priv->sink_input, priv->sink_input_corked_handler_id);
+			priv->sink_input_corked_handler_id = 0;
+		}
 
 		g_object_weak_unref(G_OBJECT(priv->sink_input), pama_sink_input_widget_weak_ref_notify, widget);
 		priv->sink_input = NULL;
@@ -288,9 +395,253 @@ static void pama_sink_input_widget_weak_ref_notify(gpointer data, GObject *where
 
 static void pama_sink_input_widget_sink_input_notify(GObject *gobject, GParamSpec *pspec, PamaSinkInputWidget *widget)
 {
+	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(widget);
+
+	/* Hidden widgets, such as those in a collapsed group, catch up when they are shown */
+	if (!GTK_WIDGET_MAPPED(widget))
+	{
+		priv->dirty = TRUE;
+		return;
+	}
+
+	pama_sink_input_widget_update_values(widget);
+	g_signal_emit(widget, widget_signals[REORDER_REQUEST_SIGNAL], 0);
+}
+static void pama_sink_input_widget_map(GtkWidget *gtk_widget, gpointer data)
+{
+	PamaSinkInputWidget *widget = PAMA_SINK_INPUT_WIDGET(gtk_widget);
+	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(widget);
+
+	pama_sink_input_widget_update_meter(widget);
+	pama_sink_input_widget_set_polling(widget, TRUE);
+
+	if (!priv->dirty)
+		return;
+
+	priv->dirty = FALSE;
 	pama_sink_input_widget_update_values(widget);
 	g_signal_emit(widget, widget_signals[REORDER_REQUEST_SIGNAL], 0);
 }
+static void pama_sink_input_widget_unmap(GtkWidget *gtk_widget, gpointer data)
+{
+	pama_sink_input_widget_update_meter(PAMA_SINK_INPUT_WIDGET(gtk_widget));
+	pama_sink_input_widget_set_polling(PAMA_SINK_INPUT_WIDGET(gtk_widget), FALSE);
+}
+// Every update of the sink input notifies this, so it also catches the
+// stream being moved to another sink.
+static void pama_sink_input_widget_corked_notify(GObject *gobject, GParamSpec *pspec, PamaSinkInputWidget *widget)
+{
+	pama_sink_input_widget_update_meter(widget);
+}
+
+// Only visible rows of playing streams compete for a meter. A stream that
+// moved needs a new one, as meters record from the monitor of a single sink.
+static void pama_sink_input_widget_update_meter(PamaSinkInputWidget *widget)
+{
+	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(widget);
+	PamaPulseSink *sink;
+	gboolean       corked;
+
+	g_object_get(priv->sink_input,
+	             "corked", &corked,
+	             "sink",   &sink,
+	             NULL);
+
+	if (corked || !GTK_WIDGET_MAPPED(widget))
+	{
+		pama_meter_budget_release(widget);
+		pama_sink_input_widget_stop_meter(widget);
+	}
+	else if (priv->meter && sink != priv->meter_sink)
+	{
+		pama_sink_input_widget_stop_meter(widget);
+		pama_sink_input_widget_start_meter(widget);
+	}
+	else
+		pama_meter_budget_request(widget, pama_sink_input_widget_meter_granted);
+
+	if (sink)
+		g_object_unref(sink);
+}
+static void pama_sink_input_widget_meter_granted(gpointer owner, gboolean granted)
+{
+	if (granted)
+		pama_sink_input_widget_start_meter(PAMA_SINK_INPUT_WIDGET(owner));
+	else
+		pama_sink_input_widget_stop_meter(PAMA_SINK_INPUT_WIDGET(owner));
+}
+static void pama_sink_input_widget_start_meter(PamaSinkInputWidget *widget)
+{
+	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(widget);
+	PamaPulseSink *sink;
+
+	if (priv->meter || !priv->sink_input || !priv->context)
+		return;
+
+	priv->meter = pama_pulse_meter_new_for_sink_input(priv->context, priv->sink_input);
+	if (NULL == priv->meter)
+		return;
+
+	g_object_get(priv->sink_input, "sink", &sink, NULL);
+	priv->meter_sink = sink;
+	if (sink)
+		g_object_unref(sink);
+
+	pama_meter_clock_add(GTK_PROGRESS_BAR(priv->level));
+	g_signal_connect(priv->meter, "notify::level", G_CALLBACK(pama_sink_input_widget_level_notify), widget);
+	g_signal_connect(priv->meter, "notify::clipping", G_CALLBACK(pama_sink_input_widget_clipping_notify), widget);
+	pama_sink_input_widget_clipping_notify(G_OBJECT(priv->meter), NULL, widget);
+
+	if (pama_pulse_meter_get_measures_loudness(priv->meter))
+	{
+		g_signal_connect(priv->meter, "notify::momentary", G_CALLBACK(pama_sink_input_widget_loudness_notify), widget);
+		pama_sink_input_widget_loudness_notify(G_OBJECT(priv->meter), NULL, widget);
+		gtk_widget_show(priv->loudness);
+	}
+}
+static void pama_sink_input_widget_stop_meter(PamaSinkInputWidget *widget)
+{
+	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(widget);
+
+	if (NULL == priv->meter)
+		return;
+
+	g_signal_handlers_disconnect_by_func(priv->meter, pama_sink_input_widget_level_notify,    widget);
+	g_signal_handlers_disconnect_by_func(priv->meter, pama_sink_input_widget_clipping_notify, widget);
+	g_signal_handlers_disconnect_by_func(priv->meter, pama_sink_input_widget_loudness_notify, widget);
+	g_object_unref(priv->meter);
+	priv->meter = NULL;
+	priv->meter_sink = NULL;
+
+	pama_meter_clock_remove(GTK_PROGRESS_BAR(priv->level));
+	gtk_widget_hide(priv->loudness);
+}
+static void pama_sink_input_widget_level_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
+{
+	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(data);
+
+	pama_meter_clock_push(GTK_PROGRESS_BAR(priv->level), pama_pulse_meter_get_level(PAMA_PULSE_METER(gobject)));
+}
+// Names of rows that clipped lately stand out until the clipping has aged out
+// of the history. The history itself outlives the meter.
+static void pama_sink_input_widget_clipping_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
+{
+	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(data);
+	GdkColor color;
+
+	if (pama_pulse_meter_get_clipping(PAMA_PULSE_METER(gobject)) && gdk_color_parse(WIDGET_CLIP_COLOR, &color))
+		gtk_widget_modify_fg(priv->name, GTK_STATE_NORMAL, &color);
+	else
+		gtk_widget_modify_fg(priv->name, GTK_STATE_NORMAL, NULL);
+}
+static void pama_sink_input_widget_loudness_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
+{
+	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(data);
+	gdouble momentary = pama_pulse_meter_get_momentary(PAMA_PULSE_METER(gobject));
+	gchar  *temp;
+
+	/* Anything quieter than the absolute gate of EBU R128 counts as silence */
+	if (momentary < WIDGET_LOUDNESS_FLOOR)
+		gtk_label_set_text(GTK_LABEL(priv->loudness), "-∞ LUFS");
+	else
+	{
+		temp = g_strdup_printf("%.0f LUFS", momentary);
+		gtk_label_set_text(GTK_LABEL(priv->loudness), temp);
+		g_free(temp);
+	}
+}
+// The label changes ten times a second, so its tooltip is only built when it
+// is about to be shown.
+static gboolean pama_sink_input_widget_loudness_query_tooltip(GtkWidget *label, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data)
+{
+	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(data);
+	gchar *text;
+
+	if (NULL == priv->meter || !pama_pulse_meter_get_measures_loudness(priv->meter))
+		return FALSE;
+
+	text = g_strdup_printf(_("Momentary loudness: %.1f LUFS\nShort-term loudness: %.1f LUFS"),
+	                       MAX(pama_pulse_meter_get_momentary (priv->meter), WIDGET_LOUDNESS_FLOOR),
+	                       MAX(pama_pulse_meter_get_short_term(priv->meter), WIDGET_LOUDNESS_FLOOR));
+	gtk_tooltip_set_text(tooltip, text);
+	g_free(text);
+	return TRUE;
+}
+static void pama_sink_input_widget_latency_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
+{
+	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(data);
+	guint64 buffer_latency, sink_latency;
+	gchar  *temp;
+
+	g_object_get(gobject,
+	             "buffer-latency", &buffer_latency,
+	             "sink-latency",   &sink_latency,
+	             NULL);
+
+	/* What the application has queued plays after whatever the sink holds */
+	temp = g_strdup_printf(_("%.1f ms"), (buffer_latency + sink_latency) / 1000.0);
+	gtk_label_set_text(GTK_LABEL(priv->latency), temp);
+	g_free(temp);
+}
+// Latency is updated on every poll, so its tooltip is only built when it is
+// about to be shown.
+static gboolean pama_sink_input_widget_latency_query_tooltip(GtkWidget *label, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data)
+{
+	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(data);
+	guint64 buffer_latency, sink_latency;
+	gchar  *text;
+
+	if (NULL == priv->sink_input)
+		return FALSE;
+
+	g_object_get(priv->sink_input,
+	             "buffer-latency", &buffer_latency,
+	             "sink-latency",   &sink_latency,
+	             NULL);
+
+	text = g_strdup_printf(_("Buffered: %.1f ms\nOutput device: %.1f ms"), buffer_latency / 1000.0, sink_latency / 1000.0);
+	gtk_tooltip_set_text(tooltip, text);
+	g_free(text);
+	return TRUE;
+}
+// Latency is only asked for while the row is on screen.
+static void pama_sink_input_widget_set_polling(PamaSinkInputWidget *widget, gboolean polling)
+{
+	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(widget);
+
+	if (polling == priv->polling || NULL == priv->sink_input || (polling && NULL == priv->context))
+		return;
+
+	if (polling)
+		pama_latency_poll_add(priv->context, G_OBJECT(priv->sink_input));
+	else
+		pama_latency_poll_remove(G_OBJECT(priv->sink_input));
+	priv->polling = polling;
+}
+
+// Names are ellipsized, so their tooltip shows the whole label. It is only
+// built when the tooltip is about to be shown.
+static gboolean pama_sink_input_widget_name_query_tooltip(GtkWidget *label, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data)
+{
+	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(data);
+	gchar *clipping, *markup;
+
+	clipping = pama_clip_history_describe(G_OBJECT(priv->sink_input));
+
+	if (NULL == clipping)
+	{
+		gtk_tooltip_set_markup(tooltip, gtk_label_get_label(GTK_LABEL(label)));
+		return TRUE;
+	}
+
+	markup = g_markup_escape_text(clipping, -1);
+	g_free(clipping);
+	clipping = g_strdup_printf("%s\n<span foreground=\"%s\">%s</span>", gtk_label_get_label(GTK_LABEL(label)), WIDGET_CLIP_COLOR, markup);
+	gtk_tooltip_set_markup(tooltip, clipping);
+	g_free(clipping);
+	g_free(markup);
+	return TRUE;
+}
 
 static void pama_sink_input_widget_update_values(PamaSinkInputWidget *widget)
 {
@@ -307,6 +658,8 @@ static void pama_sink_input_widget_update_values(PamaSinkInputWidget *widget)
 	GIcon           *icon;
 
 	double volume_dB;
+	const pa_cvolume     *cvolume;
+	const pa_channel_map *channel_map;
 
 	priv->updating = TRUE;
 
@@ -326,10 +679,7 @@ static void pama_sink_input_widget_update_values(PamaSinkInputWidget *widget)
 	             NULL);
 
 	icon = pama_pulse_sink_input_build_gicon(priv->sink_input);
-	g_object_set(priv->icon,
-	             "gicon", icon,
-	             "pixel-size", 32,
-	             NULL);
+	pama_icon_cache_set_image(GTK_IMAGE(priv->icon), icon, WIDGET_ICON_SIZE);
 	g_object_unref(icon);
 
 	if (is_local)
@@ -337,12 +687,11 @@ static void pama_sink_input_widget_update_values(PamaSinkInputWidget *widget)
 	else
 		temp = g_markup_printf_escaped("<b>%s</b> (on %s)\n%s", client_name, hostname, stream_name);
 	gtk_label_set_markup(GTK_LABEL(priv->name), temp);
-	gtk_widget_set_tooltip_markup(GTK_WIDGET(priv->name), temp);
 	g_free(temp);
 	g_free(stream_name);
 	g_free(client_name);
 
-	volume_dB = pa_sw_volume_to_dB(volume);
+	volume_dB = pama_volume_map_to_dB(volume);
 	if (isinf(volume_dB))
 		gtk_label_set_text(GTK_LABEL(priv->value), "-∞dB");
 	else
@@ -352,20 +701,31 @@ static void pama_sink_input_widget_update_values(PamaSinkInputWidget *widget)
 		g_free(temp);
 	}
 
-	gtk_range_set_value(GTK_RANGE(priv->volume), volume_dB + WIDGET_VOLUME_SLIDER_DB_RANGE);
+	gtk_range_set_value(GTK_RANGE(priv->volume), pama_volume_map_to_slider(volume));
 	gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(priv->mute), mute);
 
 	gtk_widget_set_sensitive(priv->volume, !mute);
 	gtk_widget_set_sensitive(priv->value,  !mute);
 
+	cvolume     = pama_pulse_sink_input_get_cvolume(priv->sink_input);
+	channel_map = pama_pulse_sink_input_get_channel_map(priv->sink_input);
+	if (pa_channel_map_can_balance(channel_map))
+	{
+		gtk_range_set_value(GTK_RANGE(priv->balance), pa_cvolume_get_balance(cvolume, channel_map));
+		gtk_widget_show(priv->balance);
+	}
+	else
+		gtk_widget_hide(priv->balance);
+	gtk_widget_set_sensitive(priv->balance, !mute);
+
 	// Ideally, this would be done by checking the sink input's flags for
 	// PA_STREAM_DONT_MOVE, but we don't have that information
 	is_pulseaudio = 0 == strcmp(application_id, "org.PulseAudio.PulseAudio");
 	gtk_widget_set_sensitive(priv->sink_button, !is_pulseaudio);
 
-	g_object_set(priv->sink_button_image,
-	             "gicon", pama_pulse_sink_build_gicon(sink),
-	             NULL);
+	icon = pama_pulse_sink_build_gicon(sink);
+	pama_icon_cache_set_image(GTK_IMAGE(priv->sink_button_image), icon, WIDGET_BUTTON_ICON_SIZE);
+	g_object_unref(icon);
 
 	g_object_unref(client);
 	g_object_unref(sink);
@@ -379,111 +739,45 @@ static void pama_sink_input_widget_mute_toggled   (GtkToggleButton *togglebutton
 	if (priv->updating)
 		return;
 
+	pama_meter_budget_touch(widget);
 	pama_pulse_sink_input_set_mute(priv->sink_input, gtk_toggle_button_get_active(togglebutton));
 }
 static void pama_sink_input_widget_volume_changed (GtkRange *range, PamaSinkInputWidget *widget)
 {
 	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(widget);
+	PamaPulseSink *sink;
+	guint32 new_volume;
+
 	if (priv->updating)
 		return;
 
-	pama_pulse_sink_input_set_volume(priv->sink_input, pa_sw_volume_from_dB(gtk_range_get_value(range) - WIDGET_VOLUME_SLIDER_DB_RANGE));
-}
-
-static gint _sink_menu_sort_function(gconstpointer a, gconstpointer b) 
-{
-	gint result = pama_pulse_sink_compare_by_hostname(a, b);
-	if (result)
-		return result;
-
-	return pama_pulse_sink_compare_by_description(a, b);
-}
-static void pama_sink_input_widget_sink_button_clicked(GtkButton *button, PamaSinkInputWidget *widget)
-{
-	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(widget);
-	GtkWidget *item, *last = NULL;
-	GtkWidget *label;
-	GSList *sinks, *iter;
-	PamaPulseSink *sink, *current_sink;
-	gchar *sink_name, *hostname;
-	gboolean network;
-	gchar *text;
+	new_volume = pama_volume_map_from_slider(gtk_range_get_value(range));
+	pama_meter_budget_touch(widget);
+	pama_pulse_sink_input_set_volume(priv->sink_input, new_volume);
 
-	if (!priv->sink_menu)
+	/* Played as loud as the stream now is */
+	g_object_get(priv->sink_input, "sink", &sink, NULL);
+	if (sink)
 	{
-		priv->sink_menu = gtk_menu_new();
-		g_object_ref_sink(priv->sink_menu);
-		g_signal_connect(gtk_widget_get_toplevel(priv->sink_menu), "hide", G_CALLBACK(pama_sink_input_widget_sink_menu_hidden), widget);
-
-		sinks = g_slist_copy(pama_pulse_context_get_sinks(priv->context));
-		sinks = g_slist_sort(sinks, _sink_menu_sort_function);
-
-		g_object_get(priv->sink_input, "sink", &current_sink, NULL);
-
-		for (iter = sinks; iter; iter = iter->next)
-		{
-			sink = PAMA_PULSE_SINK(iter->data);
-			g_object_get(sink, 
-			             "description", &sink_name, 
-			             "network",     &network,
-			             "hostname",    &hostname,
-			             NULL);
-
-			if (network)
-				text = g_markup_printf_escaped("<b>%s</b> (on %s)", sink_name, hostname);
-			else
-				text = g_markup_printf_escaped("<b>%s</b>", sink_name);
-
-			label = g_object_new(GTK_TYPE_LABEL,
-			                     "label", text,
-			                     "use-markup", TRUE,
-			                     "xalign", 0.0,
-			                     NULL);
-
-			if (last)
-				item = gtk_radio_menu_item_new_from_widget(GTK_RADIO_MENU_ITEM(last));
-			else
-				item = gtk_radio_menu_item_new(NULL);
-
-			gtk_container_add(GTK_CONTAINER(item), label);
-
-			g_object_set(item,
-			             "active", (current_sink == sink),
-			             "user-data", sink,
-			             NULL);
-			last = item;
-			g_free(sink_name);
-			g_free(hostname);
-			g_free(text);
-
-			g_signal_connect(item, "toggled", G_CALLBACK(pama_sink_input_widget_sink_menu_item_toggled), widget);
-			gtk_menu_shell_append(GTK_MENU_SHELL(priv->sink_menu), item);
-			gtk_widget_show_all(item);
-		}
-
-		g_slist_free(sinks);
-		g_object_unref(current_sink);
-
-		gtk_menu_popup(GTK_MENU(priv->sink_menu), NULL, NULL, NULL, NULL, 0, gtk_get_current_event_time());
+		pama_feedback_sound_play(priv->context, sink, new_volume);
+		g_object_unref(sink);
 	}
 }
-static void pama_sink_input_widget_sink_menu_hidden(GtkWidget *menu_window, PamaSinkInputWidget *widget)
+static void pama_sink_input_widget_balance_changed(GtkRange *range, PamaSinkInputWidget *widget)
 {
 	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(widget);
-	g_object_unref(priv->sink_menu);
-	priv->sink_menu = NULL;
+	if (priv->updating)
+		return;
+
+	pama_meter_budget_touch(widget);
+	pama_pulse_sink_input_set_balance(priv->sink_input, gtk_range_get_value(range));
 }
-static void pama_sink_input_widget_sink_menu_item_toggled(GtkCheckMenuItem *item, PamaSinkInputWidget *widget)
+
+static void pama_sink_input_widget_sink_button_clicked(GtkButton *button, PamaSinkInputWidget *widget)
 {
 	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(widget);
-	PamaPulseSink *sink;
-
-	if (!gtk_check_menu_item_get_active(item))
-		return;
-
-	g_object_get(item, "user-data", &sink, NULL);
 
-	pama_pulse_sink_input_set_sink(priv->sink_input, sink);
+	pama_device_menu_popup(PAMA_DEVICE_MENU(priv->sink_menu), G_OBJECT(priv->sink_input));
 }
 
 gint pama_sink_input_widget_compare(gconstpointer a, gconstpointer b)
@@ -514,3 +808,10 @@ gint pama_sink_input_widget_compare(gconstpointer a, gconstpointer b)
 	g_object_unref(Bc);
 	return result;
 }
+
+PamaPulseSinkInput *pama_sink_input_widget_get_sink_input(PamaSinkInputWidget *widget)
+{
+	PamaSinkInputWidgetPrivate *priv = PAMA_SINK_INPUT_WIDGET_GET_PRIVATE(widget);
+
+	return priv->sink_input;
+}
@@ -54,6 +54,7 @@ GType pama_sink_input_widget_get_type();
 
 /* methods */
 gint pama_sink_input_widget_compare(gconstpointer a, gconstpointer b);
+PamaPulseSinkInput *pama_sink_input_widget_get_sink_input(PamaSinkInputWidget *widget);
 
 G_END_DECLS
 
@@ -23,10 +23,19 @@
 #endif
 #include <glib.h>
 #include <glib/gi18n.h>
+#include <string.h>
  
 #include "pama-sink-popup.h"
 #include "pama-sink-widget.h"
 #include "pama-sink-input-widget.h"
+#include "pama-sink-input-group-widget.h"
+#include "pama-stream-model.h"
+#include "pama-stream-list.h"
+#include "pama-stream-row.h"
+#include "pama-stream-index.h"
+#include "pama-host-group.h"
+#include "pama-device-menu.h"
+#include "widget-settings.h"
 
 static void     pama_sink_popup_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec);
 static GObject* pama_sink_popup_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties);
@@ -44,11 +53,69 @@ static void     pama_sink_popup_reorder_sink_inputs(PamaSinkInputWidget *widget,
 static void     pama_sink_popup_add_sink      (PamaSinkPopup *popup, PamaPulseSink      *sink);
 static void     pama_sink_popup_add_sink_input(PamaSinkPopup *popup, PamaPulseSinkInput *sink_input);
 
+static gboolean pama_sink_popup_is_hidden(PamaSinkPopup *popup, GObject *sink_input);
+static gboolean pama_sink_popup_has_hidden_role(PamaSinkPopup *popup, GObject *sink_input);
+static void     pama_sink_popup_show_sink_input(PamaSinkPopup *popup, PamaPulseSinkInput *sink_input);
+static gboolean pama_sink_popup_pending_timeout(gpointer data);
+static void     pama_sink_popup_pending_free(gpointer data);
+static void     pama_sink_popup_pending_cancel(gpointer key, gpointer value, gpointer data);
+
+static void     pama_sink_popup_corked_changed(GObject *sink_input, GParamSpec *pspec, gpointer data);
+static void     pama_sink_popup_track_corked(PamaSinkPopup *popup, PamaPulseSinkInput *sink_input);
+static void     pama_sink_popup_update_idle_button(PamaSinkPopup *popup);
+static void     pama_sink_popup_toggle_idle(GtkButton *button, gpointer data);
+static void     pama_sink_popup_remove_sink_input(PamaSinkPopup *popup, PamaPulseSinkInput *sink_input);
+static void     pama_sink_popup_rebuild_streams(PamaSinkPopup *popup);
+
+static void       pama_sink_popup_update_stream_mode(PamaSinkPopup *popup);
+static GtkWidget* pama_sink_popup_create_stream_row(GObject *stream, gpointer data);
+static GtkWidget* pama_sink_popup_create_list_row(GObject *stream, gpointer data);
+
+static void       pama_sink_popup_add_to_group(PamaSinkPopup *popup, PamaPulseSinkInput *sink_input);
+static void       pama_sink_popup_group_destroyed(GtkWidget *group, gpointer data);
+
+static void       pama_sink_popup_filter_changed(GtkEditable *editable, gpointer data);
+static void       pama_sink_popup_apply_filter(PamaSinkPopup *popup);
+static gboolean   pama_sink_popup_filter_visible(GtkTreeModel *model, GtkTreeIter *iter, gpointer data);
+static void       pama_sink_popup_filter_box(PamaSinkPopup *popup, GtkBox *box);
+
+static GtkWidget* pama_sink_popup_create_sink_widget(GObject *sink, gpointer data);
+static GtkWidget* pama_sink_popup_create_remote_stream(GObject *stream, gpointer data);
+static void       pama_sink_popup_add_to_host_group(PamaSinkPopup *popup, GHashTable *hosts, GtkBox *box, const gchar *hostname, GObject *object, PamaHostGroupBuildFunc build_func, GCompareFunc compare_func);
+static void       pama_sink_popup_host_group_destroyed(GtkWidget *group, gpointer data);
+
 struct _PamaSinkPopupPrivate
 {
 	GtkBox *sink_box, *stream_box;
 	GtkSizeGroup *icon_sizegroup;
+	GtkWidget *sink_menu;
 	GtkWidget *no_apps, *no_devices;
+	GtkWidget *filter_entry;
+	PamaStreamIndex *stream_index;
+
+	/* Only used while there are too many streams for one widget each */
+	PamaStreamModel *stream_model;
+	GtkTreeModel *stream_filter;
+	GtkWidget *stream_list;
+
+	/* Host name -> PamaHostGroup, for the devices and the streams of remote hosts */
+	GHashTable *device_hosts, *stream_hosts;
+
+	/* Group key -> PamaSinkInputGroupWidget, when streams are grouped by application */
+	gboolean group_streams;
+	GHashTable *groups;
+
+	/* New streams only get a row once they have lived for new_stream_delay
+	 * milliseconds; until then they are in pending, index -> timeout id */
+	guint new_stream_delay;
+	gchar **hidden_roles;
+	GHashTable *pending;
+
+	/* With active_only set, corked streams get no row until show_idle is;
+	 * idle holds the indices of every corked stream, index -> TRUE */
+	gboolean active_only, show_idle;
+	GHashTable *idle;
+	GtkWidget *idle_button;
 
 	PamaPulseContext *context;
 	gulong sink_added_handler_id;
@@ -57,6 +124,12 @@ struct _PamaSinkPopupPrivate
 	gulong sink_input_removed_handler_id;
 };
 
+typedef struct
+{
+	PamaSinkPopup *popup;
+	guint          index;
+} PamaSinkPopupPending;
+
 G_DEFINE_TYPE(PamaSinkPopup, pama_sink_popup, PAMA_TYPE_POPUP);
 #define PAMA_SINK_POPUP_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE((obj), PAMA_TYPE_SINK_POPUP, PamaSinkPopupPrivate))
 
@@ -64,7 +137,11 @@ enum
 {
 	PROP_0,
 
-	PROP_CONTEXT
+	PROP_CONTEXT,
+	PROP_GROUP_STREAMS,
+	PROP_NEW_STREAM_DELAY,
+	PROP_HIDDEN_ROLES,
+	PROP_ACTIVE_ONLY
 };
 
 static void pama_sink_popup_class_init(PamaSinkPopupClass *klass)
@@ -83,6 +160,34 @@ static void pama_sink_popup_class_init(PamaSinkPopupClass *klass)
 	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
 	g_object_class_install_property(gobject_class, PROP_CONTEXT, pspec);
 
+	pspec = g_param_spec_boolean("group-streams",
+	                             "Group streams",
+	                             "Whether to show one row per application rather than one per stream.",
+	                             FALSE,
+	                             G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_GROUP_STREAMS, pspec);
+
+	pspec = g_param_spec_uint("new-stream-delay",
+	                          "New stream delay",
+	                          "How many milliseconds a new stream must exist for before it is shown.",
+	                          0, G_MAXUINT, 0,
+	                          G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_NEW_STREAM_DELAY, pspec);
+
+	pspec = g_param_spec_boxed("hidden-roles",
+	                           "Hidden roles",
+	                           "The media roles, such as \"event\", of the streams that are never shown.",
+	                           G_TYPE_STRV,
+	                           G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_HIDDEN_ROLES, pspec);
+
+	pspec = g_param_spec_boolean("active-only",
+	                             "Active streams only",
+	                             "Whether paused streams are left out, behind a count of them, until asked for.",
+	                             FALSE,
+	                             G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_ACTIVE_ONLY, pspec);
+
 	g_type_class_add_private(klass, sizeof(PamaSinkPopupPrivate));
 }
 
@@ -92,7 +197,7 @@ static void pama_sink_popup_init(PamaSinkPopup *popup)
 	gchar *markup;
 	GtkWidget *frame, *main_box;
 	GtkWidget *sink_frame,   *sink_align,   *sink_box;
-	GtkWidget *stream_frame, *stream_align, *stream_box;
+	GtkWidget *stream_frame, *stream_align, *stream_vbox, *stream_box, *filter_entry, *idle_button;
 	GtkWidget *no_devices, *no_apps;
 	GtkSizeGroup *icon_sizegroup;
 
@@ -147,8 +252,20 @@ static void pama_sink_popup_init(PamaSinkPopup *popup)
 	gtk_alignment_set_padding(GTK_ALIGNMENT(stream_align), 6, 0, 12, 0);
 	gtk_container_add(GTK_CONTAINER(stream_frame), stream_align);
 
+	stream_vbox = gtk_vbox_new(FALSE, 6);
+	gtk_container_add(GTK_CONTAINER(stream_align), stream_vbox);
+
+	filter_entry = g_object_new(GTK_TYPE_ENTRY,
+	                            "no-show-all", TRUE,
+	                            NULL);
+	gtk_widget_set_tooltip_text(filter_entry, _("Show only the applications matching this text"));
+	gtk_box_pack_start(GTK_BOX(stream_vbox), filter_entry, FALSE, FALSE, 0);
+	g_signal_connect(filter_entry, "changed", G_CALLBACK(pama_sink_popup_filter_changed), popup);
+	pama_popup_set_filter_entry(PAMA_POPUP(popup), GTK_ENTRY(filter_entry));
+	priv->filter_entry = filter_entry;
+
 	stream_box = gtk_vbox_new(FALSE, 6);
-	gtk_container_add(GTK_CONTAINER(stream_align), stream_box);
+	gtk_box_pack_start(GTK_BOX(stream_vbox), stream_box, FALSE, FALSE, 0);
 	priv->stream_box = GTK_BOX(stream_box);
 
 	markup = g_markup_printf_escaped("<i>%s</i>", _("No applications playing"));
@@ -165,9 +282,26 @@ static void pama_sink_popup_init(PamaSinkPopup *popup)
 	priv->no_apps = no_apps;
 	g_free(markup);
 
+	idle_button = g_object_new(GTK_TYPE_BUTTON,
+	                           "relief", GTK_RELIEF_NONE,
+	                           "focus-on-click", FALSE,
+	                           "no-show-all", TRUE,
+	                           NULL);
+	gtk_box_pack_start(GTK_BOX(stream_vbox), idle_button, FALSE, FALSE, 0);
+	g_signal_connect(idle_button, "clicked", G_CALLBACK(pama_sink_popup_toggle_idle), popup);
+	priv->idle_button = idle_button;
+
 
 	icon_sizegroup = gtk_size_group_new(GTK_SIZE_GROUP_BOTH);
 	priv->icon_sizegroup = icon_sizegroup;
+
+	priv->device_hosts = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	priv->stream_hosts = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+	priv->groups = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+	priv->pending = g_hash_table_new(g_direct_hash, g_direct_equal);
+	priv->idle    = g_hash_table_new(g_direct_hash, g_direct_equal);
 }
 
 static GObject* pama_sink_popup_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties)
@@ -187,12 +321,23 @@ static GObject* pama_sink_popup_constructor(GType gtype, guint n_properties, GOb
 		pama_sink_popup_add_sink(popup, sink);
 	}
 
+	/* One menu, kept up to date, serves every stream that is moved to another sink */
+	priv->sink_menu = pama_device_menu_new(priv->context, PAMA_TYPE_PULSE_SINK);
+	g_object_ref_sink(priv->sink_menu);
+
+	/* Created before connecting to the context, so the index is up to date by the time the popup hears of a change */
+	priv->stream_index = pama_stream_index_new(priv->context, PAMA_TYPE_PULSE_SINK_INPUT);
+	g_signal_connect_swapped(priv->stream_index, "changed", G_CALLBACK(pama_sink_popup_apply_filter), popup);
+
+	pama_sink_popup_update_stream_mode(popup);
 	for (iter = pama_pulse_context_get_sink_inputs(priv->context); iter; iter = iter->next)
 	{
 		PamaPulseSinkInput *sink_input = PAMA_PULSE_SINK_INPUT(iter->data);
 
+		pama_sink_popup_track_corked(popup, sink_input);
 		pama_sink_popup_add_sink_input(popup, sink_input);
 	}
+	pama_sink_popup_update_idle_button(popup);
 
 	pama_sink_popup_reorder_sinks(NULL, popup);
 	priv->sink_added_handler_id         = g_signal_connect(priv->context, "sink-added",       G_CALLBACK(pama_sink_popup_sink_added),       popup);
@@ -208,9 +353,13 @@ static void pama_sink_popup_dispose(GObject *gobject)
 {
 	PamaSinkPopup *popup = PAMA_SINK_POPUP(gobject);
 	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+	GSList *iter;
 
 	if (priv->context)
 	{
+		for (iter = pama_pulse_context_get_sink_inputs(priv->context); iter; iter = iter->next)
+			g_signal_handlers_disconnect_by_func(iter->data, pama_sink_popup_corked_changed, popup);
+
 		if (priv->sink_added_handler_id)
 		{
 			g_signal_handler_disconnect(priv->context, priv->sink_added_handler_id);
@@ -239,6 +388,69 @@ static void pama_sink_popup_dispose(GObject *gobject)
 		priv->context = NULL;
 	}
 
+	if (priv->stream_filter)
+	{
+		g_object_unref(priv->stream_filter);
+		priv->stream_filter = NULL;
+	}
+
+	if (priv->stream_model)
+	{
+		g_object_unref(priv->stream_model);
+		priv->stream_model = NULL;
+	}
+
+	if (priv->groups)
+	{
+		g_hash_table_destroy(priv->groups);
+		priv->groups = NULL;
+	}
+
+	if (priv->pending)
+	{
+		g_hash_table_foreach(priv->pending, pama_sink_popup_pending_cancel, NULL);
+		g_hash_table_destroy(priv->pending);
+		priv->pending = NULL;
+	}
+
+	if (priv->idle)
+	{
+		g_hash_table_destroy(priv->idle);
+		priv->idle = NULL;
+	}
+
+	if (priv->hidden_roles)
+	{
+		g_strfreev(priv->hidden_roles);
+		priv->hidden_roles = NULL;
+	}
+
+	if (priv->sink_menu)
+	{
+		gtk_widget_destroy(priv->sink_menu);
+		g_object_unref(priv->sink_menu);
+		priv->sink_menu = NULL;
+	}
+
+	if (priv->device_hosts)
+	{
+		g_hash_table_destroy(priv->device_hosts);
+		priv->device_hosts = NULL;
+	}
+
+	if (priv->stream_hosts)
+	{
+		g_hash_table_destroy(priv->stream_hosts);
+		priv->stream_hosts = NULL;
+	}
+
+	if (priv->stream_index)
+	{
+		g_signal_handlers_disconnect_by_func(priv->stream_index, pama_sink_popup_apply_filter, popup);
+		g_object_unref(priv->stream_index);
+		priv->stream_index = NULL;
+	}
+
 	G_OBJECT_CLASS(pama_sink_popup_parent_class)->dispose(gobject);
 }
 static void pama_sink_popup_weak_ref_notify(gpointer data, GObject *where_the_object_was)
@@ -266,6 +478,22 @@ static void pama_sink_popup_set_property(GObject *gobject, guint property_id, co
 			g_object_weak_ref(G_OBJECT(priv->context), pama_sink_popup_weak_ref_notify, popup);
 			break;
 
+		case PROP_GROUP_STREAMS:
+			priv->group_streams = g_value_get_boolean(value);
+			break;
+
+		case PROP_NEW_STREAM_DELAY:
+			priv->new_stream_delay = g_value_get_uint(value);
+			break;
+
+		case PROP_HIDDEN_ROLES:
+			priv->hidden_roles = g_value_dup_boxed(value);
+			break;
+
+		case PROP_ACTIVE_ONLY:
+			priv->active_only = g_value_get_boolean(value);
+			break;
+
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
 			break;
@@ -275,22 +503,55 @@ static void pama_sink_popup_set_property(GObject *gobject, guint property_id, co
 static void  pama_sink_popup_add_sink(PamaSinkPopup *popup, PamaPulseSink *sink)
 {
 	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
-	GtkWidget *group = NULL;
 	GtkWidget *sink_widget;
-	GList *iter;
-	GList *box_children = gtk_container_get_children(GTK_CONTAINER(priv->sink_box));
+	gchar *hostname;
+	gboolean network;
 
 	gtk_widget_hide(priv->no_devices);
+
+	/* The devices of a remote host get widgets once its group is first expanded */
+	g_object_get(sink,
+	             "network", &network,
+	             "hostname", &hostname,
+	             NULL);
+	if (network && hostname && *hostname)
+	{
+		pama_sink_popup_add_to_host_group(popup, priv->device_hosts, priv->sink_box, hostname, G_OBJECT(sink),
+		                                  pama_sink_popup_create_sink_widget, pama_sink_widget_compare);
+		g_free(hostname);
+		return;
+	}
+	g_free(hostname);
+
+	sink_widget = pama_sink_popup_create_sink_widget(G_OBJECT(sink), popup);
+	g_signal_connect(sink_widget, "reorder-request", G_CALLBACK(pama_sink_popup_reorder_sinks), popup);
 	
-	/* If there is already a source widget, group with it */
-	for (iter = box_children; iter; iter = iter->next)
+	gtk_box_pack_start(GTK_BOX(priv->sink_box), sink_widget, FALSE, FALSE, 0);
+	pama_sink_popup_reorder_sinks(NULL, popup);
+}
+static GtkWidget* pama_sink_popup_create_sink_widget(GObject *sink, gpointer data)
+{
+	PamaSinkPopup *popup = PAMA_SINK_POPUP(data);
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+	GtkWidget *group = NULL;
+	GtkWidget *sink_widget;
+	GList *box_children, *group_children, *iter;
+
+	/* If there is already a sink widget, possibly in the group of a remote host, group with it */
+	box_children = gtk_container_get_children(GTK_CONTAINER(priv->sink_box));
+	for (iter = box_children; iter && !group; iter = iter->next)
 	{
 		if (PAMA_IS_SINK_WIDGET(iter->data))
-		{
 			group = GTK_WIDGET(iter->data);
-			break;
+		else if (PAMA_IS_HOST_GROUP(iter->data))
+		{
+			group_children = gtk_container_get_children(GTK_CONTAINER(pama_host_group_get_box(PAMA_HOST_GROUP(iter->data))));
+			if (group_children)
+				group = GTK_WIDGET(group_children->data);
+			g_list_free(group_children);
 		}
 	}
+	g_list_free(box_children);
 
 	sink_widget = 
 		g_object_new(PAMA_TYPE_SINK_WIDGET,
@@ -299,25 +560,58 @@ static void  pama_sink_popup_add_sink(PamaSinkPopup *popup, PamaPulseSink *sink)
 		             "group", group,
 		             "icon-sizegroup", priv->icon_sizegroup,
 		             NULL);
-
-	g_signal_connect(sink_widget, "reorder-request", G_CALLBACK(pama_sink_popup_reorder_sinks), popup);
-	
-	gtk_box_pack_start(GTK_BOX(priv->sink_box), sink_widget, FALSE, FALSE, 0);
-	pama_sink_popup_reorder_sinks(NULL, popup);
 	gtk_widget_show_all(sink_widget);
+
+	return sink_widget;
 }
 static void pama_sink_popup_add_sink_input(PamaSinkPopup *popup, PamaPulseSinkInput *sink_input)
 {
 	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
 	GtkWidget *sink_input_widget;
+	PamaPulseClient *client;
+	gchar *hostname = NULL;
+	gboolean is_local = TRUE;
+
+	if (pama_sink_popup_is_hidden(popup, G_OBJECT(sink_input)))
+		return;
 	
 	gtk_widget_hide(priv->no_apps);
+
+	/* The list creates the widgets of its visible rows itself */
+	if (priv->stream_list)
+		return;
+
+	if (priv->group_streams)
+	{
+		pama_sink_popup_add_to_group(popup, sink_input);
+		return;
+	}
+
+	/* The streams of remote clients get widgets once their host's group is first expanded */
+	g_object_get(sink_input, "client", &client, NULL);
+	if (client)
+	{
+		g_object_get(client,
+		             "is-local", &is_local,
+		             "hostname", &hostname,
+		             NULL);
+		g_object_unref(client);
+	}
+	if (!is_local && hostname && *hostname)
+	{
+		pama_sink_popup_add_to_host_group(popup, priv->stream_hosts, priv->stream_box, hostname, G_OBJECT(sink_input),
+		                                  pama_sink_popup_create_remote_stream, pama_sink_input_widget_compare);
+		g_free(hostname);
+		return;
+	}
+	g_free(hostname);
 	
 	sink_input_widget = 
 		g_object_new(PAMA_TYPE_SINK_INPUT_WIDGET,
 		             "context", priv->context, 
 		             "sink-input", sink_input,
 		             "icon-sizegroup", priv->icon_sizegroup,
+		             "sink-menu", priv->sink_menu,
 		             NULL);
 
 	g_signal_connect(sink_input_widget, "reorder-request", G_CALLBACK(pama_sink_popup_reorder_sink_inputs), popup);
@@ -325,6 +619,80 @@ static void pama_sink_popup_add_sink_input(PamaSinkPopup *popup, PamaPulseSinkIn
 	gtk_box_pack_start(GTK_BOX(priv->stream_box), sink_input_widget, FALSE, FALSE, 0);
 	pama_sink_popup_reorder_sink_inputs(NULL, popup);
 	gtk_widget_show_all(sink_input_widget);
+
+	if (!pama_stream_index_matches(priv->stream_index, G_OBJECT(sink_input)))
+		gtk_widget_hide(sink_input_widget);
+}
+
+static void pama_sink_popup_add_to_group(PamaSinkPopup *popup, PamaPulseSinkInput *sink_input)
+{
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+	gchar *key = pama_sink_input_group_widget_build_key(sink_input);
+	GtkWidget *group = g_hash_table_lookup(priv->groups, key);
+
+	if (!group)
+	{
+		group = g_object_new(PAMA_TYPE_SINK_INPUT_GROUP_WIDGET,
+		                     "context", priv->context,
+		                     "key", key,
+		                     "icon-sizegroup", priv->icon_sizegroup,
+		                     "sink-menu", priv->sink_menu,
+		                     NULL);
+		g_hash_table_insert(priv->groups, g_strdup(key), group);
+		g_signal_connect(group, "destroy", G_CALLBACK(pama_sink_popup_group_destroyed), popup);
+
+		gtk_box_pack_start(GTK_BOX(priv->stream_box), group, FALSE, FALSE, 0);
+		gtk_widget_show_all(group);
+	}
+
+	pama_sink_input_group_widget_add_sink_input(PAMA_SINK_INPUT_GROUP_WIDGET(group), sink_input);
+	pama_sink_popup_reorder_sink_inputs(NULL, popup);
+	pama_sink_popup_apply_filter(popup);
+	g_free(key);
+}
+static void pama_sink_popup_group_destroyed(GtkWidget *group, gpointer data)
+{
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(data);
+
+	if (priv->groups)
+		g_hash_table_remove(priv->groups, pama_sink_input_group_widget_get_key(PAMA_SINK_INPUT_GROUP_WIDGET(group)));
+}
+
+static void pama_sink_popup_add_to_host_group(PamaSinkPopup *popup, GHashTable *hosts, GtkBox *box, const gchar *hostname, GObject *object, PamaHostGroupBuildFunc build_func, GCompareFunc compare_func)
+{
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+	GtkWidget *group = g_hash_table_lookup(hosts, hostname);
+
+	if (!group)
+	{
+		group = pama_host_group_new(hostname, build_func, compare_func, popup);
+		g_hash_table_insert(hosts, g_strdup(hostname), group);
+		g_signal_connect(group, "destroy", G_CALLBACK(pama_sink_popup_host_group_destroyed), popup);
+
+		gtk_box_pack_start(box, group, FALSE, FALSE, 0);
+		gtk_widget_show_all(group);
+	}
+
+	pama_host_group_add(PAMA_HOST_GROUP(group), object);
+
+	if (box == priv->sink_box)
+		pama_sink_popup_reorder_sinks(NULL, popup);
+	else
+	{
+		pama_sink_popup_reorder_sink_inputs(NULL, popup);
+		pama_sink_popup_apply_filter(popup);
+	}
+}
+static void pama_sink_popup_host_group_destroyed(GtkWidget *group, gpointer data)
+{
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(data);
+	const gchar *hostname = pama_host_group_get_hostname(PAMA_HOST_GROUP(group));
+
+	/* A host may have one group among the devices and another among the streams */
+	if (priv->device_hosts && g_hash_table_lookup(priv->device_hosts, hostname) == group)
+		g_hash_table_remove(priv->device_hosts, hostname);
+	if (priv->stream_hosts && g_hash_table_lookup(priv->stream_hosts, hostname) == group)
+		g_hash_table_remove(priv->stream_hosts, hostname);
 }
 
 static void pama_sink_popup_sink_added(PamaPulseContext *context, guint index, gpointer data)
@@ -345,30 +713,422 @@ static void pama_sink_popup_sink_removed(PamaPulseContext *context, guint index,
 }
 static void pama_sink_popup_sink_input_added(PamaPulseContext *context, guint index, gpointer data)
 {
-	PamaSinkPopup      *popup       = PAMA_SINK_POPUP(data);
-	PamaPulseSinkInput *sink_input = pama_pulse_context_get_sink_input_by_index(context, index);
+	PamaSinkPopup        *popup      = PAMA_SINK_POPUP(data);
+	PamaSinkPopupPrivate *priv       = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+	PamaPulseSinkInput   *sink_input = pama_pulse_context_get_sink_input_by_index(context, index);
+	PamaSinkPopupPending *pending;
+	guint                 timeout_id;
 
-	pama_sink_popup_add_sink_input(popup, sink_input);
-	pama_sink_popup_reorder_sink_inputs(NULL, popup);
+	pama_sink_popup_track_corked(popup, sink_input);
+	pama_sink_popup_update_idle_button(popup);
+
+	if (pama_sink_popup_is_hidden(popup, G_OBJECT(sink_input)))
+		return;
+
+	/* Event sounds and the like come and go within a fraction of a second;
+	 * wait a little so that they never touch the widgets at all */
+	if (priv->new_stream_delay)
+	{
+		pending = g_slice_new(PamaSinkPopupPending);
+		pending->popup = popup;
+		pending->index = index;
+
+		timeout_id = g_timeout_add_full(G_PRIORITY_DEFAULT, priv->new_stream_delay,
+		                                pama_sink_popup_pending_timeout, pending, pama_sink_popup_pending_free);
+		g_hash_table_insert(priv->pending, GUINT_TO_POINTER(index), GUINT_TO_POINTER(timeout_id));
+
+		/* The list's model may have heard of the stream first, and let its row through */
+		if (priv->stream_filter)
+			gtk_tree_model_filter_refilter(GTK_TREE_MODEL_FILTER(priv->stream_filter));
+		return;
+	}
+
+	pama_sink_popup_show_sink_input(popup, sink_input);
 }
 static void pama_sink_popup_sink_input_removed(PamaPulseContext *context, guint index, gpointer data)
 {
 	PamaSinkPopup        *popup = PAMA_SINK_POPUP(data);
 	PamaSinkPopupPrivate *priv  = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+	gpointer              timeout_id;
+
+	if (g_hash_table_remove(priv->idle, GUINT_TO_POINTER(index)))
+		pama_sink_popup_update_idle_button(popup);
+
+	if (g_hash_table_lookup_extended(priv->pending, GUINT_TO_POINTER(index), NULL, &timeout_id))
+	{
+		g_source_remove(GPOINTER_TO_UINT(timeout_id));
+		g_hash_table_remove(priv->pending, GUINT_TO_POINTER(index));
+		return;
+	}
 
 	if (! pama_pulse_context_get_sink_inputs(context))
 		gtk_widget_show(priv->no_apps);
+
+	pama_sink_popup_update_stream_mode(popup);
+}
+
+static gboolean pama_sink_popup_is_hidden(PamaSinkPopup *popup, GObject *sink_input)
+{
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+	guint index;
+	gboolean corked;
+
+	g_object_get(sink_input,
+	             "index",  &index,
+	             "corked", &corked,
+	             NULL);
+
+	if (g_hash_table_lookup(priv->pending, GUINT_TO_POINTER(index)))
+		return TRUE;
+
+	if (priv->active_only && !priv->show_idle && corked)
+		return TRUE;
+
+	return pama_sink_popup_has_hidden_role(popup, sink_input);
+}
+static gboolean pama_sink_popup_has_hidden_role(PamaSinkPopup *popup, GObject *sink_input)
+{
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+	gchar *role;
+	gchar **iter;
+	gboolean hidden = FALSE;
+
+	g_object_get(sink_input, "role", &role, NULL);
+
+	for (iter = priv->hidden_roles; iter && *iter && !hidden; iter++)
+		hidden = role && 0 == strcmp(role, *iter);
+	g_free(role);
+
+	return hidden;
+}
+static void pama_sink_popup_show_sink_input(PamaSinkPopup *popup, PamaPulseSinkInput *sink_input)
+{
+	pama_sink_popup_update_stream_mode(popup);
+	pama_sink_popup_add_sink_input(popup, sink_input);
+	pama_sink_popup_reorder_sink_inputs(NULL, popup);
+}
+static gboolean pama_sink_popup_pending_timeout(gpointer data)
+{
+	PamaSinkPopupPending *pending = data;
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(pending->popup);
+	PamaPulseSinkInput *sink_input;
+
+	g_hash_table_remove(priv->pending, GUINT_TO_POINTER(pending->index));
+
+	sink_input = pama_pulse_context_get_sink_input_by_index(priv->context, pending->index);
+	if (sink_input)
+	{
+		pama_sink_popup_show_sink_input(pending->popup, sink_input);
+
+		/* The list's model already had it, hidden while it was pending */
+		if (priv->stream_filter)
+			gtk_tree_model_filter_refilter(GTK_TREE_MODEL_FILTER(priv->stream_filter));
+	}
+
+	return FALSE;
+}
+static void pama_sink_popup_pending_free(gpointer data)
+{
+	g_slice_free(PamaSinkPopupPending, data);
+}
+static void pama_sink_popup_pending_cancel(gpointer key, gpointer value, gpointer data)
+{
+	g_source_remove(GPOINTER_TO_UINT(value));
+}
+
+static void pama_sink_popup_track_corked(PamaSinkPopup *popup, PamaPulseSinkInput *sink_input)
+{
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+	gboolean corked;
+	guint index;
+
+	/* Streams that are never shown are not counted among the paused ones either */
+	if (pama_sink_popup_has_hidden_role(popup, G_OBJECT(sink_input)))
+		return;
+
+	g_object_get(sink_input,
+	             "index",  &index,
+	             "corked", &corked,
+	             NULL);
+	if (corked)
+		g_hash_table_insert(priv->idle, GUINT_TO_POINTER(index), GUINT_TO_POINTER(TRUE));
+
+	g_signal_connect(sink_input, "notify::corked", G_CALLBACK(pama_sink_popup_corked_changed), popup);
+}
+static void pama_sink_popup_corked_changed(GObject *sink_input, GParamSpec *pspec, gpointer data)
+{
+	PamaSinkPopup *popup = PAMA_SINK_POPUP(data);
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+	gboolean corked;
+	guint index;
+
+	g_object_get(sink_input,
+	             "index",  &index,
+	             "corked", &corked,
+	             NULL);
+
+	/* Every update notifies, whether or not the flag actually changed */
+	if (corked == (NULL != g_hash_table_lookup(priv->idle, GUINT_TO_POINTER(index))))
+		return;
+
+	if (corked)
+		g_hash_table_insert(priv->idle, GUINT_TO_POINTER(index), GUINT_TO_POINTER(TRUE));
+	else
+		g_hash_table_remove(priv->idle, GUINT_TO_POINTER(index));
+	pama_sink_popup_update_idle_button(popup);
+
+	/* A pending stream is looked at again when its delay runs out */
+	if (!priv->active_only || priv->show_idle || g_hash_table_lookup(priv->pending, GUINT_TO_POINTER(index)))
+		return;
+
+	if (priv->stream_filter)
+		gtk_tree_model_filter_refilter(GTK_TREE_MODEL_FILTER(priv->stream_filter));
+	else if (corked)
+		pama_sink_popup_remove_sink_input(popup, PAMA_PULSE_SINK_INPUT(sink_input));
+	else
+		pama_sink_popup_show_sink_input(popup, PAMA_PULSE_SINK_INPUT(sink_input));
+}
+static void pama_sink_popup_update_idle_button(PamaSinkPopup *popup)
+{
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+	guint n_idle = g_hash_table_size(priv->idle);
+	gchar *label;
+
+	if (!priv->active_only || (!n_idle && !priv->show_idle))
+	{
+		gtk_widget_hide(priv->idle_button);
+		return;
+	}
+
+	if (priv->show_idle)
+		label = g_strdup(_("Hide paused applications"));
+	else
+		label = g_strdup_printf(ngettext("%u paused application", "%u paused applications", n_idle), n_idle);
+	gtk_button_set_label(GTK_BUTTON(priv->idle_button), label);
+	gtk_widget_show(priv->idle_button);
+	g_free(label);
+}
+static void pama_sink_popup_toggle_idle(GtkButton *button, gpointer data)
+{
+	PamaSinkPopup *popup = PAMA_SINK_POPUP(data);
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+
+	/* The rows of paused streams are only built while they are asked for */
+	priv->show_idle = !priv->show_idle;
+	pama_sink_popup_update_idle_button(popup);
+
+	if (priv->stream_filter)
+		gtk_tree_model_filter_refilter(GTK_TREE_MODEL_FILTER(priv->stream_filter));
+	else
+		pama_sink_popup_rebuild_streams(popup);
+}
+static void pama_sink_popup_remove_sink_input(PamaSinkPopup *popup, PamaPulseSinkInput *sink_input)
+{
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+	GList *children, *iter;
+	gboolean found = FALSE;
+
+	/* Only the stream's own row goes; a group or host group only goes with its last member */
+	children = gtk_container_get_children(GTK_CONTAINER(priv->stream_box));
+	for (iter = children; iter && !found; iter = iter->next)
+	{
+		if (PAMA_IS_SINK_INPUT_WIDGET(iter->data))
+		{
+			if (pama_sink_input_widget_get_sink_input(PAMA_SINK_INPUT_WIDGET(iter->data)) == sink_input)
+			{
+				gtk_widget_destroy(GTK_WIDGET(iter->data));
+				found = TRUE;
+			}
+		}
+		else if (PAMA_IS_SINK_INPUT_GROUP_WIDGET(iter->data))
+			found = pama_sink_input_group_widget_remove_sink_input(PAMA_SINK_INPUT_GROUP_WIDGET(iter->data), sink_input);
+		else if (PAMA_IS_HOST_GROUP(iter->data))
+			found = pama_host_group_remove(PAMA_HOST_GROUP(iter->data), G_OBJECT(sink_input));
+	}
+	g_list_free(children);
+}
+static void pama_sink_popup_rebuild_streams(PamaSinkPopup *popup)
+{
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+	GList *children, *iter;
+	GSList *siter;
+
+	children = gtk_container_get_children(GTK_CONTAINER(priv->stream_box));
+	for (iter = children; iter; iter = iter->next)
+	{
+		if (PAMA_IS_SINK_INPUT_WIDGET(iter->data) || PAMA_IS_SINK_INPUT_GROUP_WIDGET(iter->data) || PAMA_IS_HOST_GROUP(iter->data))
+			gtk_widget_destroy(GTK_WIDGET(iter->data));
+	}
+	g_list_free(children);
+
+	gtk_widget_show(priv->no_apps);
+	for (siter = pama_pulse_context_get_sink_inputs(priv->context); siter; siter = siter->next)
+		pama_sink_popup_add_sink_input(popup, PAMA_PULSE_SINK_INPUT(siter->data));
+
+	pama_sink_popup_reorder_sink_inputs(NULL, popup);
+	pama_sink_popup_apply_filter(popup);
+}
+
+static GtkWidget* pama_sink_popup_create_stream_row(GObject *stream, gpointer data)
+{
+	PamaSinkPopup *popup = PAMA_SINK_POPUP(data);
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+
+	return g_object_new(PAMA_TYPE_SINK_INPUT_WIDGET,
+	                    "context", priv->context,
+	                    "sink-input", stream,
+	                    "icon-sizegroup", priv->icon_sizegroup,
+	                    "sink-menu", priv->sink_menu,
+	                    NULL);
+}
+static GtkWidget* pama_sink_popup_create_list_row(GObject *stream, gpointer data)
+{
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(data);
+
+	/* The stream list can hold hundreds of rows, so it uses the lightweight ones */
+	return pama_stream_row_new(priv->context, stream, priv->sink_menu);
+}
+static GtkWidget* pama_sink_popup_create_remote_stream(GObject *stream, gpointer data)
+{
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(data);
+	GtkWidget *widget = pama_sink_popup_create_stream_row(stream, data);
+
+	gtk_widget_show_all(widget);
+	if (!pama_stream_index_matches(priv->stream_index, stream))
+		gtk_widget_hide(widget);
+
+	return widget;
+}
+static void pama_sink_popup_update_stream_mode(PamaSinkPopup *popup)
+{
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+	GSList *sink_inputs = pama_pulse_context_get_sink_inputs(priv->context);
+	guint n_sink_inputs = g_slist_length(sink_inputs);
+	GList *children, *iter;
+	GSList *siter;
+
+	if (!priv->stream_list && n_sink_inputs > WIDGET_STREAM_LIST_THRESHOLD)
+	{
+		children = gtk_container_get_children(GTK_CONTAINER(priv->stream_box));
+		for (iter = children; iter; iter = iter->next)
+		{
+			if (PAMA_IS_SINK_INPUT_WIDGET(iter->data) || PAMA_IS_SINK_INPUT_GROUP_WIDGET(iter->data) || PAMA_IS_HOST_GROUP(iter->data))
+				gtk_widget_destroy(GTK_WIDGET(iter->data));
+		}
+		g_list_free(children);
+
+		priv->stream_model  = pama_stream_model_new(priv->context, PAMA_TYPE_PULSE_SINK_INPUT);
+		priv->stream_filter = gtk_tree_model_filter_new(GTK_TREE_MODEL(priv->stream_model), NULL);
+		gtk_tree_model_filter_set_visible_func(GTK_TREE_MODEL_FILTER(priv->stream_filter), pama_sink_popup_filter_visible, popup, NULL);
+		priv->stream_list   = pama_stream_list_new(priv->stream_filter, pama_sink_popup_create_list_row, popup);
+		g_signal_connect(priv->stream_list, "destroy", G_CALLBACK(gtk_widget_destroyed), &priv->stream_list);
+
+		gtk_box_pack_start(GTK_BOX(priv->stream_box), priv->stream_list, FALSE, FALSE, 0);
+		gtk_widget_show_all(priv->stream_list);
+	}
+	else if (priv->stream_list && n_sink_inputs <= WIDGET_STREAM_LIST_THRESHOLD / 2)
+	{
+		gtk_widget_destroy(priv->stream_list);
+		g_object_unref(priv->stream_filter);
+		priv->stream_filter = NULL;
+		g_object_unref(priv->stream_model);
+		priv->stream_model = NULL;
+
+		for (siter = sink_inputs; siter; siter = siter->next)
+			pama_sink_popup_add_sink_input(popup, PAMA_PULSE_SINK_INPUT(siter->data));
+	}
+}
+
+static void pama_sink_popup_filter_changed(GtkEditable *editable, gpointer data)
+{
+	PamaSinkPopup *popup = PAMA_SINK_POPUP(data);
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+
+	/* Emits "changed" on the index, which applies the filter */
+	pama_stream_index_set_query(priv->stream_index, gtk_entry_get_text(GTK_ENTRY(editable)));
+}
+static void pama_sink_popup_apply_filter(PamaSinkPopup *popup)
+{
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+
+	if (priv->stream_filter)
+	{
+		gtk_tree_model_filter_refilter(GTK_TREE_MODEL_FILTER(priv->stream_filter));
+		return;
+	}
+
+	pama_sink_popup_filter_box(popup, priv->stream_box);
+}
+static void pama_sink_popup_filter_box(PamaSinkPopup *popup, GtkBox *box)
+{
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(popup);
+	GList *children, *iter;
+
+	children = gtk_container_get_children(GTK_CONTAINER(box));
+	for (iter = children; iter; iter = iter->next)
+	{
+		GObject *sink_input;
+		gboolean visible = FALSE;
+		GSList *members;
+
+		if (PAMA_IS_SINK_INPUT_GROUP_WIDGET(iter->data))
+		{
+			/* A group stays visible while any of its streams match */
+			members = pama_sink_input_group_widget_get_sink_inputs(PAMA_SINK_INPUT_GROUP_WIDGET(iter->data));
+			for (; members && !visible; members = members->next)
+				visible = pama_stream_index_matches(priv->stream_index, G_OBJECT(members->data));
+		}
+		else if (PAMA_IS_HOST_GROUP(iter->data))
+		{
+			/* A host stays visible while any of its streams match, whether or not their widgets exist yet */
+			members = pama_host_group_get_members(PAMA_HOST_GROUP(iter->data));
+			for (; members && !visible; members = members->next)
+				visible = pama_stream_index_matches(priv->stream_index, G_OBJECT(members->data));
+
+			pama_sink_popup_filter_box(popup, pama_host_group_get_box(PAMA_HOST_GROUP(iter->data)));
+		}
+		else if (PAMA_IS_SINK_INPUT_WIDGET(iter->data))
+		{
+			sink_input = G_OBJECT(pama_sink_input_widget_get_sink_input(PAMA_SINK_INPUT_WIDGET(iter->data)));
+			visible = pama_stream_index_matches(priv->stream_index, sink_input);
+		}
+		else
+			continue;
+
+		if (visible)
+			gtk_widget_show(GTK_WIDGET(iter->data));
+		else
+			gtk_widget_hide(GTK_WIDGET(iter->data));
+	}
+	g_list_free(children);
+}
+static gboolean pama_sink_popup_filter_visible(GtkTreeModel *model, GtkTreeIter *iter, gpointer data)
+{
+	PamaSinkPopupPrivate *priv = PAMA_SINK_POPUP_GET_PRIVATE(data);
+	GObject *stream = pama_stream_model_get_stream(model, iter);
+
+	return stream && !pama_sink_popup_is_hidden(PAMA_SINK_POPUP(data), stream) && pama_stream_index_matches(priv->stream_index, stream);
 }
 
 static gint pama_sink_popup_reorder_sinks__compare_sinks(gconstpointer a, gconstpointer b)
 {
 	const GtkBoxChild *A = a, *B = b;
 
-	if (!PAMA_IS_SINK_WIDGET(A->widget))
+	if (!PAMA_IS_SINK_WIDGET(A->widget) && !PAMA_IS_HOST_GROUP(A->widget))
 		return -1;
-	if (!PAMA_IS_SINK_WIDGET(B->widget))
+	if (!PAMA_IS_SINK_WIDGET(B->widget) && !PAMA_IS_HOST_GROUP(B->widget))
 		return +1;
 
+	/* Remote hosts follow the local rows */
+	if (PAMA_IS_HOST_GROUP(A->widget) || PAMA_IS_HOST_GROUP(B->widget))
+	{
+		if (!PAMA_IS_HOST_GROUP(A->widget))
+			return -1;
+		if (!PAMA_IS_HOST_GROUP(B->widget))
+			return +1;
+		return pama_host_group_compare(A->widget, B->widget);
+	}
+
 	return pama_sink_widget_compare(PAMA_SINK_WIDGET(A->widget), PAMA_SINK_WIDGET(B->widget));
 }
 static void pama_sink_popup_reorder_sinks(PamaSinkWidget *widget, gpointer data)
@@ -393,11 +1153,25 @@ static gint pama_sink_popup_reorder_sink_inputs__compare_sink_inputs(gconstpoint
 {
 	const GtkBoxChild *A = a, *B = b;
 
-	if (!PAMA_IS_SINK_INPUT_WIDGET(A->widget))
+	if (!PAMA_IS_SINK_INPUT_WIDGET(A->widget) && !PAMA_IS_SINK_INPUT_GROUP_WIDGET(A->widget) && !PAMA_IS_HOST_GROUP(A->widget))
 		return -1;
-	if (!PAMA_IS_SINK_INPUT_WIDGET(B->widget))
+	if (!PAMA_IS_SINK_INPUT_WIDGET(B->widget) && !PAMA_IS_SINK_INPUT_GROUP_WIDGET(B->widget) && !PAMA_IS_HOST_GROUP(B->widget))
 		return +1;
 
+	/* Remote hosts follow the local rows */
+	if (PAMA_IS_HOST_GROUP(A->widget) || PAMA_IS_HOST_GROUP(B->widget))
+	{
+		if (!PAMA_IS_HOST_GROUP(A->widget))
+			return -1;
+		if (!PAMA_IS_HOST_GROUP(B->widget))
+			return +1;
+		return pama_host_group_compare(A->widget, B->widget);
+	}
+
+	/* Only one kind of row is shown at a time */
+	if (PAMA_IS_SINK_INPUT_GROUP_WIDGET(A->widget))
+		return pama_sink_input_group_widget_compare(PAMA_SINK_INPUT_GROUP_WIDGET(A->widget), PAMA_SINK_INPUT_GROUP_WIDGET(B->widget));
+
 	return pama_sink_input_widget_compare(PAMA_SINK_INPUT_WIDGET(A->widget), PAMA_SINK_INPUT_WIDGET(B->widget));
 }
 static void pama_sink_popup_reorder_sink_inputs(PamaSinkInputWidget *widget, gpointer data)
@@ -419,7 +1193,7 @@ static void pama_sink_popup_reorder_sink_inputs(PamaSinkInputWidget *widget, gpo
 	g_list_free(children);
 }
 
-PamaSinkPopup* pama_sink_popup_new(PamaPulseContext *context)
+PamaSinkPopup* pama_sink_popup_new(PamaPulseContext *context, gboolean group_streams, gboolean active_only, guint new_stream_delay, gchar **hidden_roles)
 {
 	return g_object_new(PAMA_TYPE_SINK_POPUP,
 	                    "type", GTK_WINDOW_TOPLEVEL,
@@ -431,5 +1205,9 @@ PamaSinkPopup* pama_sink_popup_new(PamaPulseContext *context)
 	                    "title", "Playback Volume Widget",
 	                    "icon-name", "multimedia-volume-widget",
 	                    "context", context,
+	                    "group-streams", group_streams,
+	                    "active-only", active_only,
+	                    "new-stream-delay", new_stream_delay,
+	                    "hidden-roles", hidden_roles,
 	                    NULL);
 }
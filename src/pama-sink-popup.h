@@ -53,7 +53,7 @@ GType pama_sink_popup_get_type();
 
 
 /* methods */
-PamaSinkPopup *pama_sink_popup_new(PamaPulseContext *context);
+PamaSinkPopup *pama_sink_popup_new(PamaPulseContext *context, gboolean group_streams, gboolean active_only, guint new_stream_delay, gchar **hidden_roles);
 
 G_END_DECLS
 
@@ -25,6 +25,8 @@
 #include <glib/gi18n.h>
  
 #include "pama-source-output-widget.h"
+#include "pama-device-menu.h"
+#include "pama-icon-cache.h"
 #include "widget-settings.h"
 
 static void     pama_source_output_widget_class_init(PamaSourceOutputWidgetClass *klass);
@@ -37,10 +39,10 @@ static void     pama_source_output_widget_weak_ref_notify(gpointer data, GObject
 static void     pama_source_output_widget_source_output_notify(GObject *gobject, GParamSpec *pspec, PamaSourceOutputWidget *widget);
 
 static void     pama_source_output_widget_update_values(PamaSourceOutputWidget *widget);
+static gboolean pama_source_output_widget_name_query_tooltip(GtkWidget *label, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data);
+static void     pama_source_output_widget_map(GtkWidget *gtk_widget, gpointer data);
 
 static void     pama_source_output_widget_source_button_clicked(GtkButton *button, PamaSourceOutputWidget *widget);
-static void     pama_source_output_widget_source_menu_hidden(GtkWidget *menu_window, PamaSourceOutputWidget *widget);
-static void     pama_source_output_widget_source_menu_item_toggled(GtkCheckMenuItem *item, PamaSourceOutputWidget *widget);
 
 struct _PamaSourceOutputWidgetPrivate
 {
@@ -49,6 +51,7 @@ struct _PamaSourceOutputWidgetPrivate
 	PamaPulseContext      *context;
 	PamaPulseSourceOutput *source_output;
 	gboolean               updating;
+	gboolean               dirty;
 	
 	gulong context_notify_handler_id, source_output_notify_handler_id;
 };
@@ -63,7 +66,8 @@ enum
 
 	PROP_SOURCE_OUTPUT,
 	PROP_CONTEXT,
-	PROP_ICON_SIZEGROUP
+	PROP_ICON_SIZEGROUP,
+	PROP_SOURCE_MENU
 };
 enum
 {
@@ -102,6 +106,13 @@ static void pama_source_output_widget_class_init(PamaSourceOutputWidgetClass *kl
 	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
 	g_object_class_install_property(gobject_class, PROP_ICON_SIZEGROUP, pspec);
 
+	pspec = g_param_spec_object("source-menu",
+	                            "Source menu",
+	                            "The PamaDeviceMenu used to move the source output to another source.",
+	                            PAMA_TYPE_DEVICE_MENU,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_SOURCE_MENU, pspec);
+
 	widget_signals[REORDER_REQUEST_SIGNAL] =
 		g_signal_new("reorder-request",
 		             G_TYPE_FROM_CLASS(gobject_class),
@@ -141,6 +152,10 @@ static void pama_source_output_widget_set_property(GObject *gobject, guint prope
 			priv->icon_sizegroup = g_value_dup_object(value);
 			break;
 
+		case PROP_SOURCE_MENU:
+			priv->source_menu = g_value_dup_object(value);
+			break;
+
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
 			break;
@@ -161,6 +176,8 @@ static GObject* pama_source_output_widget_constructor(GType gtype, guint n_prope
 		g_error("An attempt was made to create a source_output widget with no context.");
 	if (NULL == priv->icon_sizegroup)
 		g_error("An attempt was made to create a source_output widget with no icon sizegroup.");
+	if (NULL == priv->source_menu)
+		g_error("An attempt was made to create a source_output widget with no source menu.");
 
 	alignment = gtk_alignment_new(0, 0.5, 0, 0);
 	gtk_alignment_set_padding(GTK_ALIGNMENT(alignment), 0, 0, 0, 6);
@@ -173,12 +190,14 @@ static GObject* pama_source_output_widget_constructor(GType gtype, guint n_prope
 
 	name = g_object_new(GTK_TYPE_LABEL,
 	                    "ellipsize", PANGO_ELLIPSIZE_MIDDLE,
+	                    "has-tooltip", TRUE,
 	                    "wrap", FALSE,
 	                    "width-chars", WIDGET_NAME_WIDTH_IN_CHARS,
 	                    "xalign", 0.0f,
 	                    NULL);
 	gtk_box_pack_start(GTK_BOX(widget), name, FALSE, FALSE, 0);
 	priv->name = name;
+	g_signal_connect(name, "query-tooltip", G_CALLBACK(pama_source_output_widget_name_query_tooltip), NULL);
 
 	alignment = gtk_alignment_new(0, 0.5, 0, 0);
 	gtk_box_pack_end(GTK_BOX(widget), alignment, FALSE, FALSE, 0);
@@ -200,6 +219,7 @@ static GObject* pama_source_output_widget_constructor(GType gtype, guint n_prope
 	g_signal_connect(source_button, "clicked", G_CALLBACK(pama_source_output_widget_source_button_clicked), widget);
 
 	priv->source_output_notify_handler_id = g_signal_connect(priv->source_output, "notify::source", G_CALLBACK(pama_source_output_widget_source_output_notify), widget);
+	g_signal_connect(widget, "map", G_CALLBACK(pama_source_output_widget_map), NULL);
 
 	/* We no longer need to keep a reference to the icon sizegroup */
 	g_object_unref(priv->icon_sizegroup);
@@ -262,9 +282,38 @@ static void pama_source_output_widget_weak_ref_notify(gpointer data, GObject *wh
 
 static void pama_source_output_widget_source_output_notify(GObject *gobject, GParamSpec *pspec, PamaSourceOutputWidget *widget)
 {
+	PamaSourceOutputWidgetPrivate *priv = PAMA_SOURCE_OUTPUT_WIDGET_GET_PRIVATE(widget);
+
+	/* Hidden widgets, such as those in a collapsed group, catch up when they are shown */
+	if (!GTK_WIDGET_MAPPED(widget))
+	{
+		priv->dirty = TRUE;
+		return;
+	}
+
 	pama_source_output_widget_update_values(widget);
 	g_signal_emit(widget, widget_signals[REORDER_REQUEST_SIGNAL], 0);
 }
+static void pama_source_output_widget_map(GtkWidget *gtk_widget, gpointer data)
+{
+	PamaSourceOutputWidget *widget = PAMA_SOURCE_OUTPUT_WIDGET(gtk_widget);
+	PamaSourceOutputWidgetPrivate *priv = PAMA_SOURCE_OUTPUT_WIDGET_GET_PRIVATE(widget);
+
+	if (!priv->dirty)
+		return;
+
+	priv->dirty = FALSE;
+	pama_source_output_widget_update_values(widget);
+	g_signal_emit(widget, widget_signals[REORDER_REQUEST_SIGNAL], 0);
+}
+
+// Names are ellipsized, so their tooltip shows the whole label. It is only
+// built when the tooltip is about to be shown.
+static gboolean pama_source_output_widget_name_query_tooltip(GtkWidget *label, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data)
+{
+	gtk_tooltip_set_markup(tooltip, gtk_label_get_label(GTK_LABEL(label)));
+	return TRUE;
+}
 
 static void pama_source_output_widget_update_values(PamaSourceOutputWidget *widget)
 {
@@ -294,10 +343,7 @@ static void pama_source_output_widget_update_values(PamaSourceOutputWidget *widg
 	             NULL);
 
 	icon = pama_pulse_source_output_build_gicon(priv->source_output);
-	g_object_set(priv->icon,
-	             "gicon", icon,
-	             "pixel-size", 32,
-	             NULL);
+	pama_icon_cache_set_image(GTK_IMAGE(priv->icon), icon, WIDGET_ICON_SIZE);
 	g_object_unref(icon);
 
 	if (is_local)
@@ -305,7 +351,6 @@ static void pama_source_output_widget_update_values(PamaSourceOutputWidget *widg
 	else
 		temp = g_markup_printf_escaped("<b>%s</b> (on %s)\n%s", client_name, hostname, stream_name);
 	gtk_label_set_markup(GTK_LABEL(priv->name), temp);
-	gtk_widget_set_tooltip_markup(GTK_WIDGET(priv->name), temp);
 	g_free(temp);
 	g_free(stream_name);
 	g_free(client_name);
@@ -315,9 +360,9 @@ static void pama_source_output_widget_update_values(PamaSourceOutputWidget *widg
 	is_pulseaudio = 0 == strcmp(application_id, "org.PulseAudio.PulseAudio");
 	gtk_widget_set_sensitive(priv->source_button, !is_pulseaudio);
 
-	g_object_set(priv->source_button_image,
-	             "gicon", pama_pulse_source_build_gicon(source),
-	             NULL);
+	icon = pama_pulse_source_build_gicon(source);
+	pama_icon_cache_set_image(GTK_IMAGE(priv->source_button_image), icon, WIDGET_BUTTON_ICON_SIZE);
+	g_object_unref(icon);
 
 	g_object_unref(client);
 	g_object_unref(source);
@@ -325,121 +370,11 @@ static void pama_source_output_widget_update_values(PamaSourceOutputWidget *widg
 	priv->updating = FALSE;
 }
 
-static gint _source_menu_sort_function(gconstpointer a, gconstpointer b) 
-{
-	gint result = pama_pulse_source_compare_by_is_monitor(a, b);
-	if (result)
-		return result;
-
-	result = pama_pulse_source_compare_by_hostname(a, b);
-	if (result)
-		return result;
-
-	return pama_pulse_source_compare_by_description(a, b);
-
-}
 static void pama_source_output_widget_source_button_clicked(GtkButton *button, PamaSourceOutputWidget *widget)
 {
 	PamaSourceOutputWidgetPrivate *priv = PAMA_SOURCE_OUTPUT_WIDGET_GET_PRIVATE(widget);
-	GtkWidget *item, *last = NULL;
-	GtkWidget *label;
-	GSList *sources, *iter;
-	PamaPulseSource *source, *current_source;
-	PamaPulseSink *monitored_sink;
-	gchar *source_name, *hostname;
-	gboolean network;
-	gchar *text;
-
-	if (!priv->source_menu)
-	{
-		priv->source_menu = gtk_menu_new();
-		g_object_ref_sink(priv->source_menu);
-		g_signal_connect(gtk_widget_get_toplevel(priv->source_menu), "hide", G_CALLBACK(pama_source_output_widget_source_menu_hidden), widget);
-
-		sources = g_slist_copy(pama_pulse_context_get_sources(priv->context));
-		sources = g_slist_sort(sources, _source_menu_sort_function);
-
-		g_object_get(priv->source_output, "source", &current_source, NULL);
-
-		for (iter = sources; iter; iter = iter->next)
-		{
-			source = PAMA_PULSE_SOURCE(iter->data);
-			g_object_get(source, 
-			             "description", &source_name, 
-			             "hostname",    &hostname,
-			             "network",     &network,
-			             NULL);
-			monitored_sink = pama_pulse_source_get_monitored_sink(source);
-			if (monitored_sink)
-			{
-				g_free(source_name);
-				g_free(hostname);
-
-				g_object_get(monitored_sink, 
-		 		            "description", &text,
-		 		            "hostname",    &hostname,
-		  		            "network",     &network,
-				             NULL);
-
-				source_name = g_markup_printf_escaped(_("Monitor of %s"), text);
-				g_free(text);
-			}
-
-			if (network)
-				text = g_markup_printf_escaped("<b>%s</b> (on %s)", source_name, hostname);
-			else
-				text = g_markup_printf_escaped("<b>%s</b>", source_name);
-
-			label = g_object_new(GTK_TYPE_LABEL,
-			                     "label", text,
-			                     "use-markup", TRUE,
-			                     "xalign", 0.0,
-			                     NULL);
-
-			if (last)
-				item = gtk_radio_menu_item_new_from_widget(GTK_RADIO_MENU_ITEM(last));
-			else
-				item = gtk_radio_menu_item_new(NULL);
-
-			gtk_container_add(GTK_CONTAINER(item), label);
-
-			g_object_set(item,
-			             "active", (current_source == source),
-			             "user-data", source,
-			             NULL);
-			last = item;
-			g_free(source_name);
-			g_free(hostname);
-			g_free(text);
-
-			g_signal_connect(item, "toggled", G_CALLBACK(pama_source_output_widget_source_menu_item_toggled), widget);
-			gtk_menu_shell_append(GTK_MENU_SHELL(priv->source_menu), item);
-			gtk_widget_show_all(item);
-		}
-
-		g_slist_free(sources);
-		g_object_unref(current_source);
-
-		gtk_menu_popup(GTK_MENU(priv->source_menu), NULL, NULL, NULL, NULL, 0, gtk_get_current_event_time());
-	}
-}
-static void pama_source_output_widget_source_menu_hidden(GtkWidget *menu_window, PamaSourceOutputWidget *widget)
-{
-	PamaSourceOutputWidgetPrivate *priv = PAMA_SOURCE_OUTPUT_WIDGET_GET_PRIVATE(widget);
-	g_object_unref(priv->source_menu);
-	priv->source_menu = NULL;
-}
-static void pama_source_output_widget_source_menu_item_toggled(GtkCheckMenuItem *item, PamaSourceOutputWidget *widget)
-{
-	PamaSourceOutputWidgetPrivate *priv = PAMA_SOURCE_OUTPUT_WIDGET_GET_PRIVATE(widget);
-	PamaPulseSource *source;
-
-	if (!gtk_check_menu_item_get_active(item))
-		return;
 
-	g_object_get(item, "user-data", &source, NULL);
-
-	pama_pulse_source_output_set_source(priv->source_output, source);
+	pama_device_menu_popup(PAMA_DEVICE_MENU(priv->source_menu), G_OBJECT(priv->source_output));
 }
 
 gint pama_source_output_widget_compare(gconstpointer a, gconstpointer b)
@@ -470,3 +405,10 @@ gint pama_source_output_widget_compare(gconstpointer a, gconstpointer b)
 	g_object_unref(Bc);
 	return result;
 }
+
+PamaPulseSourceOutput *pama_source_output_widget_get_source_output(PamaSourceOutputWidget *widget)
+{
+	PamaSourceOutputWidgetPrivate *priv = PAMA_SOURCE_OUTPUT_WIDGET_GET_PRIVATE(widget);
+
+	return priv->source_output;
+}
@@ -54,6 +54,7 @@ GType pama_source_output_widget_get_type();
 
 /* methods */
 gint pama_source_output_widget_compare(gconstpointer a, gconstpointer b);
+PamaPulseSourceOutput *pama_source_output_widget_get_source_output(PamaSourceOutputWidget *widget);
 
 G_END_DECLS
 
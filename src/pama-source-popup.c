@@ -27,6 +27,13 @@
 #include "pama-source-popup.h"
 #include "pama-source-widget.h"
 #include "pama-source-output-widget.h"
+#include "pama-stream-model.h"
+#include "pama-stream-list.h"
+#include "pama-stream-row.h"
+#include "pama-stream-index.h"
+#include "pama-host-group.h"
+#include "pama-device-menu.h"
+#include "widget-settings.h"
 
 static void     pama_source_popup_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec);
 static GObject* pama_source_popup_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties);
@@ -44,11 +51,36 @@ static void     pama_source_popup_reorder_source_outputs(PamaSourceOutputWidget
 static void     pama_source_popup_add_source       (PamaSourcePopup *popup, PamaPulseSource      *source);
 static void     pama_source_popup_add_source_output(PamaSourcePopup *popup, PamaPulseSourceOutput *source_output);
 
+static void       pama_source_popup_update_stream_mode(PamaSourcePopup *popup);
+static GtkWidget* pama_source_popup_create_stream_row(GObject *stream, gpointer data);
+static GtkWidget* pama_source_popup_create_list_row(GObject *stream, gpointer data);
+
+static void       pama_source_popup_filter_changed(GtkEditable *editable, gpointer data);
+static void       pama_source_popup_apply_filter(PamaSourcePopup *popup);
+static gboolean   pama_source_popup_filter_visible(GtkTreeModel *model, GtkTreeIter *iter, gpointer data);
+static void       pama_source_popup_filter_box(PamaSourcePopup *popup, GtkBox *box);
+
+static GtkWidget* pama_source_popup_create_source_widget(GObject *source, gpointer data);
+static GtkWidget* pama_source_popup_create_remote_stream(GObject *stream, gpointer data);
+static void       pama_source_popup_add_to_host_group(PamaSourcePopup *popup, GHashTable *hosts, GtkBox *box, const gchar *hostname, GObject *object, PamaHostGroupBuildFunc build_func, GCompareFunc compare_func);
+static void       pama_source_popup_host_group_destroyed(GtkWidget *group, gpointer data);
+
 struct _PamaSourcePopupPrivate
 {
 	GtkBox *source_box, *stream_box;
 	GtkSizeGroup *icon_sizegroup;
+	GtkWidget *source_menu;
 	GtkWidget *no_apps, *no_devices;
+	GtkWidget *filter_entry;
+	PamaStreamIndex *stream_index;
+
+	/* Only used while there are too many streams for one widget each */
+	PamaStreamModel *stream_model;
+	GtkTreeModel *stream_filter;
+	GtkWidget *stream_list;
+
+	/* Host name -> PamaHostGroup, for the devices and the streams of remote hosts */
+	GHashTable *device_hosts, *stream_hosts;
 
 	PamaPulseContext *context;
 	gulong source_added_handler_id;
@@ -92,7 +124,7 @@ static void pama_source_popup_init(PamaSourcePopup *popup)
 	gchar *markup;
 	GtkWidget *frame, *main_box;
 	GtkWidget *source_frame,   *source_align,   *source_box;
-	GtkWidget *stream_frame, *stream_align, *stream_box;
+	GtkWidget *stream_frame, *stream_align, *stream_vbox, *stream_box, *filter_entry;
 	GtkWidget *no_apps, *no_devices;
 	GtkSizeGroup *icon_sizegroup;
 
@@ -146,8 +178,20 @@ static void pama_source_popup_init(PamaSourcePopup *popup)
 	gtk_alignment_set_padding(GTK_ALIGNMENT(stream_align), 6, 0, 12, 0);
 	gtk_container_add(GTK_CONTAINER(stream_frame), stream_align);
 
+	stream_vbox = gtk_vbox_new(FALSE, 6);
+	gtk_container_add(GTK_CONTAINER(stream_align), stream_vbox);
+
+	filter_entry = g_object_new(GTK_TYPE_ENTRY,
+	                            "no-show-all", TRUE,
+	                            NULL);
+	gtk_widget_set_tooltip_text(filter_entry, _("Show only the applications matching this text"));
+	gtk_box_pack_start(GTK_BOX(stream_vbox), filter_entry, FALSE, FALSE, 0);
+	g_signal_connect(filter_entry, "changed", G_CALLBACK(pama_source_popup_filter_changed), popup);
+	pama_popup_set_filter_entry(PAMA_POPUP(popup), GTK_ENTRY(filter_entry));
+	priv->filter_entry = filter_entry;
+
 	stream_box = gtk_vbox_new(FALSE, 6);
-	gtk_container_add(GTK_CONTAINER(stream_align), stream_box);
+	gtk_box_pack_start(GTK_BOX(stream_vbox), stream_box, FALSE, FALSE, 0);
 	priv->stream_box = GTK_BOX(stream_box);
 
 	markup = g_markup_printf_escaped("<i>%s</i>", _("No applications recording"));
@@ -166,6 +210,9 @@ static void pama_source_popup_init(PamaSourcePopup *popup)
 
 	icon_sizegroup = gtk_size_group_new(GTK_SIZE_GROUP_BOTH);
 	priv->icon_sizegroup = icon_sizegroup;
+
+	priv->device_hosts = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	priv->stream_hosts = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 }
 
 static GObject* pama_source_popup_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties)
@@ -185,6 +232,15 @@ static GObject* pama_source_popup_constructor(GType gtype, guint n_properties, G
 		pama_source_popup_add_source(popup, source);
 	}
 
+	/* One menu, kept up to date, serves every stream that is moved to another source */
+	priv->source_menu = pama_device_menu_new(priv->context, PAMA_TYPE_PULSE_SOURCE);
+	g_object_ref_sink(priv->source_menu);
+
+	/* Created before connecting to the context, so the index is up to date by the time the popup hears of a change */
+	priv->stream_index = pama_stream_index_new(priv->context, PAMA_TYPE_PULSE_SOURCE_OUTPUT);
+	g_signal_connect_swapped(priv->stream_index, "changed", G_CALLBACK(pama_source_popup_apply_filter), popup);
+
+	pama_source_popup_update_stream_mode(popup);
 	for (iter = pama_pulse_context_get_source_outputs(priv->context); iter; iter = iter->next)
 	{
 		PamaPulseSourceOutput *source_output = PAMA_PULSE_SOURCE_OUTPUT(iter->data);
@@ -237,6 +293,44 @@ static void pama_source_popup_dispose(GObject *gobject)
 		priv->context = NULL;
 	}
 
+	if (priv->stream_filter)
+	{
+		g_object_unref(priv->stream_filter);
+		priv->stream_filter = NULL;
+	}
+
+	if (priv->stream_model)
+	{
+		g_object_unref(priv->stream_model);
+		priv->stream_model = NULL;
+	}
+
+	if (priv->source_menu)
+	{
+		gtk_widget_destroy(priv->source_menu);
+		g_object_unref(priv->source_menu);
+		priv->source_menu = NULL;
+	}
+
+	if (priv->device_hosts)
+	{
+		g_hash_table_destroy(priv->device_hosts);
+		priv->device_hosts = NULL;
+	}
+
+	if (priv->stream_hosts)
+	{
+		g_hash_table_destroy(priv->stream_hosts);
+		priv->stream_hosts = NULL;
+	}
+
+	if (priv->stream_index)
+	{
+		g_signal_handlers_disconnect_by_func(priv->stream_index, pama_source_popup_apply_filter, popup);
+		g_object_unref(priv->stream_index);
+		priv->stream_index = NULL;
+	}
+
 	G_OBJECT_CLASS(pama_source_popup_parent_class)->dispose(gobject);
 }
 static void pama_source_popup_weak_ref_notify(gpointer data, GObject *where_the_object_was)
@@ -272,22 +366,55 @@ static void pama_source_popup_set_property(GObject *gobject, guint property_id,
 static void  pama_source_popup_add_source(PamaSourcePopup *popup, PamaPulseSource *source)
 {
 	PamaSourcePopupPrivate *priv = PAMA_SOURCE_POPUP_GET_PRIVATE(popup);
-	GtkWidget *group = NULL;
 	GtkWidget *source_widget;
-	GList *iter;
-	GList *box_children = gtk_container_get_children(GTK_CONTAINER(priv->source_box));
-	
+	gchar *hostname;
+	gboolean network;
+
 	gtk_widget_hide(priv->no_devices);
 
-	/* If there is already a source widget, group with it */
-	for (iter = box_children; iter; iter = iter->next)
+	/* The devices of a remote host get widgets once its group is first expanded */
+	g_object_get(source,
+	             "network", &network,
+	             "hostname", &hostname,
+	             NULL);
+	if (network && hostname && *hostname)
+	{
+		pama_source_popup_add_to_host_group(popup, priv->device_hosts, priv->source_box, hostname, G_OBJECT(source),
+		                                    pama_source_popup_create_source_widget, pama_source_widget_compare);
+		g_free(hostname);
+		return;
+	}
+	g_free(hostname);
+
+	source_widget = pama_source_popup_create_source_widget(G_OBJECT(source), popup);
+	g_signal_connect(source_widget, "reorder-request", G_CALLBACK(pama_source_popup_reorder_sources), popup);
+	
+	gtk_box_pack_start(GTK_BOX(priv->source_box), source_widget, FALSE, FALSE, 0);
+	pama_source_popup_reorder_sources(NULL, popup);
+}
+static GtkWidget* pama_source_popup_create_source_widget(GObject *source, gpointer data)
+{
+	PamaSourcePopup *popup = PAMA_SOURCE_POPUP(data);
+	PamaSourcePopupPrivate *priv = PAMA_SOURCE_POPUP_GET_PRIVATE(popup);
+	GtkWidget *group = NULL;
+	GtkWidget *source_widget;
+	GList *box_children, *group_children, *iter;
+
+	/* If there is already a source widget, possibly in the group of a remote host, group with it */
+	box_children = gtk_container_get_children(GTK_CONTAINER(priv->source_box));
+	for (iter = box_children; iter && !group; iter = iter->next)
 	{
 		if (PAMA_IS_SOURCE_WIDGET(iter->data))
-		{
 			group = GTK_WIDGET(iter->data);
-			break;
+		else if (PAMA_IS_HOST_GROUP(iter->data))
+		{
+			group_children = gtk_container_get_children(GTK_CONTAINER(pama_host_group_get_box(PAMA_HOST_GROUP(iter->data))));
+			if (group_children)
+				group = GTK_WIDGET(group_children->data);
+			g_list_free(group_children);
 		}
 	}
+	g_list_free(box_children);
 
 	source_widget = 
 		g_object_new(PAMA_TYPE_SOURCE_WIDGET,
@@ -296,25 +423,49 @@ static void  pama_source_popup_add_source(PamaSourcePopup *popup, PamaPulseSourc
 		             "group", group,
 		             "icon-sizegroup", priv->icon_sizegroup,
 		             NULL);
-
-	g_signal_connect(source_widget, "reorder-request", G_CALLBACK(pama_source_popup_reorder_sources), popup);
-	
-	gtk_box_pack_start(GTK_BOX(priv->source_box), source_widget, FALSE, FALSE, 0);
-	pama_source_popup_reorder_sources(NULL, popup);
 	gtk_widget_show_all(source_widget);
+
+	return source_widget;
 }
 static void pama_source_popup_add_source_output(PamaSourcePopup *popup, PamaPulseSourceOutput *source_output)
 {
 	PamaSourcePopupPrivate *priv = PAMA_SOURCE_POPUP_GET_PRIVATE(popup);
 	GtkWidget *source_output_widget;
+	PamaPulseClient *client;
+	gchar *hostname = NULL;
+	gboolean is_local = TRUE;
 	
 	gtk_widget_hide(priv->no_apps);
 
+	/* The list creates the widgets of its visible rows itself */
+	if (priv->stream_list)
+		return;
+
+	/* The streams of remote clients get widgets once their host's group is first expanded */
+	g_object_get(source_output, "client", &client, NULL);
+	if (client)
+	{
+		g_object_get(client,
+		             "is-local", &is_local,
+		             "hostname", &hostname,
+		             NULL);
+		g_object_unref(client);
+	}
+	if (!is_local && hostname && *hostname)
+	{
+		pama_source_popup_add_to_host_group(popup, priv->stream_hosts, priv->stream_box, hostname, G_OBJECT(source_output),
+		                                    pama_source_popup_create_remote_stream, pama_source_output_widget_compare);
+		g_free(hostname);
+		return;
+	}
+	g_free(hostname);
+
 	source_output_widget = 
 		g_object_new(PAMA_TYPE_SOURCE_OUTPUT_WIDGET,
 		             "context", priv->context, 
 		             "source-output", source_output,
 		             "icon-sizegroup", priv->icon_sizegroup,
+		             "source-menu", priv->source_menu,
 		             NULL);
 
 	g_signal_connect(source_output_widget, "reorder-request", G_CALLBACK(pama_source_popup_reorder_source_outputs), popup);
@@ -322,6 +473,46 @@ static void pama_source_popup_add_source_output(PamaSourcePopup *popup, PamaPuls
 	gtk_box_pack_start(GTK_BOX(priv->stream_box), source_output_widget, FALSE, FALSE, 0);
 	pama_source_popup_reorder_source_outputs(NULL, popup);
 	gtk_widget_show_all(source_output_widget);
+
+	if (!pama_stream_index_matches(priv->stream_index, G_OBJECT(source_output)))
+		gtk_widget_hide(source_output_widget);
+}
+
+static void pama_source_popup_add_to_host_group(PamaSourcePopup *popup, GHashTable *hosts, GtkBox *box, const gchar *hostname, GObject *object, PamaHostGroupBuildFunc build_func, GCompareFunc compare_func)
+{
+	PamaSourcePopupPrivate *priv = PAMA_SOURCE_POPUP_GET_PRIVATE(popup);
+	GtkWidget *group = g_hash_table_lookup(hosts, hostname);
+
+	if (!group)
+	{
+		group = pama_host_group_new(hostname, build_func, compare_func, popup);
+		g_hash_table_insert(hosts, g_strdup(hostname), group);
+		g_signal_connect(group, "destroy", G_CALLBACK(pama_source_popup_host_group_destroyed), popup);
+
+		gtk_box_pack_start(box, group, FALSE, FALSE, 0);
+		gtk_widget_show_all(group);
+	}
+
+	pama_host_group_add(PAMA_HOST_GROUP(group), object);
+
+	if (box == priv->source_box)
+		pama_source_popup_reorder_sources(NULL, popup);
+	else
+	{
+		pama_source_popup_reorder_source_outputs(NULL, popup);
+		pama_source_popup_apply_filter(popup);
+	}
+}
+static void pama_source_popup_host_group_destroyed(GtkWidget *group, gpointer data)
+{
+	PamaSourcePopupPrivate *priv = PAMA_SOURCE_POPUP_GET_PRIVATE(data);
+	const gchar *hostname = pama_host_group_get_hostname(PAMA_HOST_GROUP(group));
+
+	/* A host may have one group among the devices and another among the streams */
+	if (priv->device_hosts && g_hash_table_lookup(priv->device_hosts, hostname) == group)
+		g_hash_table_remove(priv->device_hosts, hostname);
+	if (priv->stream_hosts && g_hash_table_lookup(priv->stream_hosts, hostname) == group)
+		g_hash_table_remove(priv->stream_hosts, hostname);
 }
 
 static void pama_source_popup_source_added(PamaPulseContext *context, guint index, gpointer data)
@@ -345,6 +536,7 @@ static void pama_source_popup_source_output_added(PamaPulseContext *context, gui
 	PamaSourcePopup      *popup       = PAMA_SOURCE_POPUP(data);
 	PamaPulseSourceOutput *source_output = pama_pulse_context_get_source_output_by_index(context, index);
 
+	pama_source_popup_update_stream_mode(popup);
 	pama_source_popup_add_source_output(popup, source_output);
 	pama_source_popup_reorder_source_outputs(NULL, popup);
 }
@@ -355,17 +547,163 @@ static void pama_source_popup_source_output_removed(PamaPulseContext *context, g
 
 	if (!pama_pulse_context_get_source_outputs(context))
 		gtk_widget_show(priv->no_apps);
+
+	pama_source_popup_update_stream_mode(popup);
+}
+
+static GtkWidget* pama_source_popup_create_stream_row(GObject *stream, gpointer data)
+{
+	PamaSourcePopup *popup = PAMA_SOURCE_POPUP(data);
+	PamaSourcePopupPrivate *priv = PAMA_SOURCE_POPUP_GET_PRIVATE(popup);
+
+	return g_object_new(PAMA_TYPE_SOURCE_OUTPUT_WIDGET,
+	                    "context", priv->context,
+	                    "source-output", stream,
+	                    "icon-sizegroup", priv->icon_sizegroup,
+	                    "source-menu", priv->source_menu,
+	                    NULL);
+}
+static GtkWidget* pama_source_popup_create_list_row(GObject *stream, gpointer data)
+{
+	PamaSourcePopupPrivate *priv = PAMA_SOURCE_POPUP_GET_PRIVATE(data);
+
+	/* The stream list can hold hundreds of rows, so it uses the lightweight ones */
+	return pama_stream_row_new(priv->context, stream, priv->source_menu);
+}
+static GtkWidget* pama_source_popup_create_remote_stream(GObject *stream, gpointer data)
+{
+	PamaSourcePopupPrivate *priv = PAMA_SOURCE_POPUP_GET_PRIVATE(data);
+	GtkWidget *widget = pama_source_popup_create_stream_row(stream, data);
+
+	gtk_widget_show_all(widget);
+	if (!pama_stream_index_matches(priv->stream_index, stream))
+		gtk_widget_hide(widget);
+
+	return widget;
+}
+static void pama_source_popup_update_stream_mode(PamaSourcePopup *popup)
+{
+	PamaSourcePopupPrivate *priv = PAMA_SOURCE_POPUP_GET_PRIVATE(popup);
+	GSList *source_outputs = pama_pulse_context_get_source_outputs(priv->context);
+	guint n_source_outputs = g_slist_length(source_outputs);
+	GList *children, *iter;
+	GSList *siter;
+
+	if (!priv->stream_list && n_source_outputs > WIDGET_STREAM_LIST_THRESHOLD)
+	{
+		children = gtk_container_get_children(GTK_CONTAINER(priv->stream_box));
+		for (iter = children; iter; iter = iter->next)
+		{
+			if (PAMA_IS_SOURCE_OUTPUT_WIDGET(iter->data) || PAMA_IS_HOST_GROUP(iter->data))
+				gtk_widget_destroy(GTK_WIDGET(iter->data));
+		}
+		g_list_free(children);
+
+		priv->stream_model  = pama_stream_model_new(priv->context, PAMA_TYPE_PULSE_SOURCE_OUTPUT);
+		priv->stream_filter = gtk_tree_model_filter_new(GTK_TREE_MODEL(priv->stream_model), NULL);
+		gtk_tree_model_filter_set_visible_func(GTK_TREE_MODEL_FILTER(priv->stream_filter), pama_source_popup_filter_visible, popup, NULL);
+		priv->stream_list   = pama_stream_list_new(priv->stream_filter, pama_source_popup_create_list_row, popup);
+		g_signal_connect(priv->stream_list, "destroy", G_CALLBACK(gtk_widget_destroyed), &priv->stream_list);
+
+		gtk_box_pack_start(GTK_BOX(priv->stream_box), priv->stream_list, FALSE, FALSE, 0);
+		gtk_widget_show_all(priv->stream_list);
+	}
+	else if (priv->stream_list && n_source_outputs <= WIDGET_STREAM_LIST_THRESHOLD / 2)
+	{
+		gtk_widget_destroy(priv->stream_list);
+		g_object_unref(priv->stream_filter);
+		priv->stream_filter = NULL;
+		g_object_unref(priv->stream_model);
+		priv->stream_model = NULL;
+
+		for (siter = source_outputs; siter; siter = siter->next)
+			pama_source_popup_add_source_output(popup, PAMA_PULSE_SOURCE_OUTPUT(siter->data));
+	}
+}
+
+static void pama_source_popup_filter_changed(GtkEditable *editable, gpointer data)
+{
+	PamaSourcePopup *popup = PAMA_SOURCE_POPUP(data);
+	PamaSourcePopupPrivate *priv = PAMA_SOURCE_POPUP_GET_PRIVATE(popup);
+
+	/* Emits "changed" on the index, which applies the filter */
+	pama_stream_index_set_query(priv->stream_index, gtk_entry_get_text(GTK_ENTRY(editable)));
+}
+static void pama_source_popup_apply_filter(PamaSourcePopup *popup)
+{
+	PamaSourcePopupPrivate *priv = PAMA_SOURCE_POPUP_GET_PRIVATE(popup);
+
+	if (priv->stream_filter)
+	{
+		gtk_tree_model_filter_refilter(GTK_TREE_MODEL_FILTER(priv->stream_filter));
+		return;
+	}
+
+	pama_source_popup_filter_box(popup, priv->stream_box);
+}
+static void pama_source_popup_filter_box(PamaSourcePopup *popup, GtkBox *box)
+{
+	PamaSourcePopupPrivate *priv = PAMA_SOURCE_POPUP_GET_PRIVATE(popup);
+	GList *children, *iter;
+
+	children = gtk_container_get_children(GTK_CONTAINER(box));
+	for (iter = children; iter; iter = iter->next)
+	{
+		GObject *source_output;
+		gboolean visible = FALSE;
+		GSList *members;
+
+		if (PAMA_IS_HOST_GROUP(iter->data))
+		{
+			/* A host stays visible while any of its streams match, whether or not their widgets exist yet */
+			members = pama_host_group_get_members(PAMA_HOST_GROUP(iter->data));
+			for (; members && !visible; members = members->next)
+				visible = pama_stream_index_matches(priv->stream_index, G_OBJECT(members->data));
+
+			pama_source_popup_filter_box(popup, pama_host_group_get_box(PAMA_HOST_GROUP(iter->data)));
+		}
+		else if (PAMA_IS_SOURCE_OUTPUT_WIDGET(iter->data))
+		{
+			source_output = G_OBJECT(pama_source_output_widget_get_source_output(PAMA_SOURCE_OUTPUT_WIDGET(iter->data)));
+			visible = pama_stream_index_matches(priv->stream_index, source_output);
+		}
+		else
+			continue;
+
+		if (visible)
+			gtk_widget_show(GTK_WIDGET(iter->data));
+		else
+			gtk_widget_hide(GTK_WIDGET(iter->data));
+	}
+	g_list_free(children);
+}
+static gboolean pama_source_popup_filter_visible(GtkTreeModel *model, GtkTreeIter *iter, gpointer data)
+{
+	PamaSourcePopupPrivate *priv = PAMA_SOURCE_POPUP_GET_PRIVATE(data);
+	GObject *stream = pama_stream_model_get_stream(model, iter);
+
+	return stream && pama_stream_index_matches(priv->stream_index, stream);
 }
 
 static gint pama_source_popup_reorder_sources__compare_sources(gconstpointer a, gconstpointer b)
 {
 	const GtkBoxChild *A = a, *B = b;
 
-	if (!PAMA_IS_SOURCE_WIDGET(A->widget))
+	if (!PAMA_IS_SOURCE_WIDGET(A->widget) && !PAMA_IS_HOST_GROUP(A->widget))
 		return -1;
-	if (!PAMA_IS_SOURCE_WIDGET(B->widget))
+	if (!PAMA_IS_SOURCE_WIDGET(B->widget) && !PAMA_IS_HOST_GROUP(B->widget))
 		return +1;
 
+	/* Remote hosts follow the local rows */
+	if (PAMA_IS_HOST_GROUP(A->widget) || PAMA_IS_HOST_GROUP(B->widget))
+	{
+		if (!PAMA_IS_HOST_GROUP(A->widget))
+			return -1;
+		if (!PAMA_IS_HOST_GROUP(B->widget))
+			return +1;
+		return pama_host_group_compare(A->widget, B->widget);
+	}
+
 	return pama_source_widget_compare(PAMA_SOURCE_WIDGET(A->widget), PAMA_SOURCE_WIDGET(B->widget));
 }
 static void pama_source_popup_reorder_sources(PamaSourceWidget *widget, gpointer data)
@@ -390,11 +728,21 @@ static gint pama_source_popup_reorder_source_outputs__compare_source_outputs(gco
 {
 	const GtkBoxChild *A = a, *B = b;
 
-	if (!PAMA_IS_SOURCE_OUTPUT_WIDGET(A->widget))
+	if (!PAMA_IS_SOURCE_OUTPUT_WIDGET(A->widget) && !PAMA_IS_HOST_GROUP(A->widget))
 		return -1;
-	if (!PAMA_IS_SOURCE_OUTPUT_WIDGET(B->widget))
+	if (!PAMA_IS_SOURCE_OUTPUT_WIDGET(B->widget) && !PAMA_IS_HOST_GROUP(B->widget))
 		return +1;
 
+	/* Remote hosts follow the local rows */
+	if (PAMA_IS_HOST_GROUP(A->widget) || PAMA_IS_HOST_GROUP(B->widget))
+	{
+		if (!PAMA_IS_HOST_GROUP(A->widget))
+			return -1;
+		if (!PAMA_IS_HOST_GROUP(B->widget))
+			return +1;
+		return pama_host_group_compare(A->widget, B->widget);
+	}
+
 	return pama_source_output_widget_compare(PAMA_SOURCE_OUTPUT_WIDGET(A->widget), PAMA_SOURCE_OUTPUT_WIDGET(B->widget));
 }
 static void pama_source_popup_reorder_source_outputs(PamaSourceOutputWidget *widget, gpointer data)
@@ -25,6 +25,14 @@
 #include <glib/gi18n.h>
  
 #include "pama-source-widget.h"
+#include "pama-activity-badge.h"
+#include "pama-clip-history.h"
+#include "pama-icon-cache.h"
+#include "pama-latency-poll.h"
+#include "pama-meter-clock.h"
+#include "pama-pulse-meter.h"
+#include "pama-spectrum-window.h"
+#include "pama-volume-map.h"
 #include "widget-settings.h"
 
 static void     pama_source_widget_class_init(PamaSourceWidgetClass *klass);
@@ -38,20 +46,38 @@ static void     pama_source_widget_source_notify   (GObject *gobject, GParamSpec
 static void     pama_source_widget_context_notify(GObject *gobject, GParamSpec *pspec, gpointer data);
 
 static void     pama_source_widget_update_values  (PamaSourceWidget *widget);
+static gboolean pama_source_widget_name_query_tooltip(GtkWidget *label, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data);
+static void     pama_source_widget_map(GtkWidget *gtk_widget, gpointer data);
+static void     pama_source_widget_unmap(GtkWidget *gtk_widget, gpointer data);
+static void     pama_source_widget_start_meter(PamaSourceWidget *widget);
+static void     pama_source_widget_stop_meter (PamaSourceWidget *widget);
+static void     pama_source_widget_level_notify(GObject *gobject, GParamSpec *pspec, gpointer data);
+static void     pama_source_widget_clipping_notify(GObject *gobject, GParamSpec *pspec, gpointer data);
+static void     pama_source_widget_loudness_notify(GObject *gobject, GParamSpec *pspec, gpointer data);
+static gboolean pama_source_widget_loudness_query_tooltip(GtkWidget *label, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data);
+static void     pama_source_widget_latency_notify(GObject *gobject, GParamSpec *pspec, gpointer data);
+static gboolean pama_source_widget_latency_query_tooltip(GtkWidget *label, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data);
+static void     pama_source_widget_set_polling(PamaSourceWidget *widget, gboolean polling);
 static void     pama_source_widget_default_toggled(GtkToggleButton *togglebutton, gpointer data);
 static void     pama_source_widget_mute_toggled   (GtkToggleButton *togglebutton, gpointer data);
+static void     pama_source_widget_spectrum_clicked(GtkButton *button, gpointer data);
 static void     pama_source_widget_volume_changed (GtkRange *range, gpointer data);
+static void     pama_source_widget_balance_changed(GtkRange *range, gpointer data);
 
 struct _PamaSourceWidgetPrivate
 {
-	GtkWidget        *icon, *name, *volume, *value, *mute, *default_source;
+	GtkWidget        *icon, *name, *volume, *level, *loudness, *latency, *balance, *value, *spectrum, *mute, *default_source;
 	GtkSizeGroup     *icon_sizegroup;
 	PamaPulseContext *context;
 	PamaPulseSource  *source;
 	PamaSourceWidget *group;
 	gboolean          updating;
+	gboolean          dirty;
+	gboolean          polling;
+	PamaPulseMeter   *meter;
+	GtkWidget        *spectrum_window;
 	
-	gulong context_notify_handler_id, source_notify_handler_id;
+	gulong context_notify_handler_id, source_notify_handler_id, latency_notify_handler_id;
 };
 
 G_DEFINE_TYPE(PamaSourceWidget, pama_source_widget, GTK_TYPE_HBOX);
@@ -162,7 +188,7 @@ static void pama_source_widget_set_property(GObject *gobject, guint property_id,
 static GObject* pama_source_widget_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties)
 {
 	GtkWidget *icon, *name, *alignment;
-	GtkWidget *inner_box, *volume, *value, *mute, *default_source;
+	GtkWidget *inner_box, *volume_box, *volume, *level, *loudness, *latency, *balance, *value, *spectrum, *mute, *default_source;
 	gboolean   decibel_volume;
 
 	GObject *gobject = G_OBJECT_CLASS(pama_source_widget_parent_class)->constructor(gtype, n_properties, properties);
@@ -187,16 +213,19 @@ static GObject* pama_source_widget_constructor(GType gtype, guint n_properties,
 	icon = gtk_image_new();
 	gtk_container_add(GTK_CONTAINER(alignment), icon);
 	gtk_size_group_add_widget(priv->icon_sizegroup, icon);
+	pama_activity_badge_attach(icon);
 	priv->icon = icon;
 
 	name = g_object_new(GTK_TYPE_LABEL,
 	                    "ellipsize", PANGO_ELLIPSIZE_MIDDLE,
+	                    "has-tooltip", TRUE,
 	                    "wrap", FALSE,
 	                    "width-chars", WIDGET_NAME_WIDTH_IN_CHARS,
 	                    "xalign", 0.0,
 	                    NULL);
 	gtk_box_pack_start(GTK_BOX(widget), name, FALSE, FALSE, 0);
 	priv->name = name;
+	g_signal_connect(name, "query-tooltip", G_CALLBACK(pama_source_widget_name_query_tooltip), widget);
 
 	alignment = gtk_alignment_new(0, 0.5, 0, 0);
 	gtk_box_pack_start(GTK_BOX(widget), alignment, FALSE, FALSE, 0);
@@ -204,15 +233,58 @@ static GObject* pama_source_widget_constructor(GType gtype, guint n_properties,
 	volume = gtk_hscale_new_with_range(0, decibel_volume ? WIDGET_VOLUME_SLIDER_DB_RANGE : 100, 2.5); /* for scroll steps of 5%/5dB */
 	gtk_scale_set_draw_value   (GTK_SCALE(volume), FALSE);
 	gtk_widget_set_size_request(volume, WIDGET_VOLUME_SLIDER_WIDTH, -1);
-	gtk_container_add(GTK_CONTAINER(alignment), volume);
+	volume_box = gtk_vbox_new(FALSE, 0);
+	gtk_container_add(GTK_CONTAINER(alignment), volume_box);
+	gtk_box_pack_start(GTK_BOX(volume_box), volume, FALSE, FALSE, 0);
 	priv->volume = volume;
 
+	/* Peak level, only fed while the widget is mapped */
+	level = gtk_progress_bar_new();
+	gtk_widget_set_size_request(level, WIDGET_VOLUME_SLIDER_WIDTH, WIDGET_LEVEL_METER_HEIGHT);
+	gtk_box_pack_start(GTK_BOX(volume_box), level, FALSE, FALSE, 0);
+	priv->level = level;
+
+	/* Only shown for channel maps that have a left and a right */
+	alignment = gtk_alignment_new(0, 0.5, 0, 0);
+	gtk_box_pack_start(GTK_BOX(widget), alignment, FALSE, FALSE, 0);
+
+	balance = gtk_hscale_new_with_range(-1.0, 1.0, 0.1);
+	gtk_scale_set_draw_value   (GTK_SCALE(balance), FALSE);
+	gtk_scale_add_mark         (GTK_SCALE(balance), 0.0, GTK_POS_BOTTOM, NULL);
+	gtk_widget_set_size_request(balance, WIDGET_BALANCE_SLIDER_WIDTH, -1);
+	gtk_widget_set_tooltip_text(balance, _("Balance between the left and right speakers"));
+	gtk_widget_set_no_show_all (balance, TRUE);
+	gtk_container_add(GTK_CONTAINER(alignment), balance);
+	priv->balance = balance;
+
 	alignment = gtk_alignment_new(0, 0.5, 0, 0);
 	gtk_box_pack_start(GTK_BOX(widget), alignment, FALSE, FALSE, 0);
 
 	inner_box = gtk_hbox_new(FALSE, 6);
 	gtk_container_add(GTK_CONTAINER(alignment), inner_box);
 
+	/* Only shown while the meter measures loudness */
+	loudness = g_object_new(GTK_TYPE_LABEL,
+	                        "width-chars", WIDGET_LOUDNESS_WIDTH_IN_CHARS,
+	                        "xalign", 1.0f,
+	                        "has-tooltip", TRUE,
+	                        NULL);
+	gtk_widget_set_no_show_all(loudness, TRUE);
+	gtk_box_pack_start(GTK_BOX(inner_box), loudness, FALSE, FALSE, 0);
+	g_signal_connect(loudness, "query-tooltip", G_CALLBACK(pama_source_widget_loudness_query_tooltip), widget);
+	priv->loudness = loudness;
+
+	/* Only shown when latency is polled */
+	latency = g_object_new(GTK_TYPE_LABEL,
+	                       "width-chars", WIDGET_LATENCY_WIDTH_IN_CHARS,
+	                       "xalign", 1.0f,
+	                       "has-tooltip", TRUE,
+	                       NULL);
+	gtk_widget_set_no_show_all(latency, 0 == pama_latency_poll_get_interval());
+	gtk_box_pack_start(GTK_BOX(inner_box), latency, FALSE, FALSE, 0);
+	g_signal_connect(latency, "query-tooltip", G_CALLBACK(pama_source_widget_latency_query_tooltip), widget);
+	priv->latency = latency;
+
 	value = g_object_new(GTK_TYPE_LABEL,
 	                     "width-chars", WIDGET_VALUE_WIDTH_IN_CHARS,
 	                     "xalign", 1.0f,
@@ -220,6 +292,12 @@ static GObject* pama_source_widget_constructor(GType gtype, guint n_properties,
 	gtk_box_pack_start(GTK_BOX(inner_box), value, FALSE, FALSE, 0);
 	priv->value = value;
 
+	spectrum = gtk_button_new();
+	gtk_widget_set_tooltip_text(GTK_WIDGET(spectrum), _("Show the frequencies picked up by this device"));
+	gtk_container_add(GTK_CONTAINER(spectrum), gtk_image_new_from_icon_name("utilities-system-monitor", GTK_ICON_SIZE_MENU));
+	gtk_box_pack_start(GTK_BOX(inner_box), spectrum, FALSE, FALSE, 0);
+	priv->spectrum = spectrum;
+
 	mute = gtk_check_button_new();
 	gtk_toggle_button_set_mode(GTK_TOGGLE_BUTTON(mute), FALSE);
 	gtk_widget_set_tooltip_text(GTK_WIDGET(mute), _("Mute audio input from this device"));
@@ -244,11 +322,17 @@ static GObject* pama_source_widget_constructor(GType gtype, guint n_properties,
 	pama_source_widget_update_values(widget);
 
 	g_signal_connect(volume,         "value-changed", G_CALLBACK(pama_source_widget_volume_changed),  widget);
+	g_signal_connect(balance,        "value-changed", G_CALLBACK(pama_source_widget_balance_changed), widget);
 	g_signal_connect(mute,           "toggled",       G_CALLBACK(pama_source_widget_mute_toggled),    widget);
+	g_signal_connect(spectrum,       "clicked",       G_CALLBACK(pama_source_widget_spectrum_clicked), widget);
 	g_signal_connect(default_source, "toggled",       G_CALLBACK(pama_source_widget_default_toggled), widget);
 
 	priv->source_notify_handler_id  = g_signal_connect(priv->source,  "notify::volume",            G_CALLBACK(pama_source_widget_source_notify),     widget);
+	priv->latency_notify_handler_id = g_signal_connect(priv->source, "notify::latency", G_CALLBACK(pama_source_widget_latency_notify), widget);
+	pama_source_widget_latency_notify(G_OBJECT(priv->source), NULL, widget);
 	priv->context_notify_handler_id = g_signal_connect(priv->context, "notify::default-source-name", G_CALLBACK(pama_source_widget_context_notify),  widget);
+	g_signal_connect(widget, "map",   G_CALLBACK(pama_source_widget_map),   NULL);
+	g_signal_connect(widget, "unmap", G_CALLBACK(pama_source_widget_unmap), NULL);
 
 	priv->group = NULL; /* don't need it for anything else */
 
@@ -263,6 +347,14 @@ static void pama_source_widget_dispose(GObject *gobject)
 	PamaSourceWidget *widget = PAMA_SOURCE_WIDGET(gobject);
 	PamaSourceWidgetPrivate *priv = PAMA_SOURCE_WIDGET_GET_PRIVATE(widget);
 
+	pama_source_widget_stop_meter(widget);
+
+	if (priv->spectrum_window)
+	{
+		g_object_remove_weak_pointer(G_OBJECT(priv->spectrum_window), (gpointer *)&priv->spectrum_window);
+		priv->spectrum_window = NULL;
+	}
+
 	if (priv->source)
 	{
 		if (priv->source_notify_handler_id)
@@ -270,6 +362,13 @@ static void pama_source_widget_dispose(GObject *gobject)
 			g_signal_handler_disconnect(priv->source, priv->source_notify_handler_id);
 			priv->source_notify_handler_id = 0;
 		}
+		if (priv->latency_notify_handler_id)
+		{
+			g_signal_handler_disconnect(priv->source, priv->latency_notify_handler_id);
+			priv->latency_notify_handler_id = 0;
+		}
+
+		pama_source_widget_set_polling(widget, FALSE);
 
 		g_object_weak_unref(G_OBJECT(priv->source), pama_source_widget_weak_ref_notify, widget);
 		priv->source = NULL;
@@ -314,9 +413,172 @@ static void pama_source_widget_weak_ref_notify(gpointer data, GObject *where_the
 static void pama_source_widget_source_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
 {
 	PamaSourceWidget *widget = data;
+	PamaSourceWidgetPrivate *priv = PAMA_SOURCE_WIDGET_GET_PRIVATE(widget);
+
+	/* Hidden widgets, such as those in a collapsed group, catch up when they are shown */
+	if (!GTK_WIDGET_MAPPED(widget))
+	{
+		priv->dirty = TRUE;
+		return;
+	}
+
+	pama_source_widget_update_values(widget);
+	g_signal_emit(widget, widget_signals[REORDER_REQUEST_SIGNAL], 0);
+}
+static void pama_source_widget_map(GtkWidget *gtk_widget, gpointer data)
+{
+	PamaSourceWidget *widget = PAMA_SOURCE_WIDGET(gtk_widget);
+	PamaSourceWidgetPrivate *priv = PAMA_SOURCE_WIDGET_GET_PRIVATE(widget);
+
+	pama_source_widget_start_meter(widget);
+	pama_source_widget_set_polling(widget, TRUE);
+
+	if (!priv->dirty)
+		return;
+
+	priv->dirty = FALSE;
 	pama_source_widget_update_values(widget);
 	g_signal_emit(widget, widget_signals[REORDER_REQUEST_SIGNAL], 0);
 }
+static void pama_source_widget_unmap(GtkWidget *gtk_widget, gpointer data)
+{
+	pama_source_widget_stop_meter(PAMA_SOURCE_WIDGET(gtk_widget));
+	pama_source_widget_set_polling(PAMA_SOURCE_WIDGET(gtk_widget), FALSE);
+}
+static void pama_source_widget_start_meter(PamaSourceWidget *widget)
+{
+	PamaSourceWidgetPrivate *priv = PAMA_SOURCE_WIDGET_GET_PRIVATE(widget);
+
+	if (priv->meter || !priv->source || !priv->context)
+		return;
+
+	priv->meter = pama_pulse_meter_new(priv->context, priv->source);
+	pama_meter_clock_add(GTK_PROGRESS_BAR(priv->level));
+	g_signal_connect(priv->meter, "notify::level", G_CALLBACK(pama_source_widget_level_notify), widget);
+	g_signal_connect(priv->meter, "notify::clipping", G_CALLBACK(pama_source_widget_clipping_notify), widget);
+	pama_source_widget_clipping_notify(G_OBJECT(priv->meter), NULL, widget);
+
+	if (pama_pulse_meter_get_measures_loudness(priv->meter))
+	{
+		g_signal_connect(priv->meter, "notify::momentary", G_CALLBACK(pama_source_widget_loudness_notify), widget);
+		pama_source_widget_loudness_notify(G_OBJECT(priv->meter), NULL, widget);
+		gtk_widget_show(priv->loudness);
+	}
+}
+static void pama_source_widget_stop_meter(PamaSourceWidget *widget)
+{
+	PamaSourceWidgetPrivate *priv = PAMA_SOURCE_WIDGET_GET_PRIVATE(widget);
+
+	if (NULL == priv->meter)
+		return;
+
+	g_signal_handlers_disconnect_by_func(priv->meter, pama_source_widget_level_notify,    widget);
+	g_signal_handlers_disconnect_by_func(priv->meter, pama_source_widget_clipping_notify, widget);
+	g_signal_handlers_disconnect_by_func(priv->meter, pama_source_widget_loudness_notify, widget);
+	g_object_unref(priv->meter);
+	priv->meter = NULL;
+
+	pama_meter_clock_remove(GTK_PROGRESS_BAR(priv->level));
+	gtk_widget_hide(priv->loudness);
+}
+static void pama_source_widget_level_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
+{
+	PamaSourceWidgetPrivate *priv = PAMA_SOURCE_WIDGET_GET_PRIVATE(data);
+
+	pama_meter_clock_push(GTK_PROGRESS_BAR(priv->level), pama_pulse_meter_get_level(PAMA_PULSE_METER(gobject)));
+}
+// Names of rows that clipped lately stand out until the clipping has aged out
+// of the history. The history itself outlives the meter.
+static void pama_source_widget_clipping_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
+{
+	PamaSourceWidgetPrivate *priv = PAMA_SOURCE_WIDGET_GET_PRIVATE(data);
+	GdkColor color;
+
+	if (pama_pulse_meter_get_clipping(PAMA_PULSE_METER(gobject)) && gdk_color_parse(WIDGET_CLIP_COLOR, &color))
+		gtk_widget_modify_fg(priv->name, GTK_STATE_NORMAL, &color);
+	else
+		gtk_widget_modify_fg(priv->name, GTK_STATE_NORMAL, NULL);
+}
+static void pama_source_widget_loudness_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
+{
+	PamaSourceWidgetPrivate *priv = PAMA_SOURCE_WIDGET_GET_PRIVATE(data);
+	gdouble momentary = pama_pulse_meter_get_momentary(PAMA_PULSE_METER(gobject));
+	gchar  *temp;
+
+	/* Anything quieter than the absolute gate of EBU R128 counts as silence */
+	if (momentary < WIDGET_LOUDNESS_FLOOR)
+		gtk_label_set_text(GTK_LABEL(priv->loudness), "-∞ LUFS");
+	else
+	{
+		temp = g_strdup_printf("%.0f LUFS", momentary);
+		gtk_label_set_text(GTK_LABEL(priv->loudness), temp);
+		g_free(temp);
+	}
+}
+// The label changes ten times a second, so its tooltip is only built when it
+// is about to be shown.
+static gboolean pama_source_widget_loudness_query_tooltip(GtkWidget *label, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data)
+{
+	PamaSourceWidgetPrivate *priv = PAMA_SOURCE_WIDGET_GET_PRIVATE(data);
+	gchar *text;
+
+	if (NULL == priv->meter || !pama_pulse_meter_get_measures_loudness(priv->meter))
+		return FALSE;
+
+	text = g_strdup_printf(_("Momentary loudness: %.1f LUFS\nShort-term loudness: %.1f LUFS"),
+	                       MAX(pama_pulse_meter_get_momentary (priv->meter), WIDGET_LOUDNESS_FLOOR),
+	                       MAX(pama_pulse_meter_get_short_term(priv->meter), WIDGET_LOUDNESS_FLOOR));
+	gtk_tooltip_set_text(tooltip, text);
+	g_free(text);
+	return TRUE;
+}
+static void pama_source_widget_latency_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
+{
+	PamaSourceWidgetPrivate *priv = PAMA_SOURCE_WIDGET_GET_PRIVATE(data);
+	guint64 latency;
+	gchar  *temp;
+
+	g_object_get(gobject, "latency", &latency, NULL);
+
+	temp = g_strdup_printf(_("%.1f ms"), latency / 1000.0);
+	gtk_label_set_text(GTK_LABEL(priv->latency), temp);
+	g_free(temp);
+}
+// Latency is updated on every poll, so its tooltip is only built when it is
+// about to be shown.
+static gboolean pama_source_widget_latency_query_tooltip(GtkWidget *label, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data)
+{
+	PamaSourceWidgetPrivate *priv = PAMA_SOURCE_WIDGET_GET_PRIVATE(data);
+	guint64 latency, configured_latency;
+	gchar  *text;
+
+	if (NULL == priv->source)
+		return FALSE;
+
+	g_object_get(priv->source,
+	             "latency",            &latency,
+	             "configured-latency", &configured_latency,
+	             NULL);
+
+	text = g_strdup_printf(_("Latency: %.1f ms\nConfigured latency: %.1f ms"), latency / 1000.0, configured_latency / 1000.0);
+	gtk_tooltip_set_text(tooltip, text);
+	g_free(text);
+	return TRUE;
+}
+// Latency is only asked for while the row is on screen.
+static void pama_source_widget_set_polling(PamaSourceWidget *widget, gboolean polling)
+{
+	PamaSourceWidgetPrivate *priv = PAMA_SOURCE_WIDGET_GET_PRIVATE(widget);
+
+	if (polling == priv->polling || NULL == priv->source || (polling && NULL == priv->context))
+		return;
+
+	if (polling)
+		pama_latency_poll_add(priv->context, G_OBJECT(priv->source));
+	else
+		pama_latency_poll_remove(G_OBJECT(priv->source));
+	priv->polling = polling;
+}
 static void pama_source_widget_context_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
 {
 	PamaSourceWidget *widget = data;
@@ -327,19 +589,46 @@ static void pama_source_widget_context_notify(GObject *gobject, GParamSpec *pspe
 	priv->updating = FALSE;
 }
 
+// Names are ellipsized, so their tooltip shows the whole label. It is only
+// built when the tooltip is about to be shown.
+static gboolean pama_source_widget_name_query_tooltip(GtkWidget *label, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer data)
+{
+	PamaSourceWidgetPrivate *priv = PAMA_SOURCE_WIDGET_GET_PRIVATE(data);
+	gchar *clipping, *markup;
+
+	clipping = pama_clip_history_describe(G_OBJECT(priv->source));
+
+	if (NULL == clipping)
+	{
+		gtk_tooltip_set_markup(tooltip, gtk_label_get_label(GTK_LABEL(label)));
+		return TRUE;
+	}
+
+	markup = g_markup_escape_text(clipping, -1);
+	g_free(clipping);
+	clipping = g_strdup_printf("%s\n<span foreground=\"%s\">%s</span>", gtk_label_get_label(GTK_LABEL(label)), WIDGET_CLIP_COLOR, markup);
+	gtk_tooltip_set_markup(tooltip, clipping);
+	g_free(clipping);
+	g_free(markup);
+	return TRUE;
+}
+
 static void pama_source_widget_update_values(PamaSourceWidget *widget)
 {
 	PamaSourceWidgetPrivate *priv = PAMA_SOURCE_WIDGET_GET_PRIVATE(widget);
 	gchar         *temp;
 	gchar         *description, *hostname;
 	guint          volume, base_volume;
-	double         volume_dB, base_volume_dB;
+	double         volume_dB;
 	gboolean       mute;
 	PamaPulseSink *monitored_sink;
 	gboolean       network;
 	gboolean       decibel_volume;
 	GIcon         *icon;
 
+	const pa_cvolume     *cvolume;
+	const pa_channel_map *channel_map;
+
 	priv->updating = TRUE;
 
 	g_object_get(priv->source,
@@ -369,33 +658,29 @@ static void pama_source_widget_update_values(PamaSourceWidget *widget)
 	}
 
 	icon = pama_pulse_source_build_gicon(priv->source);
-	g_object_set(priv->icon,
-	             "gicon", icon,
-	             "pixel-size", 32,
-	             NULL);
+	pama_icon_cache_set_image(GTK_IMAGE(priv->icon), icon, WIDGET_ICON_SIZE);
 	g_object_unref(icon);
+	pama_activity_badge_set(priv->icon, pama_pulse_source_is_running(priv->source));
 
 	if (network)
 		temp = g_markup_printf_escaped("<b>%s</b>\nOn %s", description, hostname);
 	else
 		temp = g_markup_printf_escaped("<b>%s</b>", description);
 	gtk_label_set_markup(GTK_LABEL(priv->name), temp);
-	gtk_widget_set_tooltip_markup(GTK_WIDGET(priv->name), temp);
 	g_free(temp);
 	g_free(description);
 
 	if (decibel_volume)
 	{
-		volume_dB = pa_sw_volume_to_dB(volume);
-		base_volume_dB = pa_sw_volume_to_dB(base_volume);
+		volume_dB = pama_volume_map_to_dB(volume);
 
 		gtk_scale_clear_marks(GTK_SCALE(priv->volume));
 		
 		temp = g_markup_printf_escaped("<span size='smaller'>%s</span>", _("Normal"));
-		gtk_scale_add_mark(GTK_SCALE(priv->volume), WIDGET_VOLUME_SLIDER_DB_RANGE + base_volume_dB, GTK_POS_BOTTOM, temp);
+		gtk_scale_add_mark(GTK_SCALE(priv->volume), pama_volume_map_to_slider(base_volume), GTK_POS_BOTTOM, temp);
 		g_free(temp);
 
-		gtk_range_set_value(GTK_RANGE(priv->volume), WIDGET_VOLUME_SLIDER_DB_RANGE + volume_dB);
+		gtk_range_set_value(GTK_RANGE(priv->volume), pama_volume_map_to_slider(volume));
 
 		if (isinf(volume_dB))
 			temp = g_strdup("-∞dB");
@@ -424,6 +709,17 @@ static void pama_source_widget_update_values(PamaSourceWidget *widget)
 	gtk_widget_set_sensitive(priv->volume, !mute);
 	gtk_widget_set_sensitive(priv->value,  !mute);
 
+	cvolume     = pama_pulse_source_get_cvolume(priv->source);
+	channel_map = pama_pulse_source_get_channel_map(priv->source);
+	if (pa_channel_map_can_balance(channel_map))
+	{
+		gtk_range_set_value(GTK_RANGE(priv->balance), pa_cvolume_get_balance(cvolume, channel_map));
+		gtk_widget_show(priv->balance);
+	}
+	else
+		gtk_widget_hide(priv->balance);
+	gtk_widget_set_sensitive(priv->balance, !mute);
+
 	priv->updating = FALSE;
 }
 
@@ -447,6 +743,20 @@ static void pama_source_widget_mute_toggled   (GtkToggleButton *togglebutton, gp
 
 	pama_pulse_source_set_mute(priv->source, gtk_toggle_button_get_active(togglebutton));
 }
+static void pama_source_widget_spectrum_clicked(GtkButton *button, gpointer data)
+{
+	PamaSourceWidget *widget = data;
+	PamaSourceWidgetPrivate *priv = PAMA_SOURCE_WIDGET_GET_PRIVATE(widget);
+
+	if (NULL == priv->spectrum_window)
+	{
+		priv->spectrum_window = pama_spectrum_window_new(priv->context, priv->source);
+		g_object_add_weak_pointer(G_OBJECT(priv->spectrum_window), (gpointer *)&priv->spectrum_window);
+		gtk_widget_show_all(priv->spectrum_window);
+	}
+
+	gtk_window_present(GTK_WINDOW(priv->spectrum_window));
+}
 static void pama_source_widget_volume_changed (GtkRange *range, gpointer data)
 {
 	PamaSourceWidget *widget = data;
@@ -460,12 +770,22 @@ static void pama_source_widget_volume_changed (GtkRange *range, gpointer data)
 	g_object_get(priv->source, "decibel-volume", &decibel_volume, NULL);
 
 	if (decibel_volume)
-		new_volume = pa_sw_volume_from_dB(gtk_range_get_value(range) - WIDGET_VOLUME_SLIDER_DB_RANGE);
+		new_volume = pama_volume_map_from_slider(gtk_range_get_value(range));
 	else
 		new_volume = gtk_range_get_value(range) * PA_VOLUME_NORM / 100;
 
 	pama_pulse_source_set_volume(priv->source, new_volume);
 }
+static void pama_source_widget_balance_changed(GtkRange *range, gpointer data)
+{
+	PamaSourceWidget *widget = data;
+	PamaSourceWidgetPrivate *priv = PAMA_SOURCE_WIDGET_GET_PRIVATE(widget);
+
+	if (priv->updating)
+		return;
+
+	pama_pulse_source_set_balance(priv->source, gtk_range_get_value(range));
+}
 
 
 gint pama_source_widget_compare(gconstpointer a, gconstpointer b)
@@ -0,0 +1,354 @@
+/*
+ * pama-spectrum-window.c: A window showing the frequency content of a device
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+ 
+#include <math.h>
+#include "pama-spectrum-window.h"
+#include "pama-pulse-spectrum.h"
+#include "widget-settings.h"
+
+static void     pama_spectrum_window_class_init(PamaSpectrumWindowClass *klass);
+static void     pama_spectrum_window_init(PamaSpectrumWindow *window);
+static void     pama_spectrum_window_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec);
+static GObject* pama_spectrum_window_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties);
+static void     pama_spectrum_window_dispose(GObject *gobject);
+static void     pama_spectrum_window_weak_ref_notify(gpointer data, GObject *where_the_object_was);
+
+static void     pama_spectrum_window_map(GtkWidget *gtk_widget, gpointer data);
+static void     pama_spectrum_window_unmap(GtkWidget *gtk_widget, gpointer data);
+static void     pama_spectrum_window_start(PamaSpectrumWindow *window);
+static void     pama_spectrum_window_stop (PamaSpectrumWindow *window);
+static void     pama_spectrum_window_changed(PamaPulseSpectrum *spectrum, gpointer data);
+static void     pama_spectrum_window_load_notify(GObject *gobject, GParamSpec *pspec, gpointer data);
+static gboolean pama_spectrum_window_expose(GtkWidget *area, GdkEventExpose *event, gpointer data);
+
+struct _PamaSpectrumWindowPrivate
+{
+	GtkWidget         *area, *load;
+	PamaPulseContext  *context;
+	PamaPulseSource   *source;
+	PamaPulseSpectrum *spectrum;
+};
+
+G_DEFINE_TYPE(PamaSpectrumWindow, pama_spectrum_window, GTK_TYPE_WINDOW);
+#define PAMA_SPECTRUM_WINDOW_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE((obj), PAMA_TYPE_SPECTRUM_WINDOW, PamaSpectrumWindowPrivate))
+
+
+enum 
+{
+	PROP_0,
+
+	PROP_SOURCE,
+	PROP_CONTEXT
+};
+
+static void pama_spectrum_window_class_init(PamaSpectrumWindowClass *klass)
+{
+	GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+	GParamSpec *pspec;
+
+	gobject_class->set_property = pama_spectrum_window_set_property;
+	gobject_class->constructor  = pama_spectrum_window_constructor;
+	gobject_class->dispose      = pama_spectrum_window_dispose;
+
+	pspec = g_param_spec_object("source",
+	                            "Pulse source",
+	                            "The PamaPulseSource to analyse; for a sink, its monitor.",
+	                            PAMA_TYPE_PULSE_SOURCE,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_SOURCE, pspec);
+
+	pspec = g_param_spec_object("context",
+	                            "Pulse context",
+	                            "The PamaPulseContext that is managing the current connection.",
+	                            PAMA_TYPE_PULSE_CONTEXT,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_CONTEXT, pspec);
+
+	g_type_class_add_private(klass, sizeof(PamaSpectrumWindowPrivate));
+}
+
+static void pama_spectrum_window_init(PamaSpectrumWindow *window)
+{
+}
+
+static void pama_spectrum_window_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec)
+{
+	PamaSpectrumWindow *window = PAMA_SPECTRUM_WINDOW(gobject);
+	PamaSpectrumWindowPrivate *priv = PAMA_SPECTRUM_WINDOW_GET_PRIVATE(window);
+
+	switch(property_id)
+	{
+		case PROP_SOURCE:
+			priv->source = g_value_get_object(value);
+			g_object_weak_ref(G_OBJECT(priv->source), pama_spectrum_window_weak_ref_notify, window);
+			break;
+
+		case PROP_CONTEXT:
+			priv->context = g_value_get_object(value);
+			g_object_weak_ref(G_OBJECT(priv->context), pama_spectrum_window_weak_ref_notify, window);
+			break;
+
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
+			break;
+	}
+}
+static GObject* pama_spectrum_window_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties)
+{
+	GtkWidget *vbox, *area, *load;
+	gchar     *description;
+
+	GObject *gobject = G_OBJECT_CLASS(pama_spectrum_window_parent_class)->constructor(gtype, n_properties, properties);
+	PamaSpectrumWindow *window = PAMA_SPECTRUM_WINDOW(gobject);
+	PamaSpectrumWindowPrivate *priv = PAMA_SPECTRUM_WINDOW_GET_PRIVATE(window);
+
+	if (NULL == priv->source)
+		g_error("An attempt was made to create a spectrum window with no source.");
+	if (NULL == priv->context)
+		g_error("An attempt was made to create a spectrum window with no context.");
+
+	g_object_get(priv->source,
+	             "description", &description,
+	             NULL);
+	gtk_window_set_title(GTK_WINDOW(window), description);
+	g_free(description);
+
+	gtk_window_set_icon_name(GTK_WINDOW(window), "multimedia-volume-control");
+	gtk_container_set_border_width(GTK_CONTAINER(window), 6);
+
+	vbox = gtk_vbox_new(FALSE, 6);
+	gtk_container_add(GTK_CONTAINER(window), vbox);
+
+	area = gtk_drawing_area_new();
+	gtk_widget_set_size_request(area, WIDGET_SPECTRUM_WIDTH, WIDGET_SPECTRUM_HEIGHT);
+	gtk_box_pack_start(GTK_BOX(vbox), area, TRUE, TRUE, 0);
+	priv->area = area;
+
+	load = g_object_new(GTK_TYPE_LABEL,
+	                    "xalign", 0.0f,
+	                    NULL);
+	gtk_box_pack_start(GTK_BOX(vbox), load, FALSE, FALSE, 0);
+	priv->load = load;
+
+	g_signal_connect(area,   "expose-event", G_CALLBACK(pama_spectrum_window_expose), window);
+	g_signal_connect(window, "map",          G_CALLBACK(pama_spectrum_window_map),    NULL);
+	g_signal_connect(window, "unmap",        G_CALLBACK(pama_spectrum_window_unmap),  NULL);
+
+	return gobject;
+}
+static void pama_spectrum_window_dispose(GObject *gobject)
+{
+	PamaSpectrumWindow *window = PAMA_SPECTRUM_WINDOW(gobject);
+	PamaSpectrumWindowPrivate *priv = PAMA_SPECTRUM_WINDOW_GET_PRIVATE(window);
+
+	pama_spectrum_window_stop(window);
+
+	if (priv->source)
+	{
+		g_object_weak_unref(G_OBJECT(priv->source), pama_spectrum_window_weak_ref_notify, window);
+		priv->source = NULL;
+	}
+
+	if (priv->context)
+	{
+		g_object_weak_unref(G_OBJECT(priv->context), pama_spectrum_window_weak_ref_notify, window);
+		priv->context = NULL;
+	}
+
+	G_OBJECT_CLASS(pama_spectrum_window_parent_class)->dispose(gobject);
+}
+static void pama_spectrum_window_weak_ref_notify(gpointer data, GObject *where_the_object_was)
+{
+	PamaSpectrumWindow *window = data;
+	PamaSpectrumWindowPrivate *priv = PAMA_SPECTRUM_WINDOW_GET_PRIVATE(window);
+
+	if ((GObject *)priv->source  == where_the_object_was)
+		priv->source = NULL;
+
+	if ((GObject *)priv->context == where_the_object_was)
+		priv->context = NULL;
+
+	/* window is no longer usable without these items. */
+	gtk_object_destroy(GTK_OBJECT(window));
+}
+
+
+// The recording only runs while the window is on screen; closing the window
+// destroys it, and with it everything the analysis allocated.
+static void pama_spectrum_window_map(GtkWidget *gtk_widget, gpointer data)
+{
+	pama_spectrum_window_start(PAMA_SPECTRUM_WINDOW(gtk_widget));
+}
+static void pama_spectrum_window_unmap(GtkWidget *gtk_widget, gpointer data)
+{
+	pama_spectrum_window_stop(PAMA_SPECTRUM_WINDOW(gtk_widget));
+}
+static void pama_spectrum_window_start(PamaSpectrumWindow *window)
+{
+	PamaSpectrumWindowPrivate *priv = PAMA_SPECTRUM_WINDOW_GET_PRIVATE(window);
+
+	if (priv->spectrum || NULL == priv->source)
+		return;
+
+	priv->spectrum = pama_pulse_spectrum_new(priv->context, priv->source);
+	g_signal_connect(priv->spectrum, "changed",      G_CALLBACK(pama_spectrum_window_changed),     window);
+	g_signal_connect(priv->spectrum, "notify::load", G_CALLBACK(pama_spectrum_window_load_notify), window);
+	pama_spectrum_window_load_notify(G_OBJECT(priv->spectrum), NULL, window);
+}
+static void pama_spectrum_window_stop(PamaSpectrumWindow *window)
+{
+	PamaSpectrumWindowPrivate *priv = PAMA_SPECTRUM_WINDOW_GET_PRIVATE(window);
+
+	if (NULL == priv->spectrum)
+		return;
+
+	g_signal_handlers_disconnect_by_func(priv->spectrum, pama_spectrum_window_changed,     window);
+	g_signal_handlers_disconnect_by_func(priv->spectrum, pama_spectrum_window_load_notify, window);
+	g_object_unref(priv->spectrum);
+	priv->spectrum = NULL;
+}
+static void pama_spectrum_window_changed(PamaPulseSpectrum *spectrum, gpointer data)
+{
+	PamaSpectrumWindowPrivate *priv = PAMA_SPECTRUM_WINDOW_GET_PRIVATE(data);
+
+	gtk_widget_queue_draw(priv->area);
+}
+static void pama_spectrum_window_load_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
+{
+	PamaSpectrumWindowPrivate *priv = PAMA_SPECTRUM_WINDOW_GET_PRIVATE(data);
+	gchar *text;
+
+	text = g_strdup_printf(_("Analysis uses %.1f%% of a CPU"), 100.0 * pama_pulse_spectrum_get_load(PAMA_PULSE_SPECTRUM(gobject)));
+	gtk_label_set_text(GTK_LABEL(priv->load), text);
+	g_free(text);
+}
+
+
+// Frequencies run logarithmically from WIDGET_SPECTRUM_MIN_FREQUENCY to half
+// the rate, and levels linearly from 0dB at the top to WIDGET_SPECTRUM_FLOOR
+// at the bottom. Several bins share a column at the top end, and the loudest
+// of them is drawn so that narrow peaks are not lost.
+static gboolean pama_spectrum_window_expose(GtkWidget *area, GdkEventExpose *event, gpointer data)
+{
+	PamaSpectrumWindowPrivate *priv = PAMA_SPECTRUM_WINDOW_GET_PRIVATE(data);
+	static const gdouble grid_frequencies[] = { 100.0, 1000.0, 10000.0 };
+	gint width  = area->allocation.width;
+	gint height = area->allocation.height;
+	const gfloat *levels;
+	guint n_levels, first, last, i;
+	gdouble max_frequency, ratio, bin_width, level, frequency, x, y;
+	gchar *text;
+	PangoLayout *layout;
+	cairo_t *cr;
+	gint column;
+
+	cr = gdk_cairo_create(area->window);
+	gdk_cairo_region(cr, event->region);
+	cairo_clip(cr);
+
+	gdk_cairo_set_source_color(cr, &area->style->base[GTK_STATE_NORMAL]);
+	cairo_paint(cr);
+
+	max_frequency = priv->spectrum ? pama_pulse_spectrum_get_rate(priv->spectrum) / 2.0 : 0.0;
+	if (max_frequency <= WIDGET_SPECTRUM_MIN_FREQUENCY || width <= 0)
+	{
+		cairo_destroy(cr);
+		return FALSE;
+	}
+	ratio = log(max_frequency / WIDGET_SPECTRUM_MIN_FREQUENCY);
+
+	levels = pama_pulse_spectrum_get_levels(priv->spectrum, &n_levels);
+	bin_width = max_frequency / (n_levels - 1);
+
+	/* the curve, filled down to the bottom edge */
+	cairo_move_to(cr, 0, height);
+	for (column = 0; column < width; column++)
+	{
+		first = WIDGET_SPECTRUM_MIN_FREQUENCY * exp(ratio * column       / width) / bin_width;
+		last  = WIDGET_SPECTRUM_MIN_FREQUENCY * exp(ratio * (column + 1) / width) / bin_width;
+		last  = CLAMP(last, first, n_levels - 1);
+
+		level = WIDGET_SPECTRUM_FLOOR;
+		for (i = first; i <= last; i++)
+			level = MAX(level, levels[i]);
+
+		cairo_line_to(cr, column + 0.5, height * MIN(level, 0.0) / WIDGET_SPECTRUM_FLOOR);
+	}
+	cairo_line_to(cr, width, height);
+	cairo_close_path(cr);
+	gdk_cairo_set_source_color(cr, &area->style->bg[GTK_STATE_SELECTED]);
+	cairo_fill(cr);
+
+	/* grid, every decade and every 20dB */
+	layout = gtk_widget_create_pango_layout(area, NULL);
+	gdk_cairo_set_source_color(cr, &area->style->text_aa[GTK_STATE_NORMAL]);
+	cairo_set_line_width(cr, 1.0);
+
+	for (i = 0; i < G_N_ELEMENTS(grid_frequencies); i++)
+	{
+		frequency = grid_frequencies[i];
+		if (frequency >= max_frequency)
+			break;
+
+		x = floor(width * log(frequency / WIDGET_SPECTRUM_MIN_FREQUENCY) / ratio) + 0.5;
+		cairo_move_to(cr, x, 0);
+		cairo_line_to(cr, x, height);
+		cairo_stroke(cr);
+
+		text = frequency < 1000.0 ? g_strdup_printf(_("%.0fHz"), frequency) : g_strdup_printf(_("%.0fkHz"), frequency / 1000.0);
+		pango_layout_set_text(layout, text, -1);
+		cairo_move_to(cr, x + 2, 0);
+		pango_cairo_show_layout(cr, layout);
+		g_free(text);
+	}
+
+	for (level = -20.0; level > WIDGET_SPECTRUM_FLOOR; level -= 20.0)
+	{
+		y = floor(height * level / WIDGET_SPECTRUM_FLOOR) + 0.5;
+		cairo_move_to(cr, 0, y);
+		cairo_line_to(cr, width, y);
+		cairo_stroke(cr);
+
+		text = g_strdup_printf(_("%.0fdB"), level);
+		pango_layout_set_text(layout, text, -1);
+		cairo_move_to(cr, 2, y);
+		pango_cairo_show_layout(cr, layout);
+		g_free(text);
+	}
+
+	g_object_unref(layout);
+	cairo_destroy(cr);
+	return FALSE;
+}
+
+
+GtkWidget *pama_spectrum_window_new(PamaPulseContext *context, PamaPulseSource *source)
+{
+	return g_object_new(PAMA_TYPE_SPECTRUM_WINDOW,
+	                    "context", context,
+	                    "source", source,
+	                    NULL);
+}
@@ -0,0 +1,60 @@
+/*
+ * pama-spectrum-window.h: A window showing the frequency content of a device
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_SPECTRUM_WINDOW_H
+#define PAMA_SPECTRUM_WINDOW_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+#include <pulse/pulseaudio.h>
+#include "pama-pulse-context.h"
+
+G_BEGIN_DECLS
+
+#define PAMA_TYPE_SPECTRUM_WINDOW                  (pama_spectrum_window_get_type ())
+#define PAMA_SPECTRUM_WINDOW(obj)                  (G_TYPE_CHECK_INSTANCE_CAST ((obj), PAMA_TYPE_SPECTRUM_WINDOW, PamaSpectrumWindow))
+#define PAMA_IS_SPECTRUM_WINDOW(obj)               (G_TYPE_CHECK_INSTANCE_TYPE ((obj), PAMA_TYPE_SPECTRUM_WINDOW))
+#define PAMA_SPECTRUM_WINDOW_CLASS(klass)          (G_TYPE_CHECK_CLASS_CAST ((klass), PAMA_TYPE_SPECTRUM_WINDOW, PamaSpectrumWindowClass))
+#define PAMA_IS_SPECTRUM_WINDOW_CLASS(klass)       (G_TYPE_CHECK_CLASS_TYPE ((klass), PAMA_TYPE_SPECTRUM_WINDOW))
+#define PAMA_SPECTRUM_WINDOW_GET_CLASS(obj)        (G_TYPE_INSTANCE_GET_CLASS ((obj), PAMA_TYPE_SPECTRUM_WINDOW, PamaSpectrumWindowClass))
+
+typedef struct _PamaSpectrumWindow        PamaSpectrumWindow;
+typedef struct _PamaSpectrumWindowClass   PamaSpectrumWindowClass;
+typedef struct _PamaSpectrumWindowPrivate PamaSpectrumWindowPrivate;
+
+struct _PamaSpectrumWindow
+{
+	GtkWindow parent_instance;
+};
+
+struct _PamaSpectrumWindowClass
+{
+	GtkWindowClass parent_class;
+};
+
+GType pama_spectrum_window_get_type();
+
+/* methods */
+GtkWidget *pama_spectrum_window_new(PamaPulseContext *context, PamaPulseSource *source);
+
+G_END_DECLS
+
+#endif /* PAMA_SPECTRUM_WINDOW_H */
@@ -0,0 +1,634 @@
+/*
+ * pama-stream-index.c: A casefolded prefix index over the streams of a context, for filtering
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <string.h>
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include "pama-stream-index.h"
+
+/* Every prefix of every word of the client name, stream name, application ID
+ * and host name of a stream is a key of the token table, mapping to the set of
+ * streams that contain it. A query then costs one lookup per query word plus
+ * an intersection, and an update only touches the stream that changed. */
+
+typedef struct
+{
+	PamaStreamIndex *owner;
+	GObject         *stream;
+	PamaPulseClient *client;
+	GPtrArray       *tokens;
+	gchar           *text; /* what the tokens were made from */
+
+	gulong stream_notify_handler_id;
+	gulong client_notify_handler_id;
+} PamaStreamIndexEntry;
+
+static void     pama_stream_index_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec);
+static GObject* pama_stream_index_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties);
+static void     pama_stream_index_dispose(GObject *gobject);
+static void     pama_stream_index_finalize(GObject *gobject);
+static void     pama_stream_index_weak_ref_notify(gpointer data, GObject *where_the_object_was);
+
+static void     pama_stream_index_stream_added(PamaPulseContext *context, guint index, gpointer data);
+static void     pama_stream_index_stream_removed(PamaPulseContext *context, guint index, gpointer data);
+static void     pama_stream_index_stream_notify(GObject *gobject, GParamSpec *pspec, gpointer data);
+static void     pama_stream_index_client_notify(GObject *gobject, GParamSpec *pspec, gpointer data);
+
+static void     pama_stream_index_add_stream(PamaStreamIndex *stream_index, GObject *stream);
+static void     pama_stream_index_entry_free(gpointer data);
+static gchar   *pama_stream_index_entry_build_text(PamaStreamIndexEntry *entry);
+static void     pama_stream_index_entry_index(PamaStreamIndex *stream_index, PamaStreamIndexEntry *entry);
+static void     pama_stream_index_entry_unindex(PamaStreamIndex *stream_index, PamaStreamIndexEntry *entry);
+static void     pama_stream_index_update_matches(PamaStreamIndex *stream_index);
+
+struct _PamaStreamIndexPrivate
+{
+	PamaPulseContext *context;
+	GType             stream_type;
+
+	/* stream index -> PamaStreamIndexEntry */
+	GHashTable *entries;
+	/* token prefix -> set of PamaStreamIndexEntry */
+	GHashTable *tokens;
+
+	/* casefolded words of the current query, and the streams matching all of them */
+	GPtrArray  *query;
+	GHashTable *matches;
+
+	gulong added_handler_id;
+	gulong removed_handler_id;
+};
+
+G_DEFINE_TYPE(PamaStreamIndex, pama_stream_index, G_TYPE_OBJECT);
+#define PAMA_STREAM_INDEX_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE((obj), PAMA_TYPE_STREAM_INDEX, PamaStreamIndexPrivate))
+
+enum
+{
+	PROP_0,
+
+	PROP_CONTEXT,
+	PROP_STREAM_TYPE
+};
+
+enum
+{
+	CHANGED_SIGNAL,
+	LAST_SIGNAL
+};
+static guint index_signals[LAST_SIGNAL] = {0,};
+
+static void pama_stream_index_class_init(PamaStreamIndexClass *klass)
+{
+	GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+	GParamSpec *pspec;
+
+	gobject_class->set_property = pama_stream_index_set_property;
+	gobject_class->constructor  = pama_stream_index_constructor;
+	gobject_class->dispose      = pama_stream_index_dispose;
+	gobject_class->finalize     = pama_stream_index_finalize;
+
+	pspec = g_param_spec_object("context",
+	                            "Pulse context object",
+	                            "The PamaPulseContext whose streams are indexed.",
+	                            PAMA_TYPE_PULSE_CONTEXT,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_CONTEXT, pspec);
+
+	pspec = g_param_spec_gtype("stream-type",
+	                           "Stream type",
+	                           "Either PAMA_TYPE_PULSE_SINK_INPUT or PAMA_TYPE_PULSE_SOURCE_OUTPUT.",
+	                           G_TYPE_OBJECT,
+	                           G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_STREAM_TYPE, pspec);
+
+	/* Emitted whenever the set of matching streams may have changed */
+	index_signals[CHANGED_SIGNAL] =
+		g_signal_new("changed",
+		             G_TYPE_FROM_CLASS(gobject_class),
+		             G_SIGNAL_RUN_LAST,
+		             0,
+		             NULL,
+		             NULL,
+		             g_cclosure_marshal_VOID__VOID,
+		             G_TYPE_NONE,
+		             0);
+
+	g_type_class_add_private(klass, sizeof(PamaStreamIndexPrivate));
+}
+
+static void pama_stream_index_init(PamaStreamIndex *stream_index)
+{
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(stream_index);
+
+	priv->entries = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, pama_stream_index_entry_free);
+	priv->tokens  = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_hash_table_destroy);
+	priv->matches = g_hash_table_new(g_direct_hash, g_direct_equal);
+	priv->query   = g_ptr_array_new();
+}
+
+static void pama_stream_index_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec)
+{
+	PamaStreamIndex *stream_index = PAMA_STREAM_INDEX(gobject);
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(stream_index);
+
+	switch(property_id)
+	{
+		case PROP_CONTEXT:
+			priv->context = g_value_get_object(value);
+			g_object_weak_ref(G_OBJECT(priv->context), pama_stream_index_weak_ref_notify, stream_index);
+			break;
+
+		case PROP_STREAM_TYPE:
+			priv->stream_type = g_value_get_gtype(value);
+			break;
+
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
+			break;
+	}
+}
+
+static GObject* pama_stream_index_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties)
+{
+	GObject *gobject = G_OBJECT_CLASS(pama_stream_index_parent_class)->constructor(gtype, n_properties, properties);
+	PamaStreamIndex *stream_index = PAMA_STREAM_INDEX(gobject);
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(stream_index);
+	GSList *streams, *iter;
+	const gchar *added_signal, *removed_signal;
+
+	if (NULL == priv->context)
+		g_error("An attempt was made to construct a PamaStreamIndex without providing a valid PamaPulseContext.");
+
+	if (PAMA_TYPE_PULSE_SINK_INPUT == priv->stream_type)
+	{
+		streams        = pama_pulse_context_get_sink_inputs(priv->context);
+		added_signal   = "sink-input-added";
+		removed_signal = "sink-input-removed";
+	}
+	else if (PAMA_TYPE_PULSE_SOURCE_OUTPUT == priv->stream_type)
+	{
+		streams        = pama_pulse_context_get_source_outputs(priv->context);
+		added_signal   = "source-output-added";
+		removed_signal = "source-output-removed";
+	}
+	else
+	{
+		g_error("An attempt was made to construct a PamaStreamIndex for an unsupported stream type.");
+		return gobject;
+	}
+
+	for (iter = streams; iter; iter = iter->next)
+		pama_stream_index_add_stream(stream_index, G_OBJECT(iter->data));
+
+	priv->added_handler_id   = g_signal_connect(priv->context, added_signal,   G_CALLBACK(pama_stream_index_stream_added),   stream_index);
+	priv->removed_handler_id = g_signal_connect(priv->context, removed_signal, G_CALLBACK(pama_stream_index_stream_removed), stream_index);
+
+	return gobject;
+}
+static void pama_stream_index_dispose(GObject *gobject)
+{
+	PamaStreamIndex *stream_index = PAMA_STREAM_INDEX(gobject);
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(stream_index);
+
+	if (priv->context)
+	{
+		if (priv->added_handler_id)
+		{
+			g_signal_handler_disconnect(priv->context, priv->added_handler_id);
+			priv->added_handler_id = 0;
+		}
+
+		if (priv->removed_handler_id)
+		{
+			g_signal_handler_disconnect(priv->context, priv->removed_handler_id);
+			priv->removed_handler_id = 0;
+		}
+
+		g_object_weak_unref(G_OBJECT(priv->context), pama_stream_index_weak_ref_notify, stream_index);
+		priv->context = NULL;
+	}
+
+	g_hash_table_remove_all(priv->matches);
+	g_hash_table_remove_all(priv->tokens);
+	g_hash_table_remove_all(priv->entries);
+
+	G_OBJECT_CLASS(pama_stream_index_parent_class)->dispose(gobject);
+}
+static void pama_stream_index_finalize(GObject *gobject)
+{
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(gobject);
+
+	g_hash_table_destroy(priv->matches);
+	g_hash_table_destroy(priv->tokens);
+	g_hash_table_destroy(priv->entries);
+	g_ptr_array_foreach(priv->query, (GFunc) g_free, NULL);
+	g_ptr_array_free(priv->query, TRUE);
+
+	G_OBJECT_CLASS(pama_stream_index_parent_class)->finalize(gobject);
+}
+static void pama_stream_index_weak_ref_notify(gpointer data, GObject *where_the_object_was)
+{
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(data);
+
+	if ((GObject *)priv->context == where_the_object_was)
+	{
+		priv->context = NULL;
+		priv->added_handler_id = 0;
+		priv->removed_handler_id = 0;
+	}
+}
+
+
+// Splits text into casefolded words of letters and digits, appending them to tokens.
+static void pama_stream_index_tokenize(const gchar *text, GPtrArray *tokens)
+{
+	gchar *normalized, *folded;
+	const gchar *p, *start = NULL;
+
+	if (!text || !*text)
+		return;
+
+	normalized = g_utf8_normalize(text, -1, G_NORMALIZE_ALL);
+	if (!normalized)
+		return;
+
+	folded = g_utf8_casefold(normalized, -1);
+	g_free(normalized);
+
+	for (p = folded; ; p = g_utf8_next_char(p))
+	{
+		gboolean word_char = *p && g_unichar_isalnum(g_utf8_get_char(p));
+
+		if (word_char && !start)
+			start = p;
+		else if (!word_char && start)
+		{
+			g_ptr_array_add(tokens, g_strndup(start, p - start));
+			start = NULL;
+		}
+
+		if (!*p)
+			break;
+	}
+
+	g_free(folded);
+}
+
+// Returns every string the entry's tokens are made from, in one, so that
+// updates that do not change any of them can be told apart cheaply.
+static gchar *pama_stream_index_entry_build_text(PamaStreamIndexEntry *entry)
+{
+	gchar *stream_name = NULL, *client_name = NULL, *application_id = NULL, *hostname = NULL;
+	gchar *text;
+
+	g_object_get(entry->stream, "name", &stream_name, NULL);
+	if (entry->client)
+		g_object_get(entry->client,
+		             "name", &client_name,
+		             "application-id", &application_id,
+		             "hostname", &hostname,
+		             NULL);
+
+	text = g_strdup_printf("%s\n%s\n%s\n%s",
+	                       stream_name    ? stream_name    : "",
+	                       client_name    ? client_name    : "",
+	                       application_id ? application_id : "",
+	                       hostname       ? hostname       : "");
+	g_free(stream_name);
+	g_free(client_name);
+	g_free(application_id);
+	g_free(hostname);
+
+	return text;
+}
+static void pama_stream_index_entry_index(PamaStreamIndex *stream_index, PamaStreamIndexEntry *entry)
+{
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(stream_index);
+	GPtrArray *words = g_ptr_array_new();
+	gchar *stream_name = NULL, *client_name = NULL, *application_id = NULL, *hostname = NULL;
+	guint i;
+
+	g_object_get(entry->stream, "name", &stream_name, NULL);
+	pama_stream_index_tokenize(stream_name, words);
+
+	if (entry->client)
+	{
+		g_object_get(entry->client,
+		             "name", &client_name,
+		             "application-id", &application_id,
+		             "hostname", &hostname,
+		             NULL);
+		pama_stream_index_tokenize(client_name, words);
+		pama_stream_index_tokenize(application_id, words);
+		pama_stream_index_tokenize(hostname, words);
+	}
+
+	for (i = 0; i < words->len; i++)
+	{
+		const gchar *word = g_ptr_array_index(words, i);
+		const gchar *end = word;
+
+		do
+		{
+			GHashTable *set;
+			gchar *prefix;
+
+			end = g_utf8_next_char(end);
+			prefix = g_strndup(word, end - word);
+
+			set = g_hash_table_lookup(priv->tokens, prefix);
+			if (!set)
+			{
+				set = g_hash_table_new(g_direct_hash, g_direct_equal);
+				g_hash_table_insert(priv->tokens, g_strdup(prefix), set);
+			}
+
+			/* Common prefixes of several words are only recorded once */
+			if (g_hash_table_lookup(set, entry))
+				g_free(prefix);
+			else
+			{
+				g_hash_table_insert(set, entry, entry);
+				g_ptr_array_add(entry->tokens, prefix);
+			}
+		}
+		while (*end);
+
+		g_free(g_ptr_array_index(words, i));
+	}
+
+	g_ptr_array_free(words, TRUE);
+	g_free(stream_name);
+	g_free(client_name);
+	g_free(application_id);
+	g_free(hostname);
+}
+static void pama_stream_index_entry_unindex(PamaStreamIndex *stream_index, PamaStreamIndexEntry *entry)
+{
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(stream_index);
+	guint i;
+
+	for (i = 0; i < entry->tokens->len; i++)
+	{
+		gchar *prefix = g_ptr_array_index(entry->tokens, i);
+		GHashTable *set = g_hash_table_lookup(priv->tokens, prefix);
+
+		if (set)
+		{
+			g_hash_table_remove(set, entry);
+			if (0 == g_hash_table_size(set))
+				g_hash_table_remove(priv->tokens, prefix);
+		}
+
+		g_free(prefix);
+	}
+
+	g_ptr_array_set_size(entry->tokens, 0);
+	g_hash_table_remove(priv->matches, entry->stream);
+}
+static void pama_stream_index_entry_free(gpointer data)
+{
+	PamaStreamIndexEntry *entry = data;
+
+	g_signal_handler_disconnect(entry->stream, entry->stream_notify_handler_id);
+	if (entry->client)
+	{
+		g_signal_handler_disconnect(entry->client, entry->client_notify_handler_id);
+		g_object_unref(entry->client);
+	}
+
+	g_ptr_array_foreach(entry->tokens, (GFunc) g_free, NULL);
+	g_ptr_array_free(entry->tokens, TRUE);
+	g_free(entry->text);
+	g_object_unref(entry->stream);
+	g_slice_free(PamaStreamIndexEntry, entry);
+}
+
+static void pama_stream_index_entry_set_client(PamaStreamIndex *stream_index, PamaStreamIndexEntry *entry)
+{
+	PamaPulseClient *client;
+
+	g_object_get(entry->stream, "client", &client, NULL);
+	if (client == entry->client)
+	{
+		if (client)
+			g_object_unref(client);
+		return;
+	}
+
+	if (entry->client)
+	{
+		g_signal_handler_disconnect(entry->client, entry->client_notify_handler_id);
+		g_object_unref(entry->client);
+	}
+
+	entry->client = client;
+	if (client)
+		entry->client_notify_handler_id = g_signal_connect(client, "notify", G_CALLBACK(pama_stream_index_client_notify), entry);
+}
+static void pama_stream_index_add_stream(PamaStreamIndex *stream_index, GObject *stream)
+{
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(stream_index);
+	PamaStreamIndexEntry *entry;
+	guint index;
+
+	g_object_get(stream, "index", &index, NULL);
+	if (g_hash_table_lookup(priv->entries, GUINT_TO_POINTER(index)))
+		return;
+
+	entry = g_slice_new0(PamaStreamIndexEntry);
+	entry->owner  = stream_index;
+	entry->stream = g_object_ref(stream);
+	entry->tokens = g_ptr_array_new();
+	entry->stream_notify_handler_id = g_signal_connect(stream, "notify", G_CALLBACK(pama_stream_index_stream_notify), stream_index);
+
+	pama_stream_index_entry_set_client(stream_index, entry);
+	entry->text = pama_stream_index_entry_build_text(entry);
+	pama_stream_index_entry_index(stream_index, entry);
+	g_hash_table_insert(priv->entries, GUINT_TO_POINTER(index), entry);
+}
+
+static void pama_stream_index_reindex(PamaStreamIndex *stream_index, PamaStreamIndexEntry *entry)
+{
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(stream_index);
+	gchar *text;
+
+	/* Every update notifies the name along with the volume, changed or not */
+	pama_stream_index_entry_set_client(stream_index, entry);
+	text = pama_stream_index_entry_build_text(entry);
+	if (0 == g_strcmp0(text, entry->text))
+	{
+		g_free(text);
+		return;
+	}
+	g_free(entry->text);
+	entry->text = text;
+
+	pama_stream_index_entry_unindex(stream_index, entry);
+	pama_stream_index_entry_index(stream_index, entry);
+
+	if (priv->query->len)
+	{
+		pama_stream_index_update_matches(stream_index);
+		g_signal_emit(stream_index, index_signals[CHANGED_SIGNAL], 0);
+	}
+}
+
+static void pama_stream_index_stream_added(PamaPulseContext *context, guint index, gpointer data)
+{
+	PamaStreamIndex *stream_index = PAMA_STREAM_INDEX(data);
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(stream_index);
+	GObject *stream;
+
+	if (PAMA_TYPE_PULSE_SINK_INPUT == priv->stream_type)
+		stream = G_OBJECT(pama_pulse_context_get_sink_input_by_index(context, index));
+	else
+		stream = G_OBJECT(pama_pulse_context_get_source_output_by_index(context, index));
+
+	if (!stream)
+		return;
+
+	pama_stream_index_add_stream(stream_index, stream);
+
+	if (priv->query->len)
+	{
+		pama_stream_index_update_matches(stream_index);
+		g_signal_emit(stream_index, index_signals[CHANGED_SIGNAL], 0);
+	}
+}
+static void pama_stream_index_stream_removed(PamaPulseContext *context, guint index, gpointer data)
+{
+	PamaStreamIndex *stream_index = PAMA_STREAM_INDEX(data);
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(stream_index);
+	PamaStreamIndexEntry *entry = g_hash_table_lookup(priv->entries, GUINT_TO_POINTER(index));
+
+	if (!entry)
+		return;
+
+	pama_stream_index_entry_unindex(stream_index, entry);
+	g_hash_table_remove(priv->entries, GUINT_TO_POINTER(index));
+}
+static void pama_stream_index_stream_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
+{
+	PamaStreamIndex *stream_index = PAMA_STREAM_INDEX(data);
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(stream_index);
+	PamaStreamIndexEntry *entry;
+	guint index;
+
+	/* Volume and mute changes do not affect the index; the name is notified with them, so reindex checks it really changed */
+	if (strcmp(pspec->name, "name") && strcmp(pspec->name, "client"))
+		return;
+
+	g_object_get(gobject, "index", &index, NULL);
+	entry = g_hash_table_lookup(priv->entries, GUINT_TO_POINTER(index));
+	if (entry)
+		pama_stream_index_reindex(stream_index, entry);
+}
+static void pama_stream_index_client_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
+{
+	PamaStreamIndexEntry *entry = data;
+
+	if (strcmp(pspec->name, "name") && strcmp(pspec->name, "application-id") && strcmp(pspec->name, "hostname"))
+		return;
+
+	pama_stream_index_reindex(entry->owner, entry);
+}
+
+static void pama_stream_index_update_matches(PamaStreamIndex *stream_index)
+{
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(stream_index);
+	GHashTable *smallest = NULL;
+	GHashTableIter iter;
+	gpointer key;
+	guint i;
+
+	g_hash_table_remove_all(priv->matches);
+
+	for (i = 0; i < priv->query->len; i++)
+	{
+		GHashTable *set = g_hash_table_lookup(priv->tokens, g_ptr_array_index(priv->query, i));
+
+		if (!set)
+			return;
+		if (!smallest || g_hash_table_size(set) < g_hash_table_size(smallest))
+			smallest = set;
+	}
+
+	if (!smallest)
+		return;
+
+	g_hash_table_iter_init(&iter, smallest);
+	while (g_hash_table_iter_next(&iter, &key, NULL))
+	{
+		PamaStreamIndexEntry *entry = key;
+
+		for (i = 0; i < priv->query->len; i++)
+		{
+			GHashTable *set = g_hash_table_lookup(priv->tokens, g_ptr_array_index(priv->query, i));
+			if (set != smallest && !g_hash_table_lookup(set, entry))
+				break;
+		}
+
+		if (i == priv->query->len)
+			g_hash_table_insert(priv->matches, entry->stream, entry->stream);
+	}
+}
+
+// Sets the text to filter by. Every word of the query has to be the start of a
+// word of one of the indexed strings of a stream for the stream to match.
+void pama_stream_index_set_query(PamaStreamIndex *stream_index, const gchar *query)
+{
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(stream_index);
+
+	g_ptr_array_foreach(priv->query, (GFunc) g_free, NULL);
+	g_ptr_array_set_size(priv->query, 0);
+	pama_stream_index_tokenize(query, priv->query);
+
+	pama_stream_index_update_matches(stream_index);
+	g_signal_emit(stream_index, index_signals[CHANGED_SIGNAL], 0);
+}
+gboolean pama_stream_index_has_query(PamaStreamIndex *stream_index)
+{
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(stream_index);
+
+	return priv->query->len > 0;
+}
+// Without a query, every stream matches.
+gboolean pama_stream_index_matches(PamaStreamIndex *stream_index, GObject *stream)
+{
+	PamaStreamIndexPrivate *priv = PAMA_STREAM_INDEX_GET_PRIVATE(stream_index);
+
+	if (0 == priv->query->len)
+		return TRUE;
+
+	return NULL != g_hash_table_lookup(priv->matches, stream);
+}
+
+PamaStreamIndex *pama_stream_index_new(PamaPulseContext *context, GType stream_type)
+{
+	return g_object_new(PAMA_TYPE_STREAM_INDEX,
+	                    "context", context,
+	                    "stream-type", stream_type,
+	                    NULL);
+}
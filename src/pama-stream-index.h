@@ -0,0 +1,63 @@
+/*
+ * pama-stream-index.h: A casefolded prefix index over the streams of a context, for filtering
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_STREAM_INDEX_H
+#define PAMA_STREAM_INDEX_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include "pama-pulse-context.h"
+
+G_BEGIN_DECLS
+
+#define PAMA_TYPE_STREAM_INDEX                  (pama_stream_index_get_type ())
+#define PAMA_STREAM_INDEX(obj)                  (G_TYPE_CHECK_INSTANCE_CAST ((obj), PAMA_TYPE_STREAM_INDEX, PamaStreamIndex))
+#define PAMA_IS_STREAM_INDEX(obj)               (G_TYPE_CHECK_INSTANCE_TYPE ((obj), PAMA_TYPE_STREAM_INDEX))
+#define PAMA_STREAM_INDEX_CLASS(klass)          (G_TYPE_CHECK_CLASS_CAST ((klass), PAMA_TYPE_STREAM_INDEX, PamaStreamIndexClass))
+#define PAMA_IS_STREAM_INDEX_CLASS(klass)       (G_TYPE_CHECK_CLASS_TYPE ((klass), PAMA_TYPE_STREAM_INDEX))
+#define PAMA_STREAM_INDEX_GET_CLASS(obj)        (G_TYPE_INSTANCE_GET_CLASS ((obj), PAMA_TYPE_STREAM_INDEX, PamaStreamIndexClass))
+
+typedef struct _PamaStreamIndex        PamaStreamIndex;
+typedef struct _PamaStreamIndexClass   PamaStreamIndexClass;
+typedef struct _PamaStreamIndexPrivate PamaStreamIndexPrivate;
+
+struct _PamaStreamIndex
+{
+	GObject parent_instance;
+};
+
+struct _PamaStreamIndexClass
+{
+	GObjectClass parent_class;
+};
+
+GType pama_stream_index_get_type();
+
+/* methods */
+PamaStreamIndex *pama_stream_index_new(PamaPulseContext *context, GType stream_type);
+
+void     pama_stream_index_set_query(PamaStreamIndex *stream_index, const gchar *query);
+gboolean pama_stream_index_has_query(PamaStreamIndex *stream_index);
+gboolean pama_stream_index_matches  (PamaStreamIndex *stream_index, GObject *stream);
+
+G_END_DECLS
+
+#endif /* PAMA_STREAM_INDEX_H */
+
@@ -0,0 +1,360 @@
+/*
+ * pama-stream-list.c: A scrolled list that only creates widgets for the visible rows of a stream model
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include "pama-stream-list.h"
+#include "pama-stream-model.h"
+#include "widget-settings.h"
+
+static void     pama_stream_list_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec);
+static GObject* pama_stream_list_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties);
+static void     pama_stream_list_dispose(GObject *gobject);
+static void     pama_stream_list_finalize(GObject *gobject);
+
+static void     pama_stream_list_model_changed(PamaStreamList *list);
+static void     pama_stream_list_adjustment_changed(GtkAdjustment *adjustment, gpointer data);
+static void     pama_stream_list_row_destroyed(GtkWidget *row, gpointer data);
+
+static void     pama_stream_list_queue_relayout(PamaStreamList *list);
+static gboolean pama_stream_list_relayout_idle(gpointer data);
+static void     pama_stream_list_relayout(PamaStreamList *list);
+
+struct _PamaStreamListPrivate
+{
+	GtkTreeModel *model;
+	PamaStreamListRowFunc row_func;
+	gpointer row_data;
+
+	GtkWidget *layout;
+	GtkAdjustment *vadjustment;
+
+	/* stream -> row widget, for the rows that currently exist */
+	GHashTable *rows;
+	gint row_width, row_height;
+
+	guint relayout_idle_id;
+
+	gulong row_inserted_handler_id;
+	gulong row_deleted_handler_id;
+	gulong row_changed_handler_id;
+	gulong rows_reordered_handler_id;
+	gulong value_changed_handler_id;
+	gulong adjustment_changed_handler_id;
+};
+
+G_DEFINE_TYPE(PamaStreamList, pama_stream_list, GTK_TYPE_SCROLLED_WINDOW);
+#define PAMA_STREAM_LIST_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE((obj), PAMA_TYPE_STREAM_LIST, PamaStreamListPrivate))
+
+enum
+{
+	PROP_0,
+
+	PROP_MODEL,
+	PROP_ROW_FUNC,
+	PROP_ROW_DATA
+};
+
+static void pama_stream_list_class_init(PamaStreamListClass *klass)
+{
+	GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+	GParamSpec *pspec;
+
+	gobject_class->set_property = pama_stream_list_set_property;
+	gobject_class->constructor  = pama_stream_list_constructor;
+	gobject_class->dispose      = pama_stream_list_dispose;
+	gobject_class->finalize     = pama_stream_list_finalize;
+
+	pspec = g_param_spec_object("model",
+	                            "Stream model",
+	                            "The GtkTreeModel holding the streams to list.",
+	                            GTK_TYPE_TREE_MODEL,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_MODEL, pspec);
+
+	pspec = g_param_spec_pointer("row-func",
+	                             "Row function",
+	                             "The PamaStreamListRowFunc used to create the widget of a visible row.",
+	                             G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_ROW_FUNC, pspec);
+
+	pspec = g_param_spec_pointer("row-data",
+	                             "Row function data",
+	                             "User data passed to the row function.",
+	                             G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_ROW_DATA, pspec);
+
+	g_type_class_add_private(klass, sizeof(PamaStreamListPrivate));
+}
+
+static void pama_stream_list_init(PamaStreamList *list)
+{
+	PamaStreamListPrivate *priv = PAMA_STREAM_LIST_GET_PRIVATE(list);
+
+	priv->rows = g_hash_table_new(g_direct_hash, g_direct_equal);
+}
+
+static void pama_stream_list_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec)
+{
+	PamaStreamList *list = PAMA_STREAM_LIST(gobject);
+	PamaStreamListPrivate *priv = PAMA_STREAM_LIST_GET_PRIVATE(list);
+
+	switch(property_id)
+	{
+		case PROP_MODEL:
+			priv->model = g_value_dup_object(value);
+			break;
+
+		case PROP_ROW_FUNC:
+			priv->row_func = g_value_get_pointer(value);
+			break;
+
+		case PROP_ROW_DATA:
+			priv->row_data = g_value_get_pointer(value);
+			break;
+
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
+			break;
+	}
+}
+
+static GObject* pama_stream_list_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties)
+{
+	GObject *gobject = G_OBJECT_CLASS(pama_stream_list_parent_class)->constructor(gtype, n_properties, properties);
+	PamaStreamList *list = PAMA_STREAM_LIST(gobject);
+	PamaStreamListPrivate *priv = PAMA_STREAM_LIST_GET_PRIVATE(list);
+
+	if (NULL == priv->model)
+		g_error("An attempt was made to construct a PamaStreamList without providing a valid GtkTreeModel.");
+	if (NULL == priv->row_func)
+		g_error("An attempt was made to construct a PamaStreamList without providing a row function.");
+
+	gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(list), GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+	gtk_scrolled_window_set_shadow_type(GTK_SCROLLED_WINDOW(list), GTK_SHADOW_NONE);
+
+	priv->layout = gtk_layout_new(NULL, NULL);
+	gtk_container_add(GTK_CONTAINER(list), priv->layout);
+	priv->vadjustment = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(list));
+
+	priv->row_inserted_handler_id       = g_signal_connect_swapped(priv->model, "row-inserted",   G_CALLBACK(pama_stream_list_model_changed), list);
+	priv->row_deleted_handler_id        = g_signal_connect_swapped(priv->model, "row-deleted",    G_CALLBACK(pama_stream_list_model_changed), list);
+	priv->row_changed_handler_id        = g_signal_connect_swapped(priv->model, "row-changed",    G_CALLBACK(pama_stream_list_model_changed), list);
+	priv->rows_reordered_handler_id     = g_signal_connect_swapped(priv->model, "rows-reordered", G_CALLBACK(pama_stream_list_model_changed), list);
+	priv->value_changed_handler_id      = g_signal_connect(priv->vadjustment, "value-changed", G_CALLBACK(pama_stream_list_adjustment_changed), list);
+	priv->adjustment_changed_handler_id = g_signal_connect(priv->vadjustment, "changed",       G_CALLBACK(pama_stream_list_adjustment_changed), list);
+
+	pama_stream_list_relayout(list);
+
+	return gobject;
+}
+static void pama_stream_list_dispose(GObject *gobject)
+{
+	PamaStreamList *list = PAMA_STREAM_LIST(gobject);
+	PamaStreamListPrivate *priv = PAMA_STREAM_LIST_GET_PRIVATE(list);
+
+	if (priv->relayout_idle_id)
+	{
+		g_source_remove(priv->relayout_idle_id);
+		priv->relayout_idle_id = 0;
+	}
+
+	if (priv->vadjustment)
+	{
+		g_signal_handler_disconnect(priv->vadjustment, priv->value_changed_handler_id);
+		g_signal_handler_disconnect(priv->vadjustment, priv->adjustment_changed_handler_id);
+		priv->vadjustment = NULL;
+	}
+
+	if (priv->model)
+	{
+		g_signal_handler_disconnect(priv->model, priv->row_inserted_handler_id);
+		g_signal_handler_disconnect(priv->model, priv->row_deleted_handler_id);
+		g_signal_handler_disconnect(priv->model, priv->row_changed_handler_id);
+		g_signal_handler_disconnect(priv->model, priv->rows_reordered_handler_id);
+
+		g_object_unref(priv->model);
+		priv->model = NULL;
+	}
+
+	/* The rows themselves are destroyed along with the layout */
+	G_OBJECT_CLASS(pama_stream_list_parent_class)->dispose(gobject);
+}
+static void pama_stream_list_finalize(GObject *gobject)
+{
+	PamaStreamListPrivate *priv = PAMA_STREAM_LIST_GET_PRIVATE(gobject);
+
+	g_hash_table_destroy(priv->rows);
+
+	G_OBJECT_CLASS(pama_stream_list_parent_class)->finalize(gobject);
+}
+
+
+static void pama_stream_list_model_changed(PamaStreamList *list)
+{
+	pama_stream_list_queue_relayout(list);
+}
+static void pama_stream_list_adjustment_changed(GtkAdjustment *adjustment, gpointer data)
+{
+	pama_stream_list_queue_relayout(PAMA_STREAM_LIST(data));
+}
+
+static gboolean pama_stream_list_row_destroyed__match(gpointer key, gpointer value, gpointer data)
+{
+	return value == data;
+}
+static void pama_stream_list_row_destroyed(GtkWidget *row, gpointer data)
+{
+	PamaStreamListPrivate *priv = PAMA_STREAM_LIST_GET_PRIVATE(data);
+
+	/* Row widgets destroy themselves when their stream goes away */
+	g_hash_table_foreach_remove(priv->rows, pama_stream_list_row_destroyed__match, row);
+}
+
+static void pama_stream_list_queue_relayout(PamaStreamList *list)
+{
+	PamaStreamListPrivate *priv = PAMA_STREAM_LIST_GET_PRIVATE(list);
+
+	/* Run before the next redraw, so newly exposed rows never appear blank */
+	if (!priv->relayout_idle_id)
+		priv->relayout_idle_id = g_idle_add_full(G_PRIORITY_HIGH_IDLE, pama_stream_list_relayout_idle, list, NULL);
+}
+static gboolean pama_stream_list_relayout_idle(gpointer data)
+{
+	PamaStreamList *list = PAMA_STREAM_LIST(data);
+	PamaStreamListPrivate *priv = PAMA_STREAM_LIST_GET_PRIVATE(list);
+
+	priv->relayout_idle_id = 0;
+	pama_stream_list_relayout(list);
+
+	return FALSE;
+}
+
+static GtkWidget *pama_stream_list_create_row(PamaStreamList *list, GObject *stream, gint y)
+{
+	PamaStreamListPrivate *priv = PAMA_STREAM_LIST_GET_PRIVATE(list);
+	GtkWidget *row = priv->row_func(stream, priv->row_data);
+
+	g_signal_connect(row, "destroy", G_CALLBACK(pama_stream_list_row_destroyed), list);
+	gtk_layout_put(GTK_LAYOUT(priv->layout), row, 0, y);
+	gtk_widget_show_all(row);
+	g_hash_table_insert(priv->rows, stream, row);
+
+	return row;
+}
+static void pama_stream_list_relayout__destroy(gpointer key, gpointer value, gpointer data)
+{
+	g_signal_handlers_disconnect_by_func(value, pama_stream_list_row_destroyed, data);
+	gtk_widget_destroy(GTK_WIDGET(value));
+}
+static void pama_stream_list_relayout(PamaStreamList *list)
+{
+	PamaStreamListPrivate *priv = PAMA_STREAM_LIST_GET_PRIVATE(list);
+	GHashTable *old_rows;
+	GtkTreeIter iter;
+	gint n, first, last, i;
+	gint request_width, request_height;
+	guint width, height;
+	gdouble page_size;
+
+	n = gtk_tree_model_iter_n_children(priv->model, NULL);
+
+	/* Measure a single row; every row of a popup has the same layout */
+	if (n > 0 && 0 == priv->row_height && gtk_tree_model_iter_nth_child(priv->model, &iter, NULL, 0))
+	{
+		GObject *stream = pama_stream_model_get_stream(priv->model, &iter);
+		GtkWidget *row = g_hash_table_lookup(priv->rows, stream);
+		GtkRequisition req;
+
+		if (!row)
+			row = pama_stream_list_create_row(list, stream, 0);
+
+		gtk_widget_size_request(row, &req);
+		priv->row_width  = req.width;
+		priv->row_height = req.height + WIDGET_STREAM_LIST_ROW_SPACING;
+	}
+
+	if (0 == priv->row_height)
+		return;
+
+	/* Both of these end up emitting "changed" on the adjustment, which queues
+	 * another relayout, so only touch them when something actually changed */
+	gtk_layout_get_size(GTK_LAYOUT(priv->layout), &width, &height);
+	if (width != priv->row_width || height != n * priv->row_height)
+		gtk_layout_set_size(GTK_LAYOUT(priv->layout), priv->row_width, n * priv->row_height);
+
+	gtk_widget_get_size_request(priv->layout, &request_width, &request_height);
+	if (request_width != priv->row_width || request_height != MIN(n, WIDGET_STREAM_LIST_MAX_ROWS) * priv->row_height)
+		gtk_widget_set_size_request(priv->layout, priv->row_width, MIN(n, WIDGET_STREAM_LIST_MAX_ROWS) * priv->row_height);
+
+	/* Before the first allocation the page size is still zero */
+	page_size = priv->vadjustment->page_size;
+	if (page_size <= 0)
+		page_size = WIDGET_STREAM_LIST_MAX_ROWS * priv->row_height;
+
+	/* One row of overscan on either side keeps scrolling by a step smooth */
+	first = MAX(0,     (gint)(priv->vadjustment->value / priv->row_height) - 1);
+	last  = MIN(n - 1, (gint)((priv->vadjustment->value + page_size) / priv->row_height) + 1);
+
+	old_rows = priv->rows;
+	priv->rows = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+	if (first <= last && gtk_tree_model_iter_nth_child(priv->model, &iter, NULL, first))
+	{
+		for (i = first; i <= last; i++)
+		{
+			GObject *stream = pama_stream_model_get_stream(priv->model, &iter);
+			GtkWidget *row = g_hash_table_lookup(old_rows, stream);
+
+			if (row)
+			{
+				g_hash_table_steal(old_rows, stream);
+				g_hash_table_insert(priv->rows, stream, row);
+				gtk_layout_move(GTK_LAYOUT(priv->layout), row, 0, i * priv->row_height);
+			}
+			else if (stream)
+			{
+				pama_stream_list_create_row(list, stream, i * priv->row_height);
+			}
+
+			if (!gtk_tree_model_iter_next(priv->model, &iter))
+				break;
+		}
+	}
+
+	/* Whatever is left has scrolled out of view or was removed from the model */
+	g_hash_table_foreach(old_rows, pama_stream_list_relayout__destroy, list);
+	g_hash_table_destroy(old_rows);
+}
+
+GtkWidget *pama_stream_list_new(GtkTreeModel *model, PamaStreamListRowFunc row_func, gpointer row_data)
+{
+	return g_object_new(PAMA_TYPE_STREAM_LIST,
+	                    "hadjustment", NULL,
+	                    "vadjustment", NULL,
+	                    "model", model,
+	                    "row-func", row_func,
+	                    "row-data", row_data,
+	                    NULL);
+}
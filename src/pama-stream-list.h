@@ -0,0 +1,62 @@
+/*
+ * pama-stream-list.h: A scrolled list that only creates widgets for the visible rows of a stream model
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_STREAM_LIST_H
+#define PAMA_STREAM_LIST_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+#define PAMA_TYPE_STREAM_LIST                  (pama_stream_list_get_type ())
+#define PAMA_STREAM_LIST(obj)                  (G_TYPE_CHECK_INSTANCE_CAST ((obj), PAMA_TYPE_STREAM_LIST, PamaStreamList))
+#define PAMA_IS_STREAM_LIST(obj)               (G_TYPE_CHECK_INSTANCE_TYPE ((obj), PAMA_TYPE_STREAM_LIST))
+#define PAMA_STREAM_LIST_CLASS(klass)          (G_TYPE_CHECK_CLASS_CAST ((klass), PAMA_TYPE_STREAM_LIST, PamaStreamListClass))
+#define PAMA_IS_STREAM_LIST_CLASS(klass)       (G_TYPE_CHECK_CLASS_TYPE ((klass), PAMA_TYPE_STREAM_LIST))
+#define PAMA_STREAM_LIST_GET_CLASS(obj)        (G_TYPE_INSTANCE_GET_CLASS ((obj), PAMA_TYPE_STREAM_LIST, PamaStreamListClass))
+
+typedef struct _PamaStreamList        PamaStreamList;
+typedef struct _PamaStreamListClass   PamaStreamListClass;
+typedef struct _PamaStreamListPrivate PamaStreamListPrivate;
+
+struct _PamaStreamList
+{
+	GtkScrolledWindow parent_instance;
+};
+
+struct _PamaStreamListClass
+{
+	GtkScrolledWindowClass parent_class;
+};
+
+/* Creates the row widget for a stream; called only for rows that scroll into view */
+typedef GtkWidget *(*PamaStreamListRowFunc)(GObject *stream, gpointer data);
+
+GType pama_stream_list_get_type();
+
+/* methods */
+GtkWidget *pama_stream_list_new(GtkTreeModel *model, PamaStreamListRowFunc row_func, gpointer row_data);
+
+G_END_DECLS
+
+#endif /* PAMA_STREAM_LIST_H */
+
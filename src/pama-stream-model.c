@@ -0,0 +1,374 @@
+/*
+ * pama-stream-model.c: A list model of the sink inputs or source outputs of a context
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include "pama-stream-model.h"
+
+static void     pama_stream_model_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec);
+static GObject* pama_stream_model_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties);
+static void     pama_stream_model_dispose(GObject *gobject);
+static void     pama_stream_model_finalize(GObject *gobject);
+static void     pama_stream_model_weak_ref_notify(gpointer data, GObject *where_the_object_was);
+
+static void     pama_stream_model_stream_added(PamaPulseContext *context, guint index, gpointer data);
+static void     pama_stream_model_stream_removed(PamaPulseContext *context, guint index, gpointer data);
+static void     pama_stream_model_stream_notify(GObject *gobject, GParamSpec *pspec, gpointer data);
+static gint     pama_stream_model_compare(GtkTreeModel *model, GtkTreeIter *a, GtkTreeIter *b, gpointer data);
+
+static void     pama_stream_model_add_stream(PamaStreamModel *model, GObject *stream);
+static void     pama_stream_model_row_free(gpointer data);
+
+typedef struct
+{
+	GtkTreeIter  iter;
+	gchar       *name; /* the name the row was last sorted by */
+} PamaStreamModelRow;
+
+struct _PamaStreamModelPrivate
+{
+	PamaPulseContext *context;
+	GType             stream_type;
+
+	/* stream index -> PamaStreamModelRow; list store iters stay valid until their row is removed */
+	GHashTable *rows;
+
+	gulong added_handler_id;
+	gulong removed_handler_id;
+};
+
+G_DEFINE_TYPE(PamaStreamModel, pama_stream_model, GTK_TYPE_LIST_STORE);
+#define PAMA_STREAM_MODEL_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE((obj), PAMA_TYPE_STREAM_MODEL, PamaStreamModelPrivate))
+
+enum
+{
+	PROP_0,
+
+	PROP_CONTEXT,
+	PROP_STREAM_TYPE
+};
+
+static void pama_stream_model_class_init(PamaStreamModelClass *klass)
+{
+	GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+	GParamSpec *pspec;
+
+	gobject_class->set_property = pama_stream_model_set_property;
+	gobject_class->constructor  = pama_stream_model_constructor;
+	gobject_class->dispose      = pama_stream_model_dispose;
+	gobject_class->finalize     = pama_stream_model_finalize;
+
+	pspec = g_param_spec_object("context",
+	                            "Pulse context object",
+	                            "The PamaPulseContext whose streams are listed.",
+	                            PAMA_TYPE_PULSE_CONTEXT,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_CONTEXT, pspec);
+
+	pspec = g_param_spec_gtype("stream-type",
+	                           "Stream type",
+	                           "Either PAMA_TYPE_PULSE_SINK_INPUT or PAMA_TYPE_PULSE_SOURCE_OUTPUT.",
+	                           G_TYPE_OBJECT,
+	                           G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_STREAM_TYPE, pspec);
+
+	g_type_class_add_private(klass, sizeof(PamaStreamModelPrivate));
+}
+
+static void pama_stream_model_init(PamaStreamModel *model)
+{
+	PamaStreamModelPrivate *priv = PAMA_STREAM_MODEL_GET_PRIVATE(model);
+	GType column_types[PAMA_STREAM_MODEL_N_COLUMNS] = { G_TYPE_OBJECT };
+
+	gtk_list_store_set_column_types(GTK_LIST_STORE(model), PAMA_STREAM_MODEL_N_COLUMNS, column_types);
+
+	priv->rows = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, pama_stream_model_row_free);
+}
+
+static void pama_stream_model_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec)
+{
+	PamaStreamModel *model = PAMA_STREAM_MODEL(gobject);
+	PamaStreamModelPrivate *priv = PAMA_STREAM_MODEL_GET_PRIVATE(model);
+
+	switch(property_id)
+	{
+		case PROP_CONTEXT:
+			priv->context = g_value_get_object(value);
+			g_object_weak_ref(G_OBJECT(priv->context), pama_stream_model_weak_ref_notify, model);
+			break;
+
+		case PROP_STREAM_TYPE:
+			priv->stream_type = g_value_get_gtype(value);
+			break;
+
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
+			break;
+	}
+}
+
+static GObject* pama_stream_model_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties)
+{
+	GObject *gobject = G_OBJECT_CLASS(pama_stream_model_parent_class)->constructor(gtype, n_properties, properties);
+	PamaStreamModel *model = PAMA_STREAM_MODEL(gobject);
+	PamaStreamModelPrivate *priv = PAMA_STREAM_MODEL_GET_PRIVATE(model);
+	GSList *streams, *iter;
+	const gchar *added_signal, *removed_signal;
+
+	if (NULL == priv->context)
+		g_error("An attempt was made to construct a PamaStreamModel without providing a valid PamaPulseContext.");
+
+	if (PAMA_TYPE_PULSE_SINK_INPUT == priv->stream_type)
+	{
+		streams        = pama_pulse_context_get_sink_inputs(priv->context);
+		added_signal   = "sink-input-added";
+		removed_signal = "sink-input-removed";
+	}
+	else if (PAMA_TYPE_PULSE_SOURCE_OUTPUT == priv->stream_type)
+	{
+		streams        = pama_pulse_context_get_source_outputs(priv->context);
+		added_signal   = "source-output-added";
+		removed_signal = "source-output-removed";
+	}
+	else
+	{
+		g_error("An attempt was made to construct a PamaStreamModel for an unsupported stream type.");
+		return gobject;
+	}
+
+	gtk_tree_sortable_set_default_sort_func(GTK_TREE_SORTABLE(model), pama_stream_model_compare, model, NULL);
+	gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(model), GTK_TREE_SORTABLE_DEFAULT_SORT_COLUMN_ID, GTK_SORT_ASCENDING);
+
+	for (iter = streams; iter; iter = iter->next)
+		pama_stream_model_add_stream(model, G_OBJECT(iter->data));
+
+	priv->added_handler_id   = g_signal_connect(priv->context, added_signal,   G_CALLBACK(pama_stream_model_stream_added),   model);
+	priv->removed_handler_id = g_signal_connect(priv->context, removed_signal, G_CALLBACK(pama_stream_model_stream_removed), model);
+
+	return gobject;
+}
+
+static gboolean pama_stream_model_dispose__disconnect(GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer data)
+{
+	GObject *stream = pama_stream_model_get_stream(model, iter);
+
+	if (stream)
+		g_signal_handlers_disconnect_by_func(stream, pama_stream_model_stream_notify, data);
+
+	return FALSE;
+}
+static void pama_stream_model_dispose(GObject *gobject)
+{
+	PamaStreamModel *model = PAMA_STREAM_MODEL(gobject);
+	PamaStreamModelPrivate *priv = PAMA_STREAM_MODEL_GET_PRIVATE(model);
+
+	if (priv->context)
+	{
+		if (priv->added_handler_id)
+		{
+			g_signal_handler_disconnect(priv->context, priv->added_handler_id);
+			priv->added_handler_id = 0;
+		}
+
+		if (priv->removed_handler_id)
+		{
+			g_signal_handler_disconnect(priv->context, priv->removed_handler_id);
+			priv->removed_handler_id = 0;
+		}
+
+		g_object_weak_unref(G_OBJECT(priv->context), pama_stream_model_weak_ref_notify, model);
+		priv->context = NULL;
+	}
+
+	gtk_tree_model_foreach(GTK_TREE_MODEL(model), pama_stream_model_dispose__disconnect, model);
+	g_hash_table_remove_all(priv->rows);
+	gtk_list_store_clear(GTK_LIST_STORE(model));
+
+	G_OBJECT_CLASS(pama_stream_model_parent_class)->dispose(gobject);
+}
+static void pama_stream_model_finalize(GObject *gobject)
+{
+	PamaStreamModelPrivate *priv = PAMA_STREAM_MODEL_GET_PRIVATE(gobject);
+
+	g_hash_table_destroy(priv->rows);
+
+	G_OBJECT_CLASS(pama_stream_model_parent_class)->finalize(gobject);
+}
+static void pama_stream_model_weak_ref_notify(gpointer data, GObject *where_the_object_was)
+{
+	PamaStreamModelPrivate *priv = PAMA_STREAM_MODEL_GET_PRIVATE(data);
+
+	if ((GObject *)priv->context == where_the_object_was)
+	{
+		priv->context = NULL;
+		priv->added_handler_id = 0;
+		priv->removed_handler_id = 0;
+	}
+}
+
+
+static void pama_stream_model_add_stream(PamaStreamModel *model, GObject *stream)
+{
+	PamaStreamModelPrivate *priv = PAMA_STREAM_MODEL_GET_PRIVATE(model);
+	PamaStreamModelRow *row;
+	guint index;
+
+	g_object_get(stream, "index", &index, NULL);
+
+	if (g_hash_table_lookup(priv->rows, GUINT_TO_POINTER(index)))
+		return;
+
+	row = g_slice_new(PamaStreamModelRow);
+	g_object_get(stream, "name", &row->name, NULL);
+	gtk_list_store_insert_with_values(GTK_LIST_STORE(model), &row->iter, 0,
+	                                  PAMA_STREAM_MODEL_COLUMN_STREAM, stream,
+	                                  -1);
+	g_hash_table_insert(priv->rows, GUINT_TO_POINTER(index), row);
+
+	/* The name is the only property of the stream itself that affects the sort order */
+	g_signal_connect(stream, "notify::name", G_CALLBACK(pama_stream_model_stream_notify), model);
+}
+
+static void pama_stream_model_stream_added(PamaPulseContext *context, guint index, gpointer data)
+{
+	PamaStreamModel *model = PAMA_STREAM_MODEL(data);
+	PamaStreamModelPrivate *priv = PAMA_STREAM_MODEL_GET_PRIVATE(model);
+	GObject *stream;
+
+	if (PAMA_TYPE_PULSE_SINK_INPUT == priv->stream_type)
+		stream = G_OBJECT(pama_pulse_context_get_sink_input_by_index(context, index));
+	else
+		stream = G_OBJECT(pama_pulse_context_get_source_output_by_index(context, index));
+
+	if (stream)
+		pama_stream_model_add_stream(model, stream);
+}
+static void pama_stream_model_stream_removed(PamaPulseContext *context, guint index, gpointer data)
+{
+	PamaStreamModel *model = PAMA_STREAM_MODEL(data);
+	PamaStreamModelPrivate *priv = PAMA_STREAM_MODEL_GET_PRIVATE(model);
+	PamaStreamModelRow *row = g_hash_table_lookup(priv->rows, GUINT_TO_POINTER(index));
+	GObject *stream;
+
+	if (!row)
+		return;
+
+	/* The context only drops its reference after this signal, so the stream is still alive */
+	stream = pama_stream_model_get_stream(GTK_TREE_MODEL(model), &row->iter);
+	g_signal_handlers_disconnect_by_func(stream, pama_stream_model_stream_notify, model);
+
+	gtk_list_store_remove(GTK_LIST_STORE(model), &row->iter);
+	g_hash_table_remove(priv->rows, GUINT_TO_POINTER(index));
+}
+static void pama_stream_model_stream_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
+{
+	PamaStreamModel *model = PAMA_STREAM_MODEL(data);
+	PamaStreamModelPrivate *priv = PAMA_STREAM_MODEL_GET_PRIVATE(model);
+	PamaStreamModelRow *row;
+	gchar *name;
+	guint index;
+
+	g_object_get(gobject, "index", &index, NULL);
+	row = g_hash_table_lookup(priv->rows, GUINT_TO_POINTER(index));
+	if (!row)
+		return;
+
+	/* The name is notified with every volume update, changed or not */
+	g_object_get(gobject, "name", &name, NULL);
+	if (!g_strcmp0(name, row->name))
+	{
+		g_free(name);
+		return;
+	}
+	g_free(row->name);
+	row->name = name;
+
+	/* Setting the value again moves the row to its new sorted position */
+	gtk_list_store_set(GTK_LIST_STORE(model), &row->iter, PAMA_STREAM_MODEL_COLUMN_STREAM, gobject, -1);
+}
+static void pama_stream_model_row_free(gpointer data)
+{
+	PamaStreamModelRow *row = data;
+
+	g_free(row->name);
+	g_slice_free(PamaStreamModelRow, row);
+}
+
+static gint pama_stream_model_compare(GtkTreeModel *tree_model, GtkTreeIter *a, GtkTreeIter *b, gpointer data)
+{
+	PamaStreamModelPrivate *priv = PAMA_STREAM_MODEL_GET_PRIVATE(data);
+	GObject *A = pama_stream_model_get_stream(tree_model, a);
+	GObject *B = pama_stream_model_get_stream(tree_model, b);
+	PamaPulseClient *Ac, *Bc;
+	gint result;
+
+	/* Rows are compared while being inserted, before their value has been set */
+	if (!A || !B)
+		return (A ? 1 : 0) - (B ? 1 : 0);
+
+	g_object_get(A, "client", &Ac, NULL);
+	g_object_get(B, "client", &Bc, NULL);
+
+	result = pama_pulse_client_compare_by_is_local(Ac, Bc);
+	if (!result)
+	{
+		result = pama_pulse_client_compare_by_hostname(Ac, Bc);
+		if (!result)
+		{
+			result = pama_pulse_client_compare_by_name(Ac, Bc);
+			if (!result)
+			{
+				if (PAMA_TYPE_PULSE_SINK_INPUT == priv->stream_type)
+					result = pama_pulse_sink_input_compare_by_name(A, B);
+				else
+					result = pama_pulse_source_output_compare_by_name(A, B);
+			}
+		}
+	}
+
+	g_object_unref(Ac);
+	g_object_unref(Bc);
+	return result;
+}
+
+// Returns the stream stored in a row. The model keeps its own reference, so
+// the result is not referenced for the caller.
+GObject *pama_stream_model_get_stream(GtkTreeModel *model, GtkTreeIter *iter)
+{
+	GObject *stream;
+
+	gtk_tree_model_get(model, iter, PAMA_STREAM_MODEL_COLUMN_STREAM, &stream, -1);
+	if (stream)
+		g_object_unref(stream);
+
+	return stream;
+}
+
+PamaStreamModel *pama_stream_model_new(PamaPulseContext *context, GType stream_type)
+{
+	return g_object_new(PAMA_TYPE_STREAM_MODEL,
+	                    "context", context,
+	                    "stream-type", stream_type,
+	                    NULL);
+}
@@ -0,0 +1,67 @@
+/*
+ * pama-stream-model.h: A list model of the sink inputs or source outputs of a context
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_STREAM_MODEL_H
+#define PAMA_STREAM_MODEL_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+#include "pama-pulse-context.h"
+
+G_BEGIN_DECLS
+
+#define PAMA_TYPE_STREAM_MODEL                  (pama_stream_model_get_type ())
+#define PAMA_STREAM_MODEL(obj)                  (G_TYPE_CHECK_INSTANCE_CAST ((obj), PAMA_TYPE_STREAM_MODEL, PamaStreamModel))
+#define PAMA_IS_STREAM_MODEL(obj)               (G_TYPE_CHECK_INSTANCE_TYPE ((obj), PAMA_TYPE_STREAM_MODEL))
+#define PAMA_STREAM_MODEL_CLASS(klass)          (G_TYPE_CHECK_CLASS_CAST ((klass), PAMA_TYPE_STREAM_MODEL, PamaStreamModelClass))
+#define PAMA_IS_STREAM_MODEL_CLASS(klass)       (G_TYPE_CHECK_CLASS_TYPE ((klass), PAMA_TYPE_STREAM_MODEL))
+#define PAMA_STREAM_MODEL_GET_CLASS(obj)        (G_TYPE_INSTANCE_GET_CLASS ((obj), PAMA_TYPE_STREAM_MODEL, PamaStreamModelClass))
+
+typedef struct _PamaStreamModel        PamaStreamModel;
+typedef struct _PamaStreamModelClass   PamaStreamModelClass;
+typedef struct _PamaStreamModelPrivate PamaStreamModelPrivate;
+
+struct _PamaStreamModel
+{
+	GtkListStore parent_instance;
+};
+
+struct _PamaStreamModelClass
+{
+	GtkListStoreClass parent_class;
+};
+
+enum
+{
+	PAMA_STREAM_MODEL_COLUMN_STREAM,
+	PAMA_STREAM_MODEL_N_COLUMNS
+};
+
+GType pama_stream_model_get_type();
+
+/* methods */
+PamaStreamModel *pama_stream_model_new(PamaPulseContext *context, GType stream_type);
+GObject         *pama_stream_model_get_stream(GtkTreeModel *model, GtkTreeIter *iter);
+
+G_END_DECLS
+
+#endif /* PAMA_STREAM_MODEL_H */
+
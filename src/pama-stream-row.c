@@ -0,0 +1,864 @@
+/*
+ * pama-stream-row.c: A single cairo-drawn widget for one row of the stream list
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+#include <string.h>
+
+#include "pama-stream-row.h"
+#include "pama-device-menu.h"
+#include "pama-feedback-sound.h"
+#include "pama-icon-cache.h"
+#include "pama-volume-map.h"
+#include "widget-settings.h"
+
+/* A row of the stream list used to be an hbox of an image, two labels, a
+ * scale and two buttons, with the icons in a size group. With hundreds of
+ * streams, building, measuring and allocating all of those dominated both the
+ * time to show the popup and its memory. This widget draws the same columns
+ * itself and handles their input, so a row is a single GdkWindow. The column
+ * positions only depend on the font, so they are computed once and shared by
+ * every row. */
+
+#define ROW_SPACING        6
+#define ROW_BUTTON_PADDING 4
+#define ROW_TROUGH_HEIGHT  4
+#define ROW_KNOB_WIDTH     10
+
+typedef struct
+{
+	gint name_x, slider_x, value_x, mute_x, device_x;
+	gint name_width, value_width, button_size;
+	gint width, height;
+} PamaStreamRowColumns;
+
+typedef enum
+{
+	ROW_PART_NONE,
+	ROW_PART_NAME,
+	ROW_PART_SLIDER,
+	ROW_PART_MUTE,
+	ROW_PART_DEVICE
+} PamaStreamRowPart;
+
+static void     pama_stream_row_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec);
+static GObject* pama_stream_row_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties);
+static void     pama_stream_row_dispose(GObject *gobject);
+static void     pama_stream_row_finalize(GObject *gobject);
+static void     pama_stream_row_weak_ref_notify(gpointer data, GObject *where_the_object_was);
+
+static void     pama_stream_row_realize(GtkWidget *widget);
+static void     pama_stream_row_map(GtkWidget *widget);
+static void     pama_stream_row_size_request(GtkWidget *widget, GtkRequisition *requisition);
+static void     pama_stream_row_size_allocate(GtkWidget *widget, GtkAllocation *allocation);
+static void     pama_stream_row_style_set(GtkWidget *widget, GtkStyle *previous_style);
+static gboolean pama_stream_row_expose(GtkWidget *widget, GdkEventExpose *event);
+static gboolean pama_stream_row_button_press(GtkWidget *widget, GdkEventButton *event);
+static gboolean pama_stream_row_button_release(GtkWidget *widget, GdkEventButton *event);
+static gboolean pama_stream_row_motion_notify(GtkWidget *widget, GdkEventMotion *event);
+static gboolean pama_stream_row_leave_notify(GtkWidget *widget, GdkEventCrossing *event);
+static gboolean pama_stream_row_scroll(GtkWidget *widget, GdkEventScroll *event);
+static gboolean pama_stream_row_query_tooltip(GtkWidget *widget, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip);
+
+static void     pama_stream_row_stream_notify(GObject *gobject, GParamSpec *pspec, gpointer data);
+static void     pama_stream_row_update_values(PamaStreamRow *row);
+static void     pama_stream_row_update_icons(PamaStreamRow *row);
+
+static const PamaStreamRowColumns *pama_stream_row_get_columns(GtkWidget *widget);
+static PamaStreamRowPart pama_stream_row_part_at(PamaStreamRow *row, gint x, GdkRectangle *area);
+static void     pama_stream_row_set_volume(PamaStreamRow *row, const guint32 volume);
+static void     pama_stream_row_set_volume_at(PamaStreamRow *row, gint x);
+static void     pama_stream_row_draw_button(PamaStreamRow *row, cairo_t *cr, gint x, gint y, GdkPixbuf *pixbuf, gboolean active, gboolean hover, gboolean sensitive);
+
+struct _PamaStreamRowPrivate
+{
+	PamaPulseContext *context;
+	GObject          *stream;
+	GtkWidget        *device_menu;
+	gboolean          has_volume;
+
+	/* what is drawn, kept up to date by pama_stream_row_update_values() */
+	PangoLayout *name, *value;
+	GdkPixbuf   *icon, *device_icon, *mute_icon;
+	gdouble      position;
+	gboolean     mute, movable;
+
+	PamaStreamRowPart hover, pressed;
+	gboolean          dirty;
+
+	gulong stream_notify_handler_id;
+};
+
+G_DEFINE_TYPE(PamaStreamRow, pama_stream_row, GTK_TYPE_WIDGET);
+#define PAMA_STREAM_ROW_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE((obj), PAMA_TYPE_STREAM_ROW, PamaStreamRowPrivate))
+
+enum 
+{
+	PROP_0,
+
+	PROP_CONTEXT,
+	PROP_STREAM,
+	PROP_DEVICE_MENU
+};
+
+static void pama_stream_row_class_init(PamaStreamRowClass *klass)
+{
+	GObjectClass   *gobject_class = G_OBJECT_CLASS(klass);
+	GtkWidgetClass *widget_class  = GTK_WIDGET_CLASS(klass);
+	GParamSpec *pspec;
+
+	gobject_class->set_property = pama_stream_row_set_property;
+	gobject_class->constructor  = pama_stream_row_constructor;
+	gobject_class->dispose      = pama_stream_row_dispose;
+	gobject_class->finalize     = pama_stream_row_finalize;
+
+	widget_class->realize              = pama_stream_row_realize;
+	widget_class->map                  = pama_stream_row_map;
+	widget_class->size_request         = pama_stream_row_size_request;
+	widget_class->size_allocate        = pama_stream_row_size_allocate;
+	widget_class->style_set            = pama_stream_row_style_set;
+	widget_class->expose_event         = pama_stream_row_expose;
+	widget_class->button_press_event   = pama_stream_row_button_press;
+	widget_class->button_release_event = pama_stream_row_button_release;
+	widget_class->motion_notify_event  = pama_stream_row_motion_notify;
+	widget_class->leave_notify_event   = pama_stream_row_leave_notify;
+	widget_class->scroll_event         = pama_stream_row_scroll;
+	widget_class->query_tooltip        = pama_stream_row_query_tooltip;
+
+	pspec = g_param_spec_object("context",
+	                            "Pulse context",
+	                            "The PamaPulseContext that is managing the current connection.",
+	                            PAMA_TYPE_PULSE_CONTEXT,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_CONTEXT, pspec);
+
+	pspec = g_param_spec_object("stream",
+	                            "Pulse stream",
+	                            "The PamaPulseSinkInput or PamaPulseSourceOutput shown in this row.",
+	                            G_TYPE_OBJECT,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_STREAM, pspec);
+
+	pspec = g_param_spec_object("device-menu",
+	                            "Device menu",
+	                            "The PamaDeviceMenu used to move the stream to another device.",
+	                            PAMA_TYPE_DEVICE_MENU,
+	                            G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+	g_object_class_install_property(gobject_class, PROP_DEVICE_MENU, pspec);
+
+	g_type_class_add_private(klass, sizeof(PamaStreamRowPrivate));
+}
+
+static void pama_stream_row_init(PamaStreamRow *row)
+{
+	gtk_widget_set_has_tooltip(GTK_WIDGET(row), TRUE);
+}
+
+static void pama_stream_row_set_property(GObject *gobject, guint property_id, const GValue *value, GParamSpec *pspec)
+{
+	PamaStreamRow *row = PAMA_STREAM_ROW(gobject);
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(row);
+
+	switch(property_id)
+	{
+		case PROP_CONTEXT:
+			priv->context = g_value_get_object(value);
+			g_object_weak_ref(G_OBJECT(priv->context), pama_stream_row_weak_ref_notify, row);
+			break;
+
+		case PROP_STREAM:
+			priv->stream = g_value_get_object(value);
+			g_object_weak_ref(priv->stream, pama_stream_row_weak_ref_notify, row);
+			break;
+
+		case PROP_DEVICE_MENU:
+			priv->device_menu = g_value_dup_object(value);
+			break;
+
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
+			break;
+	}
+}
+static GObject* pama_stream_row_constructor(GType gtype, guint n_properties, GObjectConstructParam *properties)
+{
+	GObject *gobject = G_OBJECT_CLASS(pama_stream_row_parent_class)->constructor(gtype, n_properties, properties);
+	PamaStreamRow *row = PAMA_STREAM_ROW(gobject);
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(row);
+
+	if (NULL == priv->context)
+		g_error("An attempt was made to create a stream row with no context.");
+	if (NULL == priv->stream)
+		g_error("An attempt was made to create a stream row with no stream.");
+	if (!PAMA_IS_PULSE_SINK_INPUT(priv->stream) && !PAMA_IS_PULSE_SOURCE_OUTPUT(priv->stream))
+		g_error("An attempt was made to create a stream row for an object that is neither a sink input nor a source output.");
+	if (NULL == priv->device_menu)
+		g_error("An attempt was made to create a stream row with no device menu.");
+
+	/* Source outputs have no volume of their own */
+	priv->has_volume = PAMA_IS_PULSE_SINK_INPUT(priv->stream);
+
+	priv->stream_notify_handler_id = g_signal_connect(priv->stream,
+	                                                  priv->has_volume ? "notify::volume" : "notify::source",
+	                                                  G_CALLBACK(pama_stream_row_stream_notify), row);
+
+	return gobject;
+}
+static void pama_stream_row_dispose(GObject *gobject)
+{
+	PamaStreamRow *row = PAMA_STREAM_ROW(gobject);
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(row);
+
+	if (priv->stream)
+	{
+		if (priv->stream_notify_handler_id)
+		{
+			g_signal_handler_disconnect(priv->stream, priv->stream_notify_handler_id);
+			priv->stream_notify_handler_id = 0;
+		}
+
+		g_object_weak_unref(priv->stream, pama_stream_row_weak_ref_notify, row);
+		priv->stream = NULL;
+	}
+
+	if (priv->context)
+	{
+		g_object_weak_unref(G_OBJECT(priv->context), pama_stream_row_weak_ref_notify, row);
+		priv->context = NULL;
+	}
+
+	if (priv->device_menu)
+	{
+		g_object_unref(priv->device_menu);
+		priv->device_menu = NULL;
+	}
+
+	G_OBJECT_CLASS(pama_stream_row_parent_class)->dispose(gobject);
+}
+static void pama_stream_row_finalize(GObject *gobject)
+{
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(gobject);
+
+	if (priv->name)
+		g_object_unref(priv->name);
+	if (priv->value)
+		g_object_unref(priv->value);
+	if (priv->icon)
+		g_object_unref(priv->icon);
+	if (priv->device_icon)
+		g_object_unref(priv->device_icon);
+	if (priv->mute_icon)
+		g_object_unref(priv->mute_icon);
+
+	G_OBJECT_CLASS(pama_stream_row_parent_class)->finalize(gobject);
+}
+static void pama_stream_row_weak_ref_notify(gpointer data, GObject *where_the_object_was)
+{
+	PamaStreamRow *row = data;
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(row);
+
+	if (priv->stream == where_the_object_was)
+	{
+		priv->stream = NULL;
+		priv->stream_notify_handler_id = 0;
+	}
+
+	if ((GObject *)priv->context == where_the_object_was)
+		priv->context = NULL;
+
+	/* row is no longer usable without these items. */
+	gtk_object_destroy(GTK_OBJECT(row));
+}
+
+
+static void pama_stream_row_realize(GtkWidget *widget)
+{
+	GdkWindowAttr attributes;
+
+	GTK_WIDGET_SET_FLAGS(widget, GTK_REALIZED);
+
+	attributes.window_type = GDK_WINDOW_CHILD;
+	attributes.x           = widget->allocation.x;
+	attributes.y           = widget->allocation.y;
+	attributes.width       = widget->allocation.width;
+	attributes.height      = widget->allocation.height;
+	attributes.wclass      = GDK_INPUT_OUTPUT;
+	attributes.visual      = gtk_widget_get_visual(widget);
+	attributes.colormap    = gtk_widget_get_colormap(widget);
+	attributes.event_mask  = gtk_widget_get_events(widget)
+	                       | GDK_EXPOSURE_MASK
+	                       | GDK_BUTTON_PRESS_MASK
+	                       | GDK_BUTTON_RELEASE_MASK
+	                       | GDK_POINTER_MOTION_MASK
+	                       | GDK_LEAVE_NOTIFY_MASK
+	                       | GDK_SCROLL_MASK;
+
+	widget->window = gdk_window_new(gtk_widget_get_parent_window(widget), &attributes,
+	                                GDK_WA_X | GDK_WA_Y | GDK_WA_VISUAL | GDK_WA_COLORMAP);
+	gdk_window_set_user_data(widget->window, widget);
+
+	widget->style = gtk_style_attach(widget->style, widget->window);
+	gtk_style_set_background(widget->style, widget->window, GTK_STATE_NORMAL);
+}
+static void pama_stream_row_map(GtkWidget *widget)
+{
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(widget);
+
+	/* Rows that were scrolled away catch up when they are shown again */
+	if (priv->dirty)
+		pama_stream_row_update_values(PAMA_STREAM_ROW(widget));
+
+	GTK_WIDGET_CLASS(pama_stream_row_parent_class)->map(widget);
+}
+static void pama_stream_row_size_request(GtkWidget *widget, GtkRequisition *requisition)
+{
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(widget);
+	const PamaStreamRowColumns *columns = pama_stream_row_get_columns(widget);
+
+	if (priv->has_volume)
+		requisition->width = columns->width;
+	else
+		requisition->width = columns->slider_x + columns->button_size;
+	requisition->height = columns->height;
+}
+static void pama_stream_row_size_allocate(GtkWidget *widget, GtkAllocation *allocation)
+{
+	widget->allocation = *allocation;
+
+	if (GTK_WIDGET_REALIZED(widget))
+		gdk_window_move_resize(widget->window, allocation->x, allocation->y, allocation->width, allocation->height);
+}
+static void pama_stream_row_style_set(GtkWidget *widget, GtkStyle *previous_style)
+{
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(widget);
+	const PamaStreamRowColumns *columns = pama_stream_row_get_columns(widget);
+
+	if (priv->name)
+	{
+		pango_layout_context_changed(priv->name);
+		pango_layout_set_width(priv->name, columns->name_width * PANGO_SCALE);
+	}
+	if (priv->value)
+		pango_layout_context_changed(priv->value);
+
+	/* Style changes follow icon theme changes too */
+	if (priv->stream)
+		pama_stream_row_update_icons(PAMA_STREAM_ROW(widget));
+
+	if (GTK_WIDGET_CLASS(pama_stream_row_parent_class)->style_set)
+		GTK_WIDGET_CLASS(pama_stream_row_parent_class)->style_set(widget, previous_style);
+}
+
+// The columns only depend on the font, so every row shares a single set that
+// is recomputed when the font changes.
+static const PamaStreamRowColumns *pama_stream_row_get_columns(GtkWidget *widget)
+{
+	static PamaStreamRowColumns columns;
+	static PangoFontDescription *font = NULL;
+	PangoContext *context;
+	PangoFontMetrics *metrics;
+	gint char_width, digit_width, line_height;
+
+	if (font && pango_font_description_equal(font, widget->style->font_desc))
+		return &columns;
+
+	if (font)
+		pango_font_description_free(font);
+	font = pango_font_description_copy(widget->style->font_desc);
+
+	context = gtk_widget_get_pango_context(widget);
+	metrics = pango_context_get_metrics(context, font, pango_context_get_language(context));
+	char_width  = PANGO_PIXELS(pango_font_metrics_get_approximate_char_width(metrics));
+	digit_width = PANGO_PIXELS(pango_font_metrics_get_approximate_digit_width(metrics));
+	line_height = PANGO_PIXELS(pango_font_metrics_get_ascent(metrics) + pango_font_metrics_get_descent(metrics));
+	pango_font_metrics_unref(metrics);
+
+	/* Same as the width-chars of the labels this replaces */
+	columns.name_width  = WIDGET_NAME_WIDTH_IN_CHARS  * MAX(char_width, digit_width);
+	columns.value_width = WIDGET_VALUE_WIDTH_IN_CHARS * MAX(char_width, digit_width);
+	columns.button_size = WIDGET_BUTTON_ICON_SIZE + 2 * (ROW_BUTTON_PADDING + widget->style->xthickness);
+
+	columns.name_x   = WIDGET_ICON_SIZE + ROW_SPACING;
+	columns.slider_x = columns.name_x   + columns.name_width + ROW_SPACING;
+	columns.value_x  = columns.slider_x + WIDGET_VOLUME_SLIDER_WIDTH + ROW_SPACING;
+	columns.mute_x   = columns.value_x  + columns.value_width + ROW_SPACING;
+	columns.device_x = columns.mute_x   + columns.button_size + ROW_SPACING;
+	columns.width    = columns.device_x + columns.button_size;
+	columns.height   = MAX(WIDGET_ICON_SIZE, MAX(2 * line_height, columns.button_size));
+
+	return &columns;
+}
+
+static PamaStreamRowPart pama_stream_row_part_at(PamaStreamRow *row, gint x, GdkRectangle *area)
+{
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(row);
+	const PamaStreamRowColumns *columns = pama_stream_row_get_columns(GTK_WIDGET(row));
+	GdkRectangle rect;
+	PamaStreamRowPart part = ROW_PART_NONE;
+	gint device_x = priv->has_volume ? columns->device_x : columns->slider_x;
+
+	rect.y = 0;
+	rect.height = columns->height;
+
+	if (x >= columns->name_x && x < columns->name_x + columns->name_width)
+	{
+		part = ROW_PART_NAME;
+		rect.x = columns->name_x;
+		rect.width = columns->name_width;
+	}
+	else if (priv->has_volume && x >= columns->slider_x && x < columns->slider_x + WIDGET_VOLUME_SLIDER_WIDTH)
+	{
+		part = ROW_PART_SLIDER;
+		rect.x = columns->slider_x;
+		rect.width = WIDGET_VOLUME_SLIDER_WIDTH;
+	}
+	else if (priv->has_volume && x >= columns->mute_x && x < columns->mute_x + columns->button_size)
+	{
+		part = ROW_PART_MUTE;
+		rect.x = columns->mute_x;
+		rect.width = columns->button_size;
+	}
+	else if (x >= device_x && x < device_x + columns->button_size)
+	{
+		part = ROW_PART_DEVICE;
+		rect.x = device_x;
+		rect.width = columns->button_size;
+	}
+
+	if (area && part != ROW_PART_NONE)
+		*area = rect;
+	return part;
+}
+
+
+static void pama_stream_row_draw_button(PamaStreamRow *row, cairo_t *cr, gint x, gint y, GdkPixbuf *pixbuf, gboolean active, gboolean hover, gboolean sensitive)
+{
+	GtkWidget *widget = GTK_WIDGET(row);
+	const PamaStreamRowColumns *columns = pama_stream_row_get_columns(widget);
+	GtkStateType state = active ? GTK_STATE_ACTIVE : hover ? GTK_STATE_PRELIGHT : GTK_STATE_NORMAL;
+
+	if (!sensitive)
+		state = GTK_STATE_INSENSITIVE;
+
+	cairo_rectangle(cr, x + 0.5, y + 0.5, columns->button_size - 1, columns->button_size - 1);
+	gdk_cairo_set_source_color(cr, &widget->style->bg[state]);
+	cairo_fill_preserve(cr);
+	gdk_cairo_set_source_color(cr, &widget->style->dark[state]);
+	cairo_set_line_width(cr, 1.0);
+	cairo_stroke(cr);
+
+	if (pixbuf)
+	{
+		gdk_cairo_set_source_pixbuf(cr, pixbuf,
+		                            x + (columns->button_size - gdk_pixbuf_get_width(pixbuf))  / 2,
+		                            y + (columns->button_size - gdk_pixbuf_get_height(pixbuf)) / 2);
+		cairo_paint_with_alpha(cr, sensitive ? 1.0 : 0.5);
+	}
+}
+static gboolean pama_stream_row_expose(GtkWidget *widget, GdkEventExpose *event)
+{
+	PamaStreamRow *row = PAMA_STREAM_ROW(widget);
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(row);
+	const PamaStreamRowColumns *columns = pama_stream_row_get_columns(widget);
+	GtkStateType state = priv->mute ? GTK_STATE_INSENSITIVE : GTK_STATE_NORMAL;
+	gint height = widget->allocation.height;
+	gint button_y = (height - columns->button_size) / 2;
+	gint width, text_height;
+	gdouble fraction;
+	cairo_t *cr;
+
+	if (!priv->name)
+		return FALSE;
+
+	cr = gdk_cairo_create(widget->window);
+	gdk_cairo_region(cr, event->region);
+	cairo_clip(cr);
+
+	if (priv->icon)
+	{
+		gdk_cairo_set_source_pixbuf(cr, priv->icon,
+		                            (WIDGET_ICON_SIZE - gdk_pixbuf_get_width(priv->icon)) / 2,
+		                            (height - gdk_pixbuf_get_height(priv->icon)) / 2);
+		cairo_paint(cr);
+	}
+
+	pango_layout_get_pixel_size(priv->name, NULL, &text_height);
+	gdk_cairo_set_source_color(cr, &widget->style->fg[GTK_STATE_NORMAL]);
+	cairo_move_to(cr, columns->name_x, (height - text_height) / 2);
+	pango_cairo_show_layout(cr, priv->name);
+
+	if (priv->has_volume)
+	{
+		fraction = priv->position / WIDGET_VOLUME_SLIDER_DB_RANGE;
+		fraction = CLAMP(fraction, 0.0, 1.0);
+		width = WIDGET_VOLUME_SLIDER_WIDTH - ROW_KNOB_WIDTH;
+
+		/* trough, filled up to the knob */
+		cairo_rectangle(cr, columns->slider_x + ROW_KNOB_WIDTH / 2, (height - ROW_TROUGH_HEIGHT) / 2, width, ROW_TROUGH_HEIGHT);
+		gdk_cairo_set_source_color(cr, &widget->style->bg[GTK_STATE_ACTIVE]);
+		cairo_fill(cr);
+		cairo_rectangle(cr, columns->slider_x + ROW_KNOB_WIDTH / 2, (height - ROW_TROUGH_HEIGHT) / 2, fraction * width, ROW_TROUGH_HEIGHT);
+		gdk_cairo_set_source_color(cr, &widget->style->bg[priv->mute ? GTK_STATE_INSENSITIVE : GTK_STATE_SELECTED]);
+		cairo_fill(cr);
+
+		/* knob */
+		cairo_rectangle(cr, columns->slider_x + fraction * width + 0.5, button_y + 0.5, ROW_KNOB_WIDTH - 1, columns->button_size - 1);
+		gdk_cairo_set_source_color(cr, &widget->style->bg[priv->pressed == ROW_PART_SLIDER ? GTK_STATE_ACTIVE :
+		                                                  priv->hover   == ROW_PART_SLIDER ? GTK_STATE_PRELIGHT : state]);
+		cairo_fill_preserve(cr);
+		gdk_cairo_set_source_color(cr, &widget->style->dark[state]);
+		cairo_set_line_width(cr, 1.0);
+		cairo_stroke(cr);
+
+		pango_layout_get_pixel_size(priv->value, &width, &text_height);
+		gdk_cairo_set_source_color(cr, &widget->style->fg[state]);
+		cairo_move_to(cr, columns->value_x + columns->value_width - width, (height - text_height) / 2);
+		pango_cairo_show_layout(cr, priv->value);
+
+		pama_stream_row_draw_button(row, cr, columns->mute_x, button_y, priv->mute_icon,
+		                            priv->mute || priv->pressed == ROW_PART_MUTE, priv->hover == ROW_PART_MUTE, TRUE);
+	}
+
+	pama_stream_row_draw_button(row, cr, priv->has_volume ? columns->device_x : columns->slider_x, button_y, priv->device_icon,
+	                            priv->pressed == ROW_PART_DEVICE, priv->hover == ROW_PART_DEVICE, priv->movable);
+
+	cairo_destroy(cr);
+	return FALSE;
+}
+
+
+static void pama_stream_row_set_volume(PamaStreamRow *row, const guint32 volume)
+{
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(row);
+	PamaPulseSink *sink;
+
+	pama_pulse_sink_input_set_volume(PAMA_PULSE_SINK_INPUT(priv->stream), volume);
+
+	/* Played as loud as the stream now is */
+	g_object_get(priv->stream, "sink", &sink, NULL);
+	if (sink)
+	{
+		pama_feedback_sound_play(priv->context, sink, volume);
+		g_object_unref(sink);
+	}
+}
+static void pama_stream_row_set_volume_at(PamaStreamRow *row, gint x)
+{
+	const PamaStreamRowColumns *columns = pama_stream_row_get_columns(GTK_WIDGET(row));
+	gdouble fraction = (gdouble)(x - columns->slider_x - ROW_KNOB_WIDTH / 2) / (WIDGET_VOLUME_SLIDER_WIDTH - ROW_KNOB_WIDTH);
+
+	fraction = CLAMP(fraction, 0.0, 1.0);
+	pama_stream_row_set_volume(row, pama_volume_map_from_slider(fraction * WIDGET_VOLUME_SLIDER_DB_RANGE));
+}
+static gboolean pama_stream_row_button_press(GtkWidget *widget, GdkEventButton *event)
+{
+	PamaStreamRow *row = PAMA_STREAM_ROW(widget);
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(row);
+
+	if (event->type != GDK_BUTTON_PRESS || event->button != 1)
+		return FALSE;
+
+	priv->pressed = pama_stream_row_part_at(row, event->x, NULL);
+
+	switch (priv->pressed)
+	{
+		case ROW_PART_SLIDER:
+			pama_stream_row_set_volume_at(row, event->x);
+			break;
+
+		case ROW_PART_DEVICE:
+			if (!priv->movable)
+				priv->pressed = ROW_PART_NONE;
+			break;
+
+		case ROW_PART_MUTE:
+			break;
+
+		default:
+			priv->pressed = ROW_PART_NONE;
+			return FALSE;
+	}
+
+	gtk_widget_queue_draw(widget);
+	return TRUE;
+}
+static gboolean pama_stream_row_button_release(GtkWidget *widget, GdkEventButton *event)
+{
+	PamaStreamRow *row = PAMA_STREAM_ROW(widget);
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(row);
+	PamaStreamRowPart pressed = priv->pressed;
+
+	if (event->button != 1 || pressed == ROW_PART_NONE)
+		return FALSE;
+
+	priv->pressed = ROW_PART_NONE;
+	gtk_widget_queue_draw(widget);
+
+	/* Like buttons, only act when released over the part that was pressed */
+	if (pressed != pama_stream_row_part_at(row, event->x, NULL))
+		return TRUE;
+
+	if (pressed == ROW_PART_MUTE)
+		pama_pulse_sink_input_set_mute(PAMA_PULSE_SINK_INPUT(priv->stream), !priv->mute);
+	else if (pressed == ROW_PART_DEVICE)
+		pama_device_menu_popup(PAMA_DEVICE_MENU(priv->device_menu), priv->stream);
+
+	return TRUE;
+}
+static gboolean pama_stream_row_motion_notify(GtkWidget *widget, GdkEventMotion *event)
+{
+	PamaStreamRow *row = PAMA_STREAM_ROW(widget);
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(row);
+	PamaStreamRowPart hover;
+
+	if (priv->pressed == ROW_PART_SLIDER)
+	{
+		pama_stream_row_set_volume_at(row, event->x);
+		return TRUE;
+	}
+
+	hover = pama_stream_row_part_at(row, event->x, NULL);
+	if (hover != priv->hover)
+	{
+		priv->hover = hover;
+		gtk_widget_queue_draw(widget);
+	}
+
+	return FALSE;
+}
+static gboolean pama_stream_row_leave_notify(GtkWidget *widget, GdkEventCrossing *event)
+{
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(widget);
+
+	if (priv->hover != ROW_PART_NONE)
+	{
+		priv->hover = ROW_PART_NONE;
+		gtk_widget_queue_draw(widget);
+	}
+
+	return FALSE;
+}
+static gboolean pama_stream_row_scroll(GtkWidget *widget, GdkEventScroll *event)
+{
+	PamaStreamRow *row = PAMA_STREAM_ROW(widget);
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(row);
+	gdouble position;
+
+	/* Anywhere but the slider, scrolling scrolls the list */
+	if (pama_stream_row_part_at(row, event->x, NULL) != ROW_PART_SLIDER)
+		return FALSE;
+
+	/* Same steps as the scales, 5dB with the default curve */
+	if (event->direction == GDK_SCROLL_UP || event->direction == GDK_SCROLL_RIGHT)
+		position = priv->position + 5.0;
+	else
+		position = priv->position - 5.0;
+
+	position = CLAMP(position, 0.0, WIDGET_VOLUME_SLIDER_DB_RANGE);
+	pama_stream_row_set_volume(row, pama_volume_map_from_slider(position));
+
+	return TRUE;
+}
+static gboolean pama_stream_row_query_tooltip(GtkWidget *widget, gint x, gint y, gboolean keyboard_mode, GtkTooltip *tooltip)
+{
+	PamaStreamRow *row = PAMA_STREAM_ROW(widget);
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(row);
+	GdkRectangle area;
+
+	switch (pama_stream_row_part_at(row, x, &area))
+	{
+		case ROW_PART_NAME:
+			gtk_tooltip_set_markup(tooltip, g_object_get_data(G_OBJECT(priv->name), "markup"));
+			break;
+
+		case ROW_PART_MUTE:
+			gtk_tooltip_set_text(tooltip, _("Mute this application's audio output"));
+			break;
+
+		case ROW_PART_DEVICE:
+			if (priv->has_volume)
+				gtk_tooltip_set_text(tooltip, _("Select which output device to use for this application"));
+			else
+				gtk_tooltip_set_text(tooltip, _("Select which input device to use for this application"));
+			break;
+
+		default:
+			return FALSE;
+	}
+
+	gtk_tooltip_set_tip_area(tooltip, &area);
+	return TRUE;
+}
+
+
+static void pama_stream_row_stream_notify(GObject *gobject, GParamSpec *pspec, gpointer data)
+{
+	PamaStreamRow *row = data;
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(row);
+
+	if (!GTK_WIDGET_MAPPED(row))
+	{
+		priv->dirty = TRUE;
+		return;
+	}
+
+	pama_stream_row_update_values(row);
+}
+
+static void pama_stream_row_update_icons(PamaStreamRow *row)
+{
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(row);
+	GObject *device;
+	GIcon *icon;
+
+	if (priv->icon)
+		g_object_unref(priv->icon);
+	if (priv->device_icon)
+		g_object_unref(priv->device_icon);
+	if (priv->mute_icon)
+		g_object_unref(priv->mute_icon);
+
+	if (priv->has_volume)
+	{
+		icon = pama_pulse_sink_input_build_gicon(PAMA_PULSE_SINK_INPUT(priv->stream));
+		g_object_get(priv->stream, "sink", &device, NULL);
+	}
+	else
+	{
+		icon = pama_pulse_source_output_build_gicon(PAMA_PULSE_SOURCE_OUTPUT(priv->stream));
+		g_object_get(priv->stream, "source", &device, NULL);
+	}
+	priv->icon = pama_icon_cache_get_pixbuf(icon, WIDGET_ICON_SIZE);
+	g_object_unref(icon);
+
+	priv->device_icon = NULL;
+	if (device)
+	{
+		if (priv->has_volume)
+			icon = pama_pulse_sink_build_gicon(PAMA_PULSE_SINK(device));
+		else
+			icon = pama_pulse_source_build_gicon(PAMA_PULSE_SOURCE(device));
+		priv->device_icon = pama_icon_cache_get_pixbuf(icon, WIDGET_BUTTON_ICON_SIZE);
+		g_object_unref(icon);
+		g_object_unref(device);
+	}
+
+	icon = pama_icon_cache_get_gicon("audio-volume-muted", FALSE);
+	priv->mute_icon = pama_icon_cache_get_pixbuf(icon, WIDGET_BUTTON_ICON_SIZE);
+	g_object_unref(icon);
+}
+static void pama_stream_row_update_values(PamaStreamRow *row)
+{
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(row);
+	const PamaStreamRowColumns *columns = pama_stream_row_get_columns(GTK_WIDGET(row));
+	gchar           *markup, *temp;
+	gchar           *stream_name, *client_name;
+	gchar           *hostname, *application_id;
+	gboolean         is_local;
+	guint            volume;
+	gdouble          volume_dB;
+	PamaPulseClient *client;
+
+	priv->dirty = FALSE;
+
+	g_object_get(priv->stream,
+	             "client", &client,
+	             "name",   &stream_name,
+	             NULL);
+
+	g_object_get(client,
+	             "name",           &client_name,
+	             "hostname",       &hostname,
+	             "is-local",       &is_local,
+	             "application-id", &application_id,
+	             NULL);
+
+	if (is_local)
+		markup = g_markup_printf_escaped("<b>%s</b>\n%s", client_name, stream_name);
+	else
+		markup = g_markup_printf_escaped("<b>%s</b> (on %s)\n%s", client_name, hostname, stream_name);
+
+	if (!priv->name)
+	{
+		priv->name = gtk_widget_create_pango_layout(GTK_WIDGET(row), NULL);
+		pango_layout_set_width(priv->name, columns->name_width * PANGO_SCALE);
+		pango_layout_set_ellipsize(priv->name, PANGO_ELLIPSIZE_MIDDLE);
+	}
+	pango_layout_set_markup(priv->name, markup, -1);
+	/* Kept for the tooltip, which shows the name without ellipsizing it */
+	g_object_set_data_full(G_OBJECT(priv->name), "markup", markup, g_free);
+
+	if (priv->has_volume)
+	{
+		g_object_get(priv->stream,
+		             "volume", &volume,
+		             "mute",   &priv->mute,
+		             NULL);
+
+		volume_dB      = pama_volume_map_to_dB(volume);
+		priv->position = pama_volume_map_to_slider(volume);
+		if (isinf(volume_dB))
+			temp = g_strdup("-∞dB");
+		else
+			temp = g_strdup_printf("%+.1fdB", volume_dB);
+
+		if (!priv->value)
+			priv->value = gtk_widget_create_pango_layout(GTK_WIDGET(row), NULL);
+		pango_layout_set_text(priv->value, temp, -1);
+		g_free(temp);
+	}
+
+	// Ideally, this would be done by checking the stream's flags for
+	// PA_STREAM_DONT_MOVE, but we don't have that information
+	priv->movable = 0 != strcmp(application_id, "org.PulseAudio.PulseAudio");
+
+	pama_stream_row_update_icons(row);
+
+	g_free(stream_name);
+	g_free(client_name);
+	g_free(hostname);
+	g_free(application_id);
+	g_object_unref(client);
+
+	gtk_widget_queue_draw(GTK_WIDGET(row));
+}
+
+
+GtkWidget *pama_stream_row_new(PamaPulseContext *context, GObject *stream, GtkWidget *device_menu)
+{
+	GtkWidget *row = g_object_new(PAMA_TYPE_STREAM_ROW,
+	                              "context", context,
+	                              "stream", stream,
+	                              "device-menu", device_menu,
+	                              NULL);
+
+	pama_stream_row_update_values(PAMA_STREAM_ROW(row));
+	return row;
+}
+
+GObject *pama_stream_row_get_stream(PamaStreamRow *row)
+{
+	PamaStreamRowPrivate *priv = PAMA_STREAM_ROW_GET_PRIVATE(row);
+
+	return priv->stream;
+}
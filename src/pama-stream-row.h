@@ -0,0 +1,60 @@
+/*
+ * pama-stream-row.h: A single cairo-drawn widget for one row of the stream list
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_STREAM_ROW_H
+#define PAMA_STREAM_ROW_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+#include "pama-pulse-context.h"
+
+G_BEGIN_DECLS
+
+#define PAMA_TYPE_STREAM_ROW                  (pama_stream_row_get_type ())
+#define PAMA_STREAM_ROW(obj)                  (G_TYPE_CHECK_INSTANCE_CAST ((obj), PAMA_TYPE_STREAM_ROW, PamaStreamRow))
+#define PAMA_IS_STREAM_ROW(obj)               (G_TYPE_CHECK_INSTANCE_TYPE ((obj), PAMA_TYPE_STREAM_ROW))
+#define PAMA_STREAM_ROW_CLASS(klass)          (G_TYPE_CHECK_CLASS_CAST ((klass), PAMA_TYPE_STREAM_ROW, PamaStreamRowClass))
+#define PAMA_IS_STREAM_ROW_CLASS(klass)       (G_TYPE_CHECK_CLASS_TYPE ((klass), PAMA_TYPE_STREAM_ROW))
+#define PAMA_STREAM_ROW_GET_CLASS(obj)        (G_TYPE_INSTANCE_GET_CLASS ((obj), PAMA_TYPE_STREAM_ROW, PamaStreamRowClass))
+
+typedef struct _PamaStreamRow        PamaStreamRow;
+typedef struct _PamaStreamRowClass   PamaStreamRowClass;
+typedef struct _PamaStreamRowPrivate PamaStreamRowPrivate;
+
+struct _PamaStreamRow
+{
+	GtkWidget parent_instance;
+};
+
+struct _PamaStreamRowClass
+{
+	GtkWidgetClass parent_class;
+};
+
+GType pama_stream_row_get_type();
+
+/* methods */
+GtkWidget *pama_stream_row_new(PamaPulseContext *context, GObject *stream, GtkWidget *device_menu);
+GObject   *pama_stream_row_get_stream(PamaStreamRow *row);
+
+G_END_DECLS
+
+#endif /* PAMA_STREAM_ROW_H */
@@ -0,0 +1,140 @@
+/*
+ * pama-volume-map.c: Precomputed conversions between volumes, decibels and slider positions
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+#include <glib.h>
+
+#include "pama-volume-map.h"
+#include "widget-settings.h"
+
+/* One entry per tenth of a decibel, or of a slider step, across the slider's range */
+#define VOLUME_MAP_STEPS   10
+#define VOLUME_MAP_ENTRIES (WIDGET_VOLUME_SLIDER_DB_RANGE * VOLUME_MAP_STEPS + 1)
+
+static void        pama_volume_map_init(void);
+static pa_volume_t pama_volume_map_interpolate(const pa_volume_t *table, gdouble entry);
+static gdouble     pama_volume_map_search(const pa_volume_t *table, pa_volume_t volume);
+
+static PamaVolumeCurve curve = PAMA_VOLUME_CURVE_DECIBEL;
+static gboolean        initialized = FALSE;
+
+/* Both are strictly increasing, so either can be searched for the inverse */
+static pa_volume_t decibel_table[VOLUME_MAP_ENTRIES];
+static pa_volume_t slider_table[VOLUME_MAP_ENTRIES];
+
+static void pama_volume_map_init(void)
+{
+	guint i;
+
+	if (initialized)
+		return;
+
+	for (i = 0; i < VOLUME_MAP_ENTRIES; i++)
+		decibel_table[i] = pa_sw_volume_from_dB((gdouble)i / VOLUME_MAP_STEPS - WIDGET_VOLUME_SLIDER_DB_RANGE);
+
+	for (i = 0; i < VOLUME_MAP_ENTRIES; i++)
+	{
+		if (PAMA_VOLUME_CURVE_CUBIC == curve)
+			slider_table[i] = (guint64)PA_VOLUME_NORM * i / (VOLUME_MAP_ENTRIES - 1);
+		else
+			slider_table[i] = decibel_table[i];
+	}
+
+	initialized = TRUE;
+}
+static pa_volume_t pama_volume_map_interpolate(const pa_volume_t *table, gdouble entry)
+{
+	guint i;
+
+	entry = CLAMP(entry, 0.0, VOLUME_MAP_ENTRIES - 1);
+	i = (guint)entry;
+	if (i >= VOLUME_MAP_ENTRIES - 1)
+		return table[VOLUME_MAP_ENTRIES - 1];
+
+	return table[i] + (pa_volume_t)((entry - i) * (table[i + 1] - table[i]) + 0.5);
+}
+// Returns the fractional entry at which volume would sit, which must lie
+// between the first and last entries of the table.
+static gdouble pama_volume_map_search(const pa_volume_t *table, pa_volume_t volume)
+{
+	guint low = 0, high = VOLUME_MAP_ENTRIES - 1, middle;
+
+	while (high - low > 1)
+	{
+		middle = (low + high) / 2;
+		if (table[middle] <= volume)
+			low = middle;
+		else
+			high = middle;
+	}
+
+	return low + (gdouble)(volume - table[low]) / (table[high] - table[low]);
+}
+
+
+void pama_volume_map_set_curve(PamaVolumeCurve new_curve)
+{
+	curve = new_curve;
+	initialized = FALSE;
+	pama_volume_map_init();
+}
+
+gdouble pama_volume_map_to_dB(pa_volume_t volume)
+{
+	pama_volume_map_init();
+
+	if (PA_VOLUME_MUTED == volume)
+		return PA_DECIBEL_MININFTY;
+
+	/* Amplified or nearly silent volumes are rare enough to be worked out */
+	if (volume < decibel_table[0] || volume > decibel_table[VOLUME_MAP_ENTRIES - 1])
+		return pa_sw_volume_to_dB(volume);
+
+	return pama_volume_map_search(decibel_table, volume) / VOLUME_MAP_STEPS - WIDGET_VOLUME_SLIDER_DB_RANGE;
+}
+pa_volume_t pama_volume_map_from_dB(gdouble volume_dB)
+{
+	pama_volume_map_init();
+
+	if (volume_dB < -WIDGET_VOLUME_SLIDER_DB_RANGE || volume_dB > 0.0)
+		return pa_sw_volume_from_dB(volume_dB);
+
+	return pama_volume_map_interpolate(decibel_table, (volume_dB + WIDGET_VOLUME_SLIDER_DB_RANGE) * VOLUME_MAP_STEPS);
+}
+
+gdouble pama_volume_map_to_slider(pa_volume_t volume)
+{
+	pama_volume_map_init();
+
+	if (volume <= slider_table[0])
+		return 0.0;
+	if (volume >= slider_table[VOLUME_MAP_ENTRIES - 1])
+		return WIDGET_VOLUME_SLIDER_DB_RANGE;
+
+	return pama_volume_map_search(slider_table, volume) / VOLUME_MAP_STEPS;
+}
+pa_volume_t pama_volume_map_from_slider(gdouble position)
+{
+	pama_volume_map_init();
+
+	return pama_volume_map_interpolate(slider_table, position * VOLUME_MAP_STEPS);
+}
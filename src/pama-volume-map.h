@@ -0,0 +1,45 @@
+/*
+ * pama-volume-map.h: Precomputed conversions between volumes, decibels and slider positions
+ * Part of PulseAudio Mixer Applet
+ * Copyright © PulseAudio Mixer Applet contributors, see AUTHORS
+ * 
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ 
+#ifndef PAMA_VOLUME_MAP_H
+#define PAMA_VOLUME_MAP_H
+
+#include <glib.h>
+#include <pulse/volume.h>
+
+G_BEGIN_DECLS
+
+/* How slider positions, from 0 to WIDGET_VOLUME_SLIDER_DB_RANGE, map to volumes */
+typedef enum
+{
+	PAMA_VOLUME_CURVE_DECIBEL, /* evenly spaced in decibels */
+	PAMA_VOLUME_CURVE_CUBIC    /* evenly spaced in volume, which is cubic in amplitude, as pavucontrol's sliders are */
+} PamaVolumeCurve;
+
+void        pama_volume_map_set_curve(PamaVolumeCurve curve);
+
+gdouble     pama_volume_map_to_dB(pa_volume_t volume);
+pa_volume_t pama_volume_map_from_dB(gdouble volume_dB);
+gdouble     pama_volume_map_to_slider(pa_volume_t volume);
+pa_volume_t pama_volume_map_from_slider(gdouble position);
+
+G_END_DECLS
+
+#endif /* PAMA_VOLUME_MAP_H */
@@ -20,6 +20,59 @@
  
 #define WIDGET_NAME_WIDTH_IN_CHARS  40
 #define WIDGET_VOLUME_SLIDER_WIDTH  200
+#define WIDGET_BALANCE_SLIDER_WIDTH 60
+#define WIDGET_LEVEL_METER_HEIGHT   4
+
+/* Level meters are painted every this many milliseconds, about 30 times a
+ * second, and fall back by this fraction of their height each second */
+#define WIDGET_METER_FRAME_INTERVAL 33
+#define WIDGET_METER_DECAY          1.5
 #define WIDGET_VALUE_WIDTH_IN_CHARS 7
 
+/* Loudness is shown in whole LUFS, and anything quieter than the floor is
+ * shown as the floor */
+#define WIDGET_LOUDNESS_WIDTH_IN_CHARS 8
+#define WIDGET_LOUDNESS_FLOOR          -70.0
+
+/* Pixel sizes of device and stream icons, and of the icons on their buttons */
+#define WIDGET_ICON_SIZE        32
+#define WIDGET_BUTTON_ICON_SIZE 16
+
 #define WIDGET_VOLUME_SLIDER_DB_RANGE 90
+
+/* Popups switch to a scrolled list that only creates widgets for the visible
+ * rows once there are more streams than this, and back at half of it */
+#define WIDGET_STREAM_LIST_THRESHOLD   24
+#define WIDGET_STREAM_LIST_MAX_ROWS    10
+#define WIDGET_STREAM_LIST_ROW_SPACING 6
+
+/* Defaults for how long a new playback stream must exist before it gets a
+ * row, in milliseconds, and for the comma-separated roles that never do */
+#define WIDGET_NEW_STREAM_DELAY 500
+#define WIDGET_HIDDEN_ROLES     "event"
+
+/* At most this many application meters are open at once; which rows get
+ * them is worked out this many milliseconds after the last change */
+#define WIDGET_STREAM_METER_MAX             8
+#define WIDGET_STREAM_METER_REBALANCE_DELAY 250
+
+/* Spectrum windows plot from this frequency, in Hz, up to half the rate they
+ * record at, and down to this level in dB below a full scale sine */
+#define WIDGET_SPECTRUM_WIDTH         360
+#define WIDGET_SPECTRUM_HEIGHT        140
+#define WIDGET_SPECTRUM_MIN_FREQUENCY 20.0
+#define WIDGET_SPECTRUM_FLOOR         -100.0
+
+/* Clipping is reported for this many seconds after it happened, on rows and
+ * in the panel tooltip, whose names are shown in this colour meanwhile */
+#define WIDGET_CLIP_HISTORY_SECONDS 60
+#define WIDGET_CLIP_COLOR           "#cc0000"
+
+/* Latency columns, shown when latency is polled, which is never more often
+ * than every this many milliseconds */
+#define WIDGET_LATENCY_WIDTH_IN_CHARS 8
+#define WIDGET_LATENCY_MIN_INTERVAL   100
+
+/* Volume changes are confirmed with a click at most every this many
+ * milliseconds */
+#define WIDGET_FEEDBACK_MIN_INTERVAL 250